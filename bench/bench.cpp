@@ -0,0 +1,402 @@
+#include <benchmark/benchmark.h>
+
+#include <cstring>
+#include <stdexcept>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "aes.h"
+#include "aes_gcm.h"
+#include "aes_xts.h"
+#include "kalyna.h"
+#include "kalyna_cipher.h"
+#include "kalyna_gcm.h"
+
+#if defined(__x86_64__) || defined(__i386__)
+#include <x86intrin.h>
+#define HAVE_RDTSC 1
+#endif
+
+// Throughput of every cipher, key size, mode and direction from one AES block to 64 MB,
+// the Kalyna batch widths, AES thread scaling and the key schedule timed on their own. Run the bench_json target, or pass
+// --benchmark_out=file --benchmark_out_format=json, for output that can be diffed.
+
+// message sizes, a factor of 16 apart
+static const int64_t kMinBytes = 16;
+static const int64_t kMaxBytes = 64 << 20;
+// message size of the backend and batch width comparisons
+static const int64_t kBackendBytes = 64 << 10;
+// message size of the thread scaling, large enough to be split between every thread
+static const int64_t kScalingBytes = 16 << 20;
+
+static const uint8_t kKey[64] =
+    {0x00, 0x01, 0x02, 0x03, 0x04, 0x05, 0x06, 0x07, 0x08, 0x09, 0x0a, 0x0b, 0x0c, 0x0d, 0x0e, 0x0f,
+     0x10, 0x11, 0x12, 0x13, 0x14, 0x15, 0x16, 0x17, 0x18, 0x19, 0x1a, 0x1b, 0x1c, 0x1d, 0x1e, 0x1f,
+     0x20, 0x21, 0x22, 0x23, 0x24, 0x25, 0x26, 0x27, 0x28, 0x29, 0x2a, 0x2b, 0x2c, 0x2d, 0x2e, 0x2f,
+     0x30, 0x31, 0x32, 0x33, 0x34, 0x35, 0x36, 0x37, 0x38, 0x39, 0x3a, 0x3b, 0x3c, 0x3d, 0x3e, 0x3f};
+static const uint8_t kIv[64] = {0xff, 0xfe, 0xfd, 0xfc, 0xfb, 0xfa, 0xf9, 0xf8, 0xf7, 0xf6, 0xf5, 0xf4};
+
+enum class Mode { kECB, kCBC, kCFB, kOFB, kCTR, kGCM, kXTS };
+
+static const std::pair<Mode, const char *> kModes[] =
+    {{Mode::kECB, "ECB"}, {Mode::kCBC, "CBC"}, {Mode::kCFB, "CFB"}, {Mode::kOFB, "OFB"}, {Mode::kCTR, "CTR"},
+     {Mode::kGCM, "GCM"}, {Mode::kXTS, "XTS"}};
+
+static uint64_t Cycles() {
+#if HAVE_RDTSC
+  return __rdtsc();
+#else
+  return 0;
+#endif
+}
+
+// input and output of every benchmark, allocated once for the largest message
+static const uint8_t *Input() {
+  static const std::vector<uint8_t> input = [] {
+    std::vector<uint8_t> data(kMaxBytes + 64);
+    for (size_t i = 0; i < data.size(); i++) {
+      data[i] = (uint8_t) (i * 131 + 7);
+    }
+    return data;
+  }();
+  return input.data();
+}
+
+static uint8_t *Output() {
+  static std::vector<uint8_t> output(kMaxBytes + 64);
+  return output.data();
+}
+
+// Runs body(len) once per iteration and reports MB/s and cycles/byte of the time stamp
+// counter (0 where there is none). ECB, CBC and XTS round len up to whole blocks.
+template<typename Body>
+static void Measure(benchmark::State &state, size_t blockBytes, bool wholeBlocks, const Body &body) {
+  size_t len = (size_t) state.range(0);
+  if (wholeBlocks) {
+    len = (len + blockBytes - 1) / blockBytes * blockBytes;
+  }
+  const uint64_t before = Cycles();
+  for (auto _ : state) {
+    body(len);
+    benchmark::ClobberMemory();
+  }
+  const double bytes = (double) len * (double) state.iterations();
+  state.SetBytesProcessed((int64_t) bytes);
+  state.counters["MB"] = benchmark::Counter(bytes / 1e6, benchmark::Counter::kIsRate);
+  state.counters["cycles/byte"] = (double) (Cycles() - before) / bytes;
+  state.counters["len"] = (double) len;
+}
+
+static void AesMode(benchmark::State &state, int keyLen, AESBackend backend, Mode mode, bool encrypt,
+                    size_t threads) {
+  AES aes(keyLen, backend);
+  aes.SetParallelism(threads);
+  const AesKey key = aes.ExpandKey(kKey);
+  const AesKey tweakKey = aes.ExpandKey(kKey + 32);
+  const uint8_t *in = Input();
+  uint8_t *out = Output();
+
+  switch (mode) {
+    case Mode::kECB: {
+      Measure(state, 16, true, [&](size_t len) {
+        encrypt ? aes.EncryptECB(in, out, len, key) : aes.DecryptECB(in, out, len, key);
+      });
+      break;
+    }
+    case Mode::kCBC: {
+      Measure(state, 16, true, [&](size_t len) {
+        encrypt ? aes.EncryptCBC(in, out, len, key, kIv) : aes.DecryptCBC(in, out, len, key, kIv);
+      });
+      break;
+    }
+    case Mode::kCFB: {
+      Measure(state, 16, false, [&](size_t len) {
+        encrypt ? aes.EncryptCFB(in, out, len, 16, key, kIv) : aes.DecryptCFB(in, out, len, 16, key, kIv);
+      });
+      break;
+    }
+    case Mode::kOFB: {
+      Measure(state, 16, false, [&](size_t len) { aes.EncryptOFB(in, out, len, key, kIv); });
+      break;
+    }
+    case Mode::kCTR: {
+      Measure(state, 16, false, [&](size_t len) { aes.EncryptCTR(in, out, len, key, kIv); });
+      break;
+    }
+    case Mode::kGCM: {
+      AesGcm gcm(aes, key, encrypt);
+      uint8_t tag[16];
+      Measure(state, 16, false, [&](size_t len) {
+        gcm.Init(kIv, 12);
+        gcm.Update(in, out, len);
+        gcm.Final(tag);
+      });
+      break;
+    }
+    case Mode::kXTS: {
+      const AesXts xts(aes, key, tweakKey);
+      Measure(state, 16, true, [&](size_t len) {
+        encrypt ? xts.Encrypt(in, out, len, kIv) : xts.Decrypt(in, out, len, kIv);
+      });
+      break;
+    }
+  }
+}
+
+static void KalynaMode(benchmark::State &state, size_t blockSize, size_t keySize, KalynaBackend backend, Mode mode,
+                       bool encrypt) {
+  const Kalyna kalyna(blockSize, keySize, backend);
+  const KalynaKey key = kalyna.ExpandKey(kKey);
+  const size_t block = kalyna.BlockBytes();
+  const uint8_t *in = Input();
+  uint8_t *out = Output();
+
+  switch (mode) {
+    case Mode::kECB: {
+      Measure(state, block, true, [&](size_t len) {
+        encrypt ? kalyna.EncryptECB(in, out, len, key) : kalyna.DecryptECB(in, out, len, key);
+      });
+      break;
+    }
+    case Mode::kCBC: {
+      Measure(state, block, true, [&](size_t len) {
+        encrypt ? kalyna.EncryptCBC(in, out, len, key, kIv) : kalyna.DecryptCBC(in, out, len, key, kIv);
+      });
+      break;
+    }
+    case Mode::kCFB: {
+      Measure(state, block, false, [&](size_t len) {
+        encrypt ? kalyna.EncryptCFB(in, out, len, block, key, kIv) : kalyna.DecryptCFB(in, out, len, block, key, kIv);
+      });
+      break;
+    }
+    case Mode::kOFB: {
+      Measure(state, block, false, [&](size_t len) { kalyna.EncryptOFB(in, out, len, key, kIv); });
+      break;
+    }
+    case Mode::kCTR: {
+      Measure(state, block, false, [&](size_t len) { kalyna.EncryptCTR(in, out, len, key, kIv); });
+      break;
+    }
+    case Mode::kGCM: {
+      KalynaGcm gcm(kalyna, key, encrypt);
+      uint8_t tag[Kalyna::kMaxBlockBytes];
+      Measure(state, block, false, [&](size_t len) {
+        gcm.Init(kIv, block);
+        gcm.Update(in, out, len);
+        gcm.Final(tag);
+      });
+      break;
+    }
+    case Mode::kXTS: {
+      break;
+    }
+  }
+}
+
+// Kalyna ECB encryption with a given number of interleaved blocks, range(1)
+template<size_t BlockBits, size_t KeyBits>
+static void KalynaBatchWidth(benchmark::State &state) {
+  KalynaCipher<BlockBits, KeyBits> cipher;
+  uint64_t key[KeyBits / 64];
+  memcpy(key, kKey, sizeof(key));
+  cipher.KeyExpand(key);
+  const size_t width = (size_t) state.range(1);
+  const uint8_t *in = Input();
+  uint8_t *out = Output();
+
+  Measure(state, BlockBits / 8, true, [&](size_t len) {
+    cipher.EncipherBlocks(in, out, len / (BlockBits / 8), width);
+  });
+}
+
+// keys expanded per second and cycles per key
+static void ReportKeys(benchmark::State &state, uint64_t before, size_t keysPerIteration) {
+  const double keys = (double) state.iterations() * (double) keysPerIteration;
+  state.SetItemsProcessed((int64_t) keys);
+  state.counters["cycles/key"] = (double) (Cycles() - before) / keys;
+}
+
+static void AesKeySetup(benchmark::State &state, int keyLen) {
+  const AES aes(keyLen);
+  const uint64_t before = Cycles();
+  for (auto _ : state) {
+    AesKey key = aes.ExpandKey(kKey);
+    benchmark::DoNotOptimize(key);
+  }
+  ReportKeys(state, before, 1);
+}
+
+static void KalynaKeySetup(benchmark::State &state, size_t blockSize, size_t keySize, size_t batch) {
+  const Kalyna kalyna(blockSize, keySize);
+  const uint64_t before = Cycles();
+  if (batch == 1) {
+    for (auto _ : state) {
+      KalynaKey key = kalyna.ExpandKey(kKey);
+      benchmark::DoNotOptimize(key);
+    }
+  } else {
+    std::vector<uint64_t> keys(batch * keySize / 64);
+    memcpy(keys.data(), kKey, sizeof(kKey) < keys.size() * 8 ? sizeof(kKey) : keys.size() * 8);
+    std::vector<KalynaKey> expanded(batch, kalyna.ExpandKey(kKey));
+    for (auto _ : state) {
+      kalyna.ExpandKeys(keys.data(), batch, expanded.data());
+      benchmark::ClobberMemory();
+    }
+  }
+  ReportKeys(state, before, batch);
+}
+
+static const std::pair<AESBackend, const char *> kAesBackends[] =
+    {{AESBackend::kReference, "reference"}, {AESBackend::kTTable, "t-table"}, {AESBackend::kAesNi, "aes-ni"}};
+
+static const std::pair<KalynaBackend, const char *> kKalynaBackends[] =
+    {{KalynaBackend::kTable, "table"}, {KalynaBackend::kSsse3, "ssse3"}, {KalynaBackend::kAvx2, "avx2"},
+     {KalynaBackend::kAvx512, "avx512-vbmi"}};
+
+static const size_t kKalynaSizes[5][2] = {{128, 128}, {128, 256}, {256, 256}, {256, 512}, {512, 512}};
+
+static const char *AesBackendName(AESBackend backend) {
+  for (const auto &known : kAesBackends) {
+    if (known.first == backend) {
+      return known.second;
+    }
+  }
+  return "auto";
+}
+
+static const char *KalynaBackendName(KalynaBackend backend) {
+  for (const auto &known : kKalynaBackends) {
+    if (known.first == backend) {
+      return known.second;
+    }
+  }
+  return "auto";
+}
+
+static void RegisterModes() {
+  const AESBackend aesBackend = AES().Backend();
+  for (int keyLen : {128, 192, 256}) {
+    for (const auto &mode : kModes) {
+      for (bool encrypt : {true, false}) {
+        const std::string name = "AES-" + std::to_string(keyLen) + "/" + mode.second + "/" +
+            (encrypt ? "encrypt" : "decrypt") + "/" + AesBackendName(aesBackend);
+        benchmark::RegisterBenchmark(name.c_str(), AesMode, keyLen, aesBackend, mode.first, encrypt, (size_t) 1)
+            ->RangeMultiplier(16)->Range(kMinBytes, kMaxBytes);
+      }
+    }
+  }
+
+  const KalynaBackend kalynaBackend = Kalyna(128, 128).Backend();
+  for (const auto &size : kKalynaSizes) {
+    for (const auto &mode : kModes) {
+      if (mode.first == Mode::kXTS) {
+        continue;
+      }
+      for (bool encrypt : {true, false}) {
+        const std::string name = "Kalyna-" + std::to_string(size[0]) + "-" + std::to_string(size[1]) + "/" +
+            mode.second + "/" + (encrypt ? "encrypt" : "decrypt") + "/" + KalynaBackendName(kalynaBackend);
+        benchmark::RegisterBenchmark(name.c_str(), KalynaMode, size[0], size[1], kalynaBackend, mode.first, encrypt)
+            ->RangeMultiplier(16)->Range(kMinBytes, kMaxBytes);
+      }
+    }
+  }
+}
+
+// ECB and CTR encryption of every backend the CPU supports, at one message size
+static void RegisterBackends() {
+  for (const auto &backend : kAesBackends) {
+    try {
+      AES probe(256, backend.first);
+    } catch (const std::invalid_argument &) {
+      continue;
+    }
+    for (Mode mode : {Mode::kECB, Mode::kCTR}) {
+      const std::string name = std::string("Backends/AES-256/") + (mode == Mode::kECB ? "ECB" : "CTR") + "/" +
+          backend.second;
+      benchmark::RegisterBenchmark(name.c_str(), AesMode, 256, backend.first, mode, true, (size_t) 1)
+          ->Arg(kBackendBytes);
+    }
+  }
+  for (const auto &backend : kKalynaBackends) {
+    try {
+      Kalyna probe(128, 128, backend.first);
+    } catch (const std::invalid_argument &) {
+      continue;
+    }
+    for (const auto &size : kKalynaSizes) {
+      for (Mode mode : {Mode::kECB, Mode::kCTR}) {
+        const std::string name = "Backends/Kalyna-" + std::to_string(size[0]) + "-" + std::to_string(size[1]) +
+            "/" + (mode == Mode::kECB ? "ECB" : "CTR") + "/" + backend.second;
+        benchmark::RegisterBenchmark(name.c_str(), KalynaMode, size[0], size[1], backend.first, mode, true)
+            ->Arg(kBackendBytes);
+      }
+    }
+  }
+}
+
+// Kalyna ECB at every width KalynaCipher::EncipherBlocks interleaves
+static void RegisterBatchWidths() {
+  const std::pair<const char *, void (*)(benchmark::State &)> ciphers[] =
+      {{"128-128", KalynaBatchWidth<128, 128>}, {"128-256", KalynaBatchWidth<128, 256>},
+       {"256-256", KalynaBatchWidth<256, 256>}, {"256-512", KalynaBatchWidth<256, 512>},
+       {"512-512", KalynaBatchWidth<512, 512>}};
+  for (const auto &cipher : ciphers) {
+    auto *registered =
+        benchmark::RegisterBenchmark((std::string("BatchWidth/Kalyna-") + cipher.first).c_str(), cipher.second);
+    registered->ArgNames({"len", "width"});
+    for (int64_t width : {1, 2, 4, 8}) {
+      registered->Args({kBackendBytes, width});
+    }
+  }
+}
+
+// The AES directions that run on the worker pool, from one thread to one per hardware
+// thread in powers of two; the throughput flattens out at the memory bandwidth.
+static void RegisterScaling() {
+  const size_t hardware = std::thread::hardware_concurrency() ? std::thread::hardware_concurrency() : 1;
+  std::vector<size_t> counts;
+  for (size_t threads = 1; threads < hardware; threads *= 2) {
+    counts.push_back(threads);
+  }
+  counts.push_back(hardware);
+
+  const std::pair<Mode, bool> runs[] =
+      {{Mode::kECB, true}, {Mode::kCTR, true}, {Mode::kCBC, false}, {Mode::kCFB, false}};
+  const AESBackend backend = AES().Backend();
+  for (const auto &run : runs) {
+    for (size_t threads : counts) {
+      const std::string name = std::string("Scaling/AES-256/") + kModes[(size_t) run.first].second + "/" +
+          (run.second ? "encrypt" : "decrypt") + "/threads:" + std::to_string(threads);
+      benchmark::RegisterBenchmark(name.c_str(), AesMode, 256, backend, run.first, run.second, threads)
+          ->Arg(kScalingBytes)->UseRealTime();
+    }
+  }
+}
+
+static void RegisterKeySetup() {
+  for (int keyLen : {128, 192, 256}) {
+    benchmark::RegisterBenchmark(("KeySetup/AES-" + std::to_string(keyLen)).c_str(), AesKeySetup, keyLen);
+  }
+  for (const auto &size : kKalynaSizes) {
+    const std::string name = "KeySetup/Kalyna-" + std::to_string(size[0]) + "-" + std::to_string(size[1]);
+    benchmark::RegisterBenchmark(name.c_str(), KalynaKeySetup, size[0], size[1], (size_t) 1);
+    benchmark::RegisterBenchmark((name + "/batch16").c_str(), KalynaKeySetup, size[0], size[1], (size_t) 16);
+  }
+}
+
+int main(int argc, char **argv) {
+  benchmark::Initialize(&argc, argv);
+  if (benchmark::ReportUnrecognizedArguments(argc, argv)) {
+    return 1;
+  }
+  RegisterKeySetup();
+  RegisterBackends();
+  RegisterBatchWidths();
+  RegisterScaling();
+  RegisterModes();
+  benchmark::RunSpecifiedBenchmarks();
+  benchmark::Shutdown();
+  return 0;
+}
@@ -0,0 +1,126 @@
+#include <benchmark/benchmark.h>
+#include <fcntl.h>
+#include <unistd.h>
+
+#include <cstdlib>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "aes.h"
+#include "aes_stream.h"
+#include "file_pipeline.h"
+
+// AES-128 CTR of one file through the synchronous, threaded and io_uring pipelines at
+// several queue depths and buffer sizes. The file is PIPELINE_BENCH_FILE, created with
+// PIPELINE_BENCH_BYTES (default 256 MB) of data if it does not exist, or a temporary file
+// in TMPDIR; point it at the disk to be measured, a file in the page cache only shows how
+// well the copies overlap the encryption.
+
+static const uint8_t kKey[16] = {0x00, 0x01, 0x02, 0x03, 0x04, 0x05, 0x06, 0x07, 0x08, 0x09, 0x0a, 0x0b, 0x0c,
+                                 0x0d, 0x0e, 0x0f};
+static const uint8_t kIv[16] = {0xf0, 0xf1, 0xf2, 0xf3, 0xf4, 0xf5, 0xf6, 0xf7};
+
+struct BenchFiles {
+  std::string input, output;
+  bool temporary;
+  uint64_t size;
+
+  ~BenchFiles() {
+    if (temporary) {
+      unlink(input.c_str());
+    }
+    unlink(output.c_str());
+  }
+};
+
+static const BenchFiles &Files() {
+  static const std::unique_ptr<BenchFiles> files = [] {
+    auto created = std::make_unique<BenchFiles>();
+    const char *bytes = getenv("PIPELINE_BENCH_BYTES");
+    created->size = bytes ? std::strtoull(bytes, nullptr, 10) : 256ull << 20u;
+    const char *path = getenv("PIPELINE_BENCH_FILE");
+    const char *dir = getenv("TMPDIR");
+    created->temporary = path == nullptr;
+    created->input = path ? path : std::string(dir ? dir : "/tmp") + "/pipeline_bench.in";
+    created->output = created->input + ".out";
+
+    const int fd = open(created->input.c_str(), O_RDONLY);
+    if (fd >= 0) {
+      created->size = (uint64_t) lseek(fd, 0, SEEK_END);
+      close(fd);
+      return created;
+    }
+    const int out = open(created->input.c_str(), O_WRONLY | O_CREAT | O_TRUNC, 0644);
+    std::vector<uint8_t> chunk(1u << 20u);
+    for (size_t i = 0; i < chunk.size(); i++) {
+      chunk[i] = (uint8_t) (i * 131 + 7);
+    }
+    for (uint64_t done = 0; out >= 0 && done < created->size; done += chunk.size()) {
+      const size_t len = created->size - done < chunk.size() ? (size_t) (created->size - done) : chunk.size();
+      WriteFull(out, chunk.data(), len, done);
+    }
+    if (out >= 0) {
+      close(out);
+    }
+    return created;
+  }();
+  return *files;
+}
+
+static void Pipeline(benchmark::State &state, PipelineBackend backend) {
+  const BenchFiles &files = Files();
+  PipelineOptions options;
+  options.backend = backend;
+  options.queueDepth = (size_t) state.range(0);
+  options.bufferBytes = (size_t) state.range(1);
+
+  const int in = open(files.input.c_str(), O_RDONLY);
+  const int out = open(files.output.c_str(), O_WRONLY | O_CREAT | O_TRUNC, 0644);
+  if (in < 0 || out < 0) {
+    state.SkipWithError("cannot open the benchmark files");
+    return;
+  }
+  const AES aes(128);
+  const AesKey key = aes.ExpandKey(kKey);
+  for (auto _ : state) {
+    auto context = std::make_shared<AesStream>(aes, key, AesStreamMode::kCTR, true);
+    context->Init(kIv);
+    const PipelineStream stream{
+        [context](const uint8_t in[], uint8_t out[], size_t len) { return context->Update(in, out, len); },
+        [context](uint8_t out[]) { return context->Final(out); }, 16};
+    PipelineBackend used;
+    benchmark::DoNotOptimize(RunPipeline(in, out, files.size, stream, options, used));
+  }
+  close(in);
+  close(out);
+  state.SetBytesProcessed((int64_t) (files.size * state.iterations()));
+}
+
+int main(int argc, char **argv) {
+  benchmark::Initialize(&argc, argv);
+  if (benchmark::ReportUnrecognizedArguments(argc, argv)) {
+    return 1;
+  }
+  const std::pair<PipelineBackend, const char *> backends[] =
+      {{PipelineBackend::kSync, "sync"}, {PipelineBackend::kThreads, "threads"}, {PipelineBackend::kUring, "uring"}};
+  for (const auto &backend : backends) {
+    if (backend.first == PipelineBackend::kUring && !UringAvailable()) {
+      continue;
+    }
+    auto *registered = benchmark::RegisterBenchmark((std::string("Pipeline/") + backend.second).c_str(), Pipeline,
+                                                    backend.first);
+    registered->ArgNames({"depth", "buffer"})->UseRealTime()->Unit(benchmark::kMillisecond);
+    for (int64_t depth : {1, 4, 16}) {
+      if (backend.first == PipelineBackend::kSync && depth > 1) {
+        continue;
+      }
+      for (int64_t buffer : {64 << 10, 1 << 20}) {
+        registered->Args({depth, buffer});
+      }
+    }
+  }
+  benchmark::RunSpecifiedBenchmarks();
+  benchmark::Shutdown();
+  return 0;
+}
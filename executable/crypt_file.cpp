@@ -0,0 +1,507 @@
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include <atomic>
+#include <cerrno>
+#include <chrono>
+#include <cstdio>
+#include <cstring>
+#include <exception>
+#include <functional>
+#include <memory>
+#include <iostream>
+#include <mutex>
+#include <stdexcept>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "aes.h"
+#include "aes_stream.h"
+#include "aes_xts.h"
+#include "file_pipeline.h"
+#include "kalyna.h"
+#include "kalyna_stream.h"
+
+// Encrypts or decrypts a file of any size with AES or Kalyna. The file is cut into chunks
+// that worker threads take in turn, through memory maps of the input and output or through
+// pread/pwrite into one buffer per thread. Chunks of ECB, CTR and XTS, and of CBC and CFB
+// decryption, are independent; CBC and CFB encryption and OFB chain every block to the one
+// before, so their chunks run in order. The output has the length of the input: ECB and CBC
+// need whole blocks, XTS needs at least one block in the last sector.
+//
+// --io uring, threads and sync instead stream CBC, CFB, OFB and CTR through the stream
+// contexts with file_pipeline.h, which overlaps the reads and writes with the encryption.
+
+static const char kUsage[] =
+    "usage: crypt_file encrypt|decrypt CIPHER MODE KEY IV INPUT OUTPUT [--threads N] [--chunk BYTES]"
+    " [--io mmap|pread|uring|threads|sync] [--queue-depth N] [--buffer BYTES]\n"
+    "  CIPHER  aes-128, aes-192, aes-256, kalyna-128-128, kalyna-128-256, kalyna-256-256, kalyna-256-512,"
+    " kalyna-512-512\n"
+    "  MODE    ecb, cbc, cfb, ofb, ctr, xts (AES only, data key then tweak key, 4096-byte sectors)\n"
+    "  KEY, IV hex strings, IV is one block and ignored by ecb and xts\n";
+
+// XTS data unit
+static const size_t kSectorBytes = 4096;
+// every chunk is a whole number of sectors and so of blocks of every cipher
+static const size_t kDefaultChunkBytes = 8u << 20u;
+
+// how the first block of a chunk depends on the chunk before it
+enum class Chaining {
+  // on nothing but the position in the file
+  kNone,
+  // the iv is the last ciphertext block of the chunk before: CBC, CFB with whole-block segments
+  kCiphertext,
+  // the iv is the last keystream block of the chunk before, the xor of its last input and output blocks
+  kKeystream
+};
+
+struct FileJob {
+  size_t blockBytes;
+  Chaining chaining;
+  // len bytes at position offset of the file, iv is the chaining block of the chunk
+  std::function<void(const uint8_t in[], uint8_t out[], size_t len, uint64_t offset, const uint8_t iv[])> run;
+};
+
+static std::vector<uint8_t> ParseHex(const std::string &hex) {
+  if (hex.size() % 2) {
+    throw std::invalid_argument("Hex string has an odd length: " + hex);
+  }
+  std::vector<uint8_t> bytes(hex.size() / 2);
+  for (size_t i = 0; i < bytes.size(); i++) {
+    size_t used = 0;
+    const std::string digits = hex.substr(2 * i, 2);
+    const unsigned long value = std::stoul(digits, &used, 16);
+    if (used != 2) {
+      throw std::invalid_argument("Not a hex string: " + hex);
+    }
+    bytes[i] = (uint8_t) value;
+  }
+  return bytes;
+}
+
+static void CheckLength(const std::vector<uint8_t> &bytes, size_t expected, const char *what) {
+  if (bytes.size() != expected) {
+    throw std::invalid_argument(std::string(what) + " must be " + std::to_string(expected) + " bytes");
+  }
+}
+
+static FileJob AesJob(int keyLen, const std::string &mode, bool encrypt, const std::vector<uint8_t> &key,
+                      const std::vector<uint8_t> &iv) {
+  AES aes(keyLen);
+  // the chunks are the unit of parallelism, every call stays on its worker
+  aes.SetParallelism(1);
+  const size_t keyBytes = (size_t) keyLen / 8;
+
+  if (mode == "xts") {
+    CheckLength(key, 2 * keyBytes, "XTS key");
+    const AesXts xts(aes, key.data());
+    return {16, Chaining::kNone, [xts, encrypt](const uint8_t in[], uint8_t out[], size_t len, uint64_t offset,
+                                                const uint8_t *) {
+      const size_t sectors = len / kSectorBytes;
+      const uint64_t first = offset / kSectorBytes;
+      if (encrypt) {
+        xts.EncryptSectors(in, out, kSectorBytes, sectors, first);
+      } else {
+        xts.DecryptSectors(in, out, kSectorBytes, sectors, first);
+      }
+      const size_t done = sectors * kSectorBytes;
+      if (done < len) {
+        uint8_t tweak[16] = {};
+        for (size_t i = 0; i < 8; i++) {
+          tweak[i] = (uint8_t) ((first + sectors) >> (8 * i));
+        }
+        if (encrypt) {
+          xts.Encrypt(in + done, out + done, len - done, tweak);
+        } else {
+          xts.Decrypt(in + done, out + done, len - done, tweak);
+        }
+      }
+    }};
+  }
+
+  CheckLength(key, keyBytes, "Key");
+  if (mode != "ecb") {
+    CheckLength(iv, 16, "IV");
+  }
+  const AesKey expanded = aes.ExpandKey(key.data());
+  const std::vector<uint8_t> counter = iv;
+  if (mode == "ecb") {
+    return {16, Chaining::kNone, [aes, expanded, encrypt](const uint8_t in[], uint8_t out[], size_t len, uint64_t,
+                                                           const uint8_t *) {
+      encrypt ? aes.EncryptECB(in, out, len, expanded) : aes.DecryptECB(in, out, len, expanded);
+    }};
+  }
+  if (mode == "cbc") {
+    return {16, Chaining::kCiphertext, [aes, expanded, encrypt](const uint8_t in[], uint8_t out[], size_t len,
+                                                                 uint64_t, const uint8_t iv[]) {
+      encrypt ? aes.EncryptCBC(in, out, len, expanded, iv) : aes.DecryptCBC(in, out, len, expanded, iv);
+    }};
+  }
+  if (mode == "cfb") {
+    return {16, Chaining::kCiphertext, [aes, expanded, encrypt](const uint8_t in[], uint8_t out[], size_t len,
+                                                                 uint64_t, const uint8_t iv[]) {
+      encrypt ? aes.EncryptCFB(in, out, len, 16, expanded, iv) : aes.DecryptCFB(in, out, len, 16, expanded, iv);
+    }};
+  }
+  if (mode == "ofb") {
+    return {16, Chaining::kKeystream, [aes, expanded](const uint8_t in[], uint8_t out[], size_t len, uint64_t,
+                                                       const uint8_t iv[]) {
+      aes.EncryptOFB(in, out, len, expanded, iv);
+    }};
+  }
+  if (mode == "ctr") {
+    return {16, Chaining::kNone, [aes, expanded, counter](const uint8_t in[], uint8_t out[], size_t len,
+                                                           uint64_t offset, const uint8_t *) {
+      aes.EncryptCTR(in, out, len, expanded, counter.data(), offset);
+    }};
+  }
+  throw std::invalid_argument("Unknown mode " + mode);
+}
+
+static FileJob KalynaJob(size_t blockSize, size_t keySize, const std::string &mode, bool encrypt,
+                         const std::vector<uint8_t> &key, const std::vector<uint8_t> &iv) {
+  const Kalyna kalyna(blockSize, keySize);
+  const size_t block = kalyna.BlockBytes();
+  CheckLength(key, keySize / 8, "Key");
+  if (mode != "ecb") {
+    CheckLength(iv, block, "IV");
+  }
+  const KalynaKey expanded = kalyna.ExpandKey(key.data());
+  const std::vector<uint8_t> start = iv;
+  if (mode == "ecb") {
+    return {block, Chaining::kNone, [kalyna, expanded, encrypt](const uint8_t in[], uint8_t out[], size_t len,
+                                                                 uint64_t, const uint8_t *) {
+      encrypt ? kalyna.EncryptECB(in, out, len, expanded) : kalyna.DecryptECB(in, out, len, expanded);
+    }};
+  }
+  if (mode == "cbc") {
+    return {block, Chaining::kCiphertext, [kalyna, expanded, encrypt](const uint8_t in[], uint8_t out[], size_t len,
+                                                                       uint64_t, const uint8_t iv[]) {
+      encrypt ? kalyna.EncryptCBC(in, out, len, expanded, iv) : kalyna.DecryptCBC(in, out, len, expanded, iv);
+    }};
+  }
+  if (mode == "cfb") {
+    return {block, Chaining::kCiphertext, [kalyna, expanded, encrypt, block](const uint8_t in[], uint8_t out[],
+                                                                              size_t len, uint64_t,
+                                                                              const uint8_t iv[]) {
+      encrypt ? kalyna.EncryptCFB(in, out, len, block, expanded, iv)
+              : kalyna.DecryptCFB(in, out, len, block, expanded, iv);
+    }};
+  }
+  if (mode == "ofb") {
+    return {block, Chaining::kKeystream, [kalyna, expanded](const uint8_t in[], uint8_t out[], size_t len, uint64_t,
+                                                             const uint8_t iv[]) {
+      kalyna.EncryptOFB(in, out, len, expanded, iv);
+    }};
+  }
+  if (mode == "ctr") {
+    return {block, Chaining::kNone, [kalyna, expanded, start](const uint8_t in[], uint8_t out[], size_t len,
+                                                               uint64_t offset, const uint8_t *) {
+      kalyna.EncryptCTR(in, out, len, expanded, start.data(), offset);
+    }};
+  }
+  throw std::invalid_argument("Unknown mode " + mode);
+}
+
+static FileJob MakeJob(const std::string &cipher, const std::string &mode, bool encrypt,
+                       const std::vector<uint8_t> &key, const std::vector<uint8_t> &iv) {
+  if (cipher == "aes-128" || cipher == "aes-192" || cipher == "aes-256") {
+    return AesJob(std::stoi(cipher.substr(4)), mode, encrypt, key, iv);
+  }
+  size_t blockSize = 0, keySize = 0;
+  if (sscanf(cipher.c_str(), "kalyna-%zu-%zu", &blockSize, &keySize) == 2) {
+    if (mode == "xts") {
+      throw std::invalid_argument("XTS is only defined for AES");
+    }
+    return KalynaJob(blockSize, keySize, mode, encrypt, key, iv);
+  }
+  throw std::invalid_argument("Unknown cipher " + cipher);
+}
+
+static PipelineStream MakeStream(const std::string &cipher, const std::string &mode, bool encrypt,
+                                 const std::vector<uint8_t> &key, const std::vector<uint8_t> &iv) {
+  if (cipher == "aes-128" || cipher == "aes-192" || cipher == "aes-256") {
+    const AesStreamMode streamMode = mode == "cbc" ? AesStreamMode::kCBC : mode == "cfb" ? AesStreamMode::kCFB
+                                                                         : mode == "ofb" ? AesStreamMode::kOFB
+                                                                                         : AesStreamMode::kCTR;
+    const AES aes(std::stoi(cipher.substr(4)));
+    CheckLength(key, (size_t) std::stoi(cipher.substr(4)) / 8, "Key");
+    CheckLength(iv, 16, "IV");
+    auto context = std::make_shared<AesStream>(aes, aes.ExpandKey(key.data()), streamMode, encrypt);
+    context->Init(iv.data());
+    return {[context](const uint8_t in[], uint8_t out[], size_t len) { return context->Update(in, out, len); },
+            [context](uint8_t out[]) { return context->Final(out); }, 16};
+  }
+  size_t blockSize = 0, keySize = 0;
+  if (sscanf(cipher.c_str(), "kalyna-%zu-%zu", &blockSize, &keySize) != 2) {
+    throw std::invalid_argument("Unknown cipher " + cipher);
+  }
+  const KalynaStreamMode streamMode = mode == "cbc" ? KalynaStreamMode::kCBC : mode == "cfb" ? KalynaStreamMode::kCFB
+                                                                             : mode == "ofb" ? KalynaStreamMode::kOFB
+                                                                                             : KalynaStreamMode::kCTR;
+  const Kalyna kalyna(blockSize, keySize);
+  CheckLength(key, keySize / 8, "Key");
+  CheckLength(iv, kalyna.BlockBytes(), "IV");
+  auto context = std::make_shared<KalynaStream>(kalyna, kalyna.ExpandKey(key.data()), streamMode, encrypt);
+  context->Init(iv.data());
+  return {[context](const uint8_t in[], uint8_t out[], size_t len) { return context->Update(in, out, len); },
+          [context](uint8_t out[]) { return context->Final(out); }, kalyna.BlockBytes()};
+}
+
+static std::runtime_error SystemError(const std::string &what) {
+  return std::runtime_error(what + ": " + strerror(errno));
+}
+
+// Splits size bytes into chunks and calls chunk(index, offset, len) for each, on threads
+// workers when parallel, in file order on the calling thread otherwise. The first
+// exception of any worker is rethrown once all of them are done.
+template<typename Chunk>
+static void ForEachChunk(uint64_t size, size_t chunkBytes, size_t threads, bool parallel, const Chunk &chunk) {
+  const uint64_t chunks = (size + chunkBytes - 1) / chunkBytes;
+  const auto run = [&](size_t worker, uint64_t index) {
+    const uint64_t offset = index * chunkBytes;
+    chunk(worker, offset, (size_t) (size - offset < chunkBytes ? size - offset : chunkBytes));
+  };
+  if (!parallel || threads <= 1 || chunks <= 1) {
+    for (uint64_t index = 0; index < chunks; index++) {
+      run(0, index);
+    }
+    return;
+  }
+
+  std::atomic<uint64_t> next(0);
+  std::exception_ptr error;
+  std::mutex errorMutex;
+  std::vector<std::thread> workers;
+  const size_t count = threads < chunks ? threads : (size_t) chunks;
+  for (size_t worker = 0; worker < count; worker++) {
+    workers.emplace_back([&, worker] {
+      try {
+        for (uint64_t index; (index = next.fetch_add(1)) < chunks;) {
+          run(worker, index);
+        }
+      } catch (...) {
+        const std::lock_guard<std::mutex> lock(errorMutex);
+        if (!error) {
+          error = std::current_exception();
+        }
+        next.store(chunks);
+      }
+    });
+  }
+  for (std::thread &worker : workers) {
+    worker.join();
+  }
+  if (error) {
+    std::rethrow_exception(error);
+  }
+}
+
+// the chaining block of the chunk at offset, read from the processed data before it
+static void NextIv(const FileJob &job, const uint8_t lastIn[], const uint8_t lastOut[], bool encrypt,
+                   uint8_t iv[]) {
+  if (job.chaining == Chaining::kKeystream) {
+    for (size_t i = 0; i < job.blockBytes; i++) {
+      iv[i] = (uint8_t) (lastIn[i] ^ lastOut[i]);
+    }
+  } else if (job.chaining == Chaining::kCiphertext) {
+    memcpy(iv, encrypt ? lastOut : lastIn, job.blockBytes);
+  }
+}
+
+static void MapFiles(const FileJob &job, bool encrypt, const std::vector<uint8_t> &iv, int in, int out,
+                     uint64_t size, size_t chunkBytes, size_t threads, bool parallel) {
+  if (ftruncate(out, (off_t) size) != 0) {
+    throw SystemError("ftruncate");
+  }
+  if (size == 0) {
+    return;
+  }
+  auto *input = (uint8_t *) mmap(nullptr, size, PROT_READ, MAP_SHARED, in, 0);
+  if (input == MAP_FAILED) {
+    throw SystemError("mmap of the input");
+  }
+  auto *output = (uint8_t *) mmap(nullptr, size, PROT_READ | PROT_WRITE, MAP_SHARED, out, 0);
+  if (output == MAP_FAILED) {
+    munmap(input, size);
+    throw SystemError("mmap of the output");
+  }
+  madvise(input, size, MADV_SEQUENTIAL);
+
+  try {
+    ForEachChunk(size, chunkBytes, threads, parallel, [&](size_t, uint64_t offset, size_t len) {
+      uint8_t chained[Kalyna::kMaxBlockBytes];
+      const uint8_t *chunkIv = iv.data();
+      if (offset > 0 && job.chaining != Chaining::kNone) {
+        const size_t last = offset - job.blockBytes;
+        NextIv(job, input + last, output + last, encrypt, chained);
+        chunkIv = chained;
+      }
+      job.run(input + offset, output + offset, len, offset, chunkIv);
+    });
+  } catch (...) {
+    munmap(input, size);
+    munmap(output, size);
+    throw;
+  }
+  munmap(input, size);
+  if (munmap(output, size) != 0) {
+    throw SystemError("munmap of the output");
+  }
+}
+
+static void ReadWriteFiles(const FileJob &job, bool encrypt, const std::vector<uint8_t> &iv, int in, int out,
+                           uint64_t size, size_t chunkBytes, size_t threads, bool parallel) {
+  if (ftruncate(out, (off_t) size) != 0) {
+    throw SystemError("ftruncate");
+  }
+  std::vector<std::vector<uint8_t>> buffers(parallel ? threads : 1, std::vector<uint8_t>(chunkBytes));
+  // chaining block for the next chunk, only used when the chunks run in order
+  uint8_t carried[Kalyna::kMaxBlockBytes];
+  if (!iv.empty()) {
+    memcpy(carried, iv.data(), job.blockBytes);
+  }
+
+  ForEachChunk(size, chunkBytes, threads, parallel, [&](size_t worker, uint64_t offset, size_t len) {
+    uint8_t *buffer = buffers[worker].data();
+    ReadFull(in, buffer, len, offset);
+
+    uint8_t chained[Kalyna::kMaxBlockBytes];
+    const uint8_t *chunkIv = iv.data();
+    if (parallel) {
+      // only decryption of CBC and CFB runs chained chunks in parallel, the iv is the ciphertext before
+      if (offset > 0 && job.chaining == Chaining::kCiphertext) {
+        ReadFull(in, chained, job.blockBytes, offset - job.blockBytes);
+        chunkIv = chained;
+      }
+      job.run(buffer, buffer, len, offset, chunkIv);
+    } else {
+      uint8_t lastIn[Kalyna::kMaxBlockBytes];
+      const size_t last = len >= job.blockBytes ? len - job.blockBytes : 0;
+      memcpy(lastIn, buffer + last, len - last);
+      job.run(buffer, buffer, len, offset, job.chaining == Chaining::kNone ? iv.data() : carried);
+      if (len == chunkBytes) {
+        NextIv(job, lastIn, buffer + last, encrypt, carried);
+      }
+    }
+    WriteFull(out, buffer, len, offset);
+  });
+}
+
+int main(int argc, char **argv) {
+  if (argc < 8) {
+    std::cerr << kUsage;
+    return 2;
+  }
+  const std::string direction = argv[1];
+  const std::string cipher = argv[2];
+  const std::string mode = argv[3];
+  size_t threads = std::thread::hardware_concurrency() ? std::thread::hardware_concurrency() : 1;
+  size_t chunkBytes = kDefaultChunkBytes;
+  std::string io = "mmap";
+  PipelineOptions pipeline;
+
+  int in = -1, out = -1;
+  try {
+    if (direction != "encrypt" && direction != "decrypt") {
+      throw std::invalid_argument("Direction must be encrypt or decrypt");
+    }
+    const bool encrypt = direction == "encrypt";
+    for (int i = 8; i < argc; i++) {
+      const std::string option = argv[i];
+      if (i + 1 == argc) {
+        throw std::invalid_argument("Missing value of " + option);
+      }
+      const std::string value = argv[++i];
+      if (option == "--threads") {
+        threads = std::stoul(value);
+      } else if (option == "--chunk") {
+        chunkBytes = std::stoul(value);
+        if (chunkBytes == 0 || chunkBytes % kSectorBytes) {
+          throw std::invalid_argument("Chunk size must be a positive multiple of 4096");
+        }
+      } else if (option == "--io" && (value == "mmap" || value == "pread" || value == "uring" ||
+          value == "threads" || value == "sync")) {
+        io = value;
+      } else if (option == "--queue-depth") {
+        pipeline.queueDepth = std::stoul(value);
+      } else if (option == "--buffer") {
+        pipeline.bufferBytes = std::stoul(value);
+      } else {
+        throw std::invalid_argument("Unknown option " + option + " " + value);
+      }
+    }
+    threads = threads ? threads : 1;
+
+    const bool streamed = io == "uring" || io == "threads" || io == "sync";
+    if (streamed && mode != "cbc" && mode != "cfb" && mode != "ofb" && mode != "ctr") {
+      throw std::invalid_argument("--io " + io + " streams CBC, CFB, OFB and CTR only");
+    }
+    const std::vector<uint8_t> iv = mode == "ecb" || mode == "xts" ? std::vector<uint8_t>() : ParseHex(argv[5]);
+    const FileJob job = MakeJob(cipher, mode, encrypt, ParseHex(argv[4]), iv);
+
+    in = open(argv[6], O_RDONLY);
+    if (in < 0) {
+      throw SystemError(std::string("open ") + argv[6]);
+    }
+    struct stat inStat{};
+    if (fstat(in, &inStat) != 0) {
+      throw SystemError("fstat");
+    }
+    const uint64_t size = (uint64_t) inStat.st_size;
+    if ((mode == "ecb" || mode == "cbc") && size % job.blockBytes) {
+      throw std::invalid_argument("ECB and CBC need a multiple of " + std::to_string(job.blockBytes) + " bytes");
+    }
+    if (mode == "xts" && size % kSectorBytes && size % kSectorBytes < 16) {
+      throw std::invalid_argument("XTS needs at least one block in the last sector");
+    }
+
+    struct stat outStat{};
+    if (stat(argv[7], &outStat) == 0 && outStat.st_dev == inStat.st_dev && outStat.st_ino == inStat.st_ino) {
+      throw std::invalid_argument("Input and output must be different files");
+    }
+    out = open(argv[7], O_RDWR | O_CREAT | O_TRUNC, 0644);
+    if (out < 0) {
+      throw SystemError(std::string("open ") + argv[7]);
+    }
+
+    const bool parallel = job.chaining == Chaining::kNone || (job.chaining == Chaining::kCiphertext && !encrypt);
+    const auto before = std::chrono::steady_clock::now();
+    if (streamed) {
+      pipeline.backend = io == "uring" ? PipelineBackend::kUring : io == "threads" ? PipelineBackend::kThreads
+                                                                                   : PipelineBackend::kSync;
+      if (pipeline.backend == PipelineBackend::kUring && !UringAvailable()) {
+        fprintf(stderr, "io_uring is not available, using threads\n");
+        pipeline.backend = PipelineBackend::kThreads;
+      }
+      PipelineBackend used;
+      RunPipeline(in, out, size, MakeStream(cipher, mode, encrypt, ParseHex(argv[4]), iv), pipeline, used);
+    } else if (io == "mmap") {
+      MapFiles(job, encrypt, iv, in, out, size, chunkBytes, threads, parallel);
+    } else {
+      ReadWriteFiles(job, encrypt, iv, in, out, size, chunkBytes, threads, parallel);
+    }
+    const double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - before).count();
+    fprintf(stderr, "%s %s %s: %llu bytes in %.3lfs, %.1lf MB/s\n", cipher.c_str(), mode.c_str(), direction.c_str(),
+            (unsigned long long) size, seconds, seconds > 0 ? size / seconds / 1e6 : 0.0);
+  } catch (const std::exception &e) {
+    std::cerr << "Error: " << e.what() << std::endl;
+    if (in >= 0) {
+      close(in);
+    }
+    if (out >= 0) {
+      close(out);
+    }
+    return 1;
+  }
+
+  close(in);
+  if (close(out) != 0) {
+    std::cerr << "Error: close of the output: " << strerror(errno) << std::endl;
+    return 1;
+  }
+  return 0;
+}
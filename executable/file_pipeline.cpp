@@ -0,0 +1,564 @@
+#include <linux/io_uring.h>
+#include <sys/eventfd.h>
+#include <sys/mman.h>
+#include <sys/syscall.h>
+#include <sys/uio.h>
+#include <unistd.h>
+
+#include <cerrno>
+#include <condition_variable>
+#include <cstring>
+#include <deque>
+#include <exception>
+#include <initializer_list>
+#include <mutex>
+#include <stdexcept>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "file_pipeline.h"
+
+static std::runtime_error SystemError(const std::string &what, int error = errno) {
+  return std::runtime_error(what + ": " + strerror(error));
+}
+
+void ReadFull(int fd, uint8_t buffer[], size_t len, uint64_t offset) {
+  while (len > 0) {
+    const ssize_t got = pread(fd, buffer, len, (off_t) offset);
+    if (got < 0 && errno == EINTR) {
+      continue;
+    }
+    if (got <= 0) {
+      throw got == 0 ? std::runtime_error("Input file shrank while reading") : SystemError("pread");
+    }
+    buffer += got;
+    len -= (size_t) got;
+    offset += (uint64_t) got;
+  }
+}
+
+void WriteFull(int fd, const uint8_t buffer[], size_t len, uint64_t offset) {
+  while (len > 0) {
+    const ssize_t put = pwrite(fd, buffer, len, (off_t) offset);
+    if (put < 0 && errno == EINTR) {
+      continue;
+    }
+    if (put < 0) {
+      throw SystemError("pwrite");
+    }
+    buffer += put;
+    len -= (size_t) put;
+    offset += (uint64_t) put;
+  }
+}
+
+// one buffer of the pipeline
+struct Slot {
+  uint8_t *in;
+  // room for bufferBytes and two blocks: CBC may release a held back block and Final pads one more
+  uint8_t *out;
+  // bytes to read and how many of them arrived
+  size_t len, read;
+  // bytes the stream wrote to out and how many of them are on disk
+  size_t written, stored;
+  uint64_t readOffset, writeOffset;
+  bool last;
+};
+
+// in and out buffers of queueDepth slots, allocated together
+class Slots {
+ public:
+  Slots(const PipelineOptions &options, size_t blockBytes)
+      : outBytes(options.bufferBytes + 2 * blockBytes),
+        storage(options.queueDepth * (options.bufferBytes + outBytes)), slots(options.queueDepth) {
+    for (size_t i = 0; i < slots.size(); i++) {
+      slots[i] = Slot();
+      slots[i].in = storage.data() + i * (options.bufferBytes + outBytes);
+      slots[i].out = slots[i].in + options.bufferBytes;
+    }
+  }
+
+  Slot &operator[](size_t i) {
+    return slots[i];
+  }
+
+  size_t Count() const {
+    return slots.size();
+  }
+
+  const size_t outBytes;
+
+ private:
+  std::vector<uint8_t> storage;
+  std::vector<Slot> slots;
+};
+
+// sets up slot for buffer seq of a file of size bytes
+static void StartSlot(Slot &slot, uint64_t seq, uint64_t size, size_t bufferBytes) {
+  slot.readOffset = seq * bufferBytes;
+  slot.len = size - slot.readOffset < bufferBytes ? (size_t) (size - slot.readOffset) : bufferBytes;
+  slot.last = slot.readOffset + slot.len == size;
+  slot.read = 0;
+  slot.written = 0;
+  slot.stored = 0;
+}
+
+static void Encrypt(const PipelineStream &stream, Slot &slot) {
+  slot.written = stream.update(slot.in, slot.out, slot.len);
+  if (slot.last) {
+    slot.written += stream.final(slot.out + slot.written);
+  }
+}
+
+static uint64_t RunSync(int in, int out, uint64_t size, const PipelineStream &stream, const PipelineOptions &options) {
+  Slots slots(PipelineOptions{1, options.bufferBytes, options.backend}, stream.blockBytes);
+  Slot &slot = slots[0];
+  uint64_t written = 0;
+  if (size == 0) {
+    const size_t tail = stream.final(slot.out);
+    WriteFull(out, slot.out, tail, 0);
+    return tail;
+  }
+  const uint64_t buffers = (size + options.bufferBytes - 1) / options.bufferBytes;
+  for (uint64_t seq = 0; seq < buffers; seq++) {
+    StartSlot(slot, seq, size, options.bufferBytes);
+    ReadFull(in, slot.in, slot.len, slot.readOffset);
+    Encrypt(stream, slot);
+    WriteFull(out, slot.out, slot.written, written);
+    written += slot.written;
+  }
+  return written;
+}
+
+// Reader, encryption (the calling thread) and writer each go through the buffers in file
+// order, buffer seq always uses slot seq % queueDepth.
+static uint64_t RunThreads(int in, int out, uint64_t size, const PipelineStream &stream,
+                           const PipelineOptions &options) {
+  enum class State { kFree, kRead, kEncrypted };
+
+  Slots slots(options, stream.blockBytes);
+  std::vector<State> states(slots.Count(), State::kFree);
+  std::mutex mutex;
+  std::condition_variable changed;
+  std::exception_ptr error;
+  const uint64_t buffers = (size + options.bufferBytes - 1) / options.bufferBytes;
+
+  // waits until slot i is in state, false once a stage failed
+  const auto wait = [&](size_t i, State state) {
+    std::unique_lock<std::mutex> lock(mutex);
+    changed.wait(lock, [&] { return states[i] == state || error; });
+    return !error;
+  };
+  const auto set = [&](size_t i, State state) {
+    const std::lock_guard<std::mutex> lock(mutex);
+    states[i] = state;
+    changed.notify_all();
+  };
+  const auto fail = [&] {
+    const std::lock_guard<std::mutex> lock(mutex);
+    if (!error) {
+      error = std::current_exception();
+    }
+    changed.notify_all();
+  };
+
+  std::thread reader([&] {
+    try {
+      for (uint64_t seq = 0; seq < buffers && wait(seq % slots.Count(), State::kFree); seq++) {
+        Slot &slot = slots[seq % slots.Count()];
+        StartSlot(slot, seq, size, options.bufferBytes);
+        ReadFull(in, slot.in, slot.len, slot.readOffset);
+        set(seq % slots.Count(), State::kRead);
+      }
+    } catch (...) {
+      fail();
+    }
+  });
+  uint64_t written = 0;
+  std::thread writer([&] {
+    try {
+      for (uint64_t seq = 0; seq < buffers && wait(seq % slots.Count(), State::kEncrypted); seq++) {
+        Slot &slot = slots[seq % slots.Count()];
+        WriteFull(out, slot.out, slot.written, written);
+        written += slot.written;
+        set(seq % slots.Count(), State::kFree);
+      }
+    } catch (...) {
+      fail();
+    }
+  });
+
+  try {
+    for (uint64_t seq = 0; seq < buffers && wait(seq % slots.Count(), State::kRead); seq++) {
+      Encrypt(stream, slots[seq % slots.Count()]);
+      set(seq % slots.Count(), State::kEncrypted);
+    }
+  } catch (...) {
+    fail();
+  }
+  reader.join();
+  writer.join();
+  if (error) {
+    std::rethrow_exception(error);
+  }
+  return written;
+}
+
+// Minimal io_uring over the raw system calls: one submission and one completion queue
+// owned by a single thread.
+class Uring {
+ public:
+  explicit Uring(unsigned entries) {
+    io_uring_params params{};
+    fd = (int) syscall(__NR_io_uring_setup, entries, &params);
+    if (fd < 0) {
+      throw SystemError("io_uring_setup");
+    }
+    sqRingBytes = params.sq_off.array + params.sq_entries * sizeof(unsigned);
+    cqRingBytes = params.cq_off.cqes + params.cq_entries * sizeof(io_uring_cqe);
+    singleMmap = params.features & IORING_FEAT_SINGLE_MMAP;
+    if (singleMmap) {
+      sqRingBytes = cqRingBytes = sqRingBytes > cqRingBytes ? sqRingBytes : cqRingBytes;
+    }
+    sqRing = mmap(nullptr, sqRingBytes, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, fd, IORING_OFF_SQ_RING);
+    cqRing = singleMmap ? sqRing : mmap(nullptr, cqRingBytes, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, fd,
+                                         IORING_OFF_CQ_RING);
+    sqesBytes = params.sq_entries * sizeof(io_uring_sqe);
+    sqes = (io_uring_sqe *) mmap(nullptr, sqesBytes, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, fd,
+                                 IORING_OFF_SQES);
+    if (sqRing == MAP_FAILED || cqRing == MAP_FAILED || sqes == MAP_FAILED) {
+      const int error = errno;
+      Unmap();
+      close(fd);
+      throw SystemError("mmap of the io_uring queues", error);
+    }
+
+    auto *sq = (uint8_t *) sqRing;
+    sqTail = (unsigned *) (sq + params.sq_off.tail);
+    sqMask = *(unsigned *) (sq + params.sq_off.ring_mask);
+    sqArray = (unsigned *) (sq + params.sq_off.array);
+    auto *cq = (uint8_t *) cqRing;
+    cqHead = (unsigned *) (cq + params.cq_off.head);
+    cqTail = (unsigned *) (cq + params.cq_off.tail);
+    cqMask = *(unsigned *) (cq + params.cq_off.ring_mask);
+    cqes = (io_uring_cqe *) (cq + params.cq_off.cqes);
+  }
+
+  ~Uring() {
+    Unmap();
+    close(fd);
+  }
+
+  Uring(const Uring &) = delete;
+  Uring &operator=(const Uring &) = delete;
+
+  bool RegisterBuffers(const iovec buffers[], unsigned count) {
+    return syscall(__NR_io_uring_register, fd, IORING_REGISTER_BUFFERS, buffers, count) == 0;
+  }
+
+  // whether the kernel implements every opcode; IORING_REGISTER_PROBE came in 5.6 with
+  // IORING_OP_READ and IORING_OP_WRITE, so older kernels report nothing as supported
+  bool Supports(std::initializer_list<uint8_t> opcodes) {
+    const unsigned kOps = 256;
+    std::vector<uint64_t> storage((sizeof(io_uring_probe) + kOps * sizeof(io_uring_probe_op)) / sizeof(uint64_t));
+    auto *probe = (io_uring_probe *) storage.data();
+    if (syscall(__NR_io_uring_register, fd, IORING_REGISTER_PROBE, probe, kOps) != 0) {
+      return false;
+    }
+    for (uint8_t opcode : opcodes) {
+      if (opcode >= probe->ops_len || !(probe->ops[opcode].flags & IO_URING_OP_SUPPORTED)) {
+        return false;
+      }
+    }
+    return true;
+  }
+
+  // a cleared submission entry, passed to the kernel by the next Enter; the caller never
+  // has more entries in flight than the queue holds
+  io_uring_sqe &Prepare() {
+    const unsigned tail = *sqTail + pending;
+    const unsigned index = tail & sqMask;
+    io_uring_sqe &sqe = sqes[index];
+    memset(&sqe, 0, sizeof(sqe));
+    sqArray[index] = index;
+    pending++;
+    return sqe;
+  }
+
+  // submits the prepared entries and waits until at least wait completions are queued
+  void Enter(unsigned wait) {
+    __atomic_store_n(sqTail, *sqTail + pending, __ATOMIC_RELEASE);
+    while (true) {
+      const long submitted = syscall(__NR_io_uring_enter, fd, pending, wait, wait ? IORING_ENTER_GETEVENTS : 0,
+                                     nullptr, 0);
+      if (submitted >= 0) {
+        pending -= (unsigned) submitted;
+        if (pending == 0) {
+          return;
+        }
+        wait = 0;
+      } else if (errno != EINTR && errno != EAGAIN && errno != EBUSY) {
+        throw SystemError("io_uring_enter");
+      }
+    }
+  }
+
+  // calls completion(user_data, res) for every queued completion
+  template<typename Completion>
+  void Reap(const Completion &completion) {
+    unsigned head = *cqHead;
+    while (head != __atomic_load_n(cqTail, __ATOMIC_ACQUIRE)) {
+      const io_uring_cqe cqe = cqes[head & cqMask];
+      head++;
+      __atomic_store_n(cqHead, head, __ATOMIC_RELEASE);
+      completion(cqe.user_data, cqe.res);
+    }
+  }
+
+ private:
+  void Unmap() {
+    if (sqes != MAP_FAILED) {
+      munmap(sqes, sqesBytes);
+    }
+    if (!singleMmap && cqRing != MAP_FAILED) {
+      munmap(cqRing, cqRingBytes);
+    }
+    if (sqRing != MAP_FAILED) {
+      munmap(sqRing, sqRingBytes);
+    }
+  }
+
+  int fd;
+  bool singleMmap = false;
+  void *sqRing = MAP_FAILED, *cqRing = MAP_FAILED;
+  io_uring_sqe *sqes = (io_uring_sqe *) MAP_FAILED;
+  size_t sqRingBytes = 0, cqRingBytes = 0, sqesBytes = 0;
+  unsigned *sqTail = nullptr, *sqArray = nullptr, *cqHead = nullptr, *cqTail = nullptr;
+  unsigned sqMask = 0, cqMask = 0;
+  io_uring_cqe *cqes = nullptr;
+  // entries prepared but not yet taken by the kernel
+  unsigned pending = 0;
+};
+
+bool UringAvailable() {
+  static const bool available = [] {
+    try {
+      Uring probe(2);
+      return probe.Supports({IORING_OP_READ, IORING_OP_WRITE, IORING_OP_READ_FIXED, IORING_OP_WRITE_FIXED});
+    } catch (const std::runtime_error &) {
+      return false;
+    }
+  }();
+  return available;
+}
+
+// user_data of the eventfd read, the slots use 2 * slot for reads and 2 * slot + 1 for writes
+static const uint64_t kWakeup = ~0ull;
+
+// The calling thread keeps the reads and writes of every slot in flight and hands the read
+// buffers to the encryption thread in file order; the encryption thread posts an eventfd,
+// whose read is one more entry of the ring, for every buffer it is done with.
+static uint64_t RunUring(int in, int out, uint64_t size, const PipelineStream &stream,
+                         const PipelineOptions &options) {
+  enum class State { kFree, kReading, kRead, kEncrypting, kWriting };
+
+  Slots slots(options, stream.blockBytes);
+  const size_t depth = slots.Count();
+  Uring ring((unsigned) depth + 1);
+
+  std::vector<iovec> iovecs;
+  for (size_t i = 0; i < depth; i++) {
+    iovecs.push_back({slots[i].in, options.bufferBytes});
+    iovecs.push_back({slots[i].out, slots.outBytes});
+  }
+  // registration can fail on the memlock limit of older kernels, plain reads and writes work as well
+  const bool fixed = ring.RegisterBuffers(iovecs.data(), (unsigned) iovecs.size());
+
+  const int wakeup = eventfd(0, EFD_CLOEXEC);
+  if (wakeup < 0) {
+    throw SystemError("eventfd");
+  }
+  uint64_t wakeups = 0;
+  size_t inflight = 0;
+  const auto armWakeup = [&] {
+    io_uring_sqe &sqe = ring.Prepare();
+    sqe.opcode = IORING_OP_READ;
+    sqe.fd = wakeup;
+    sqe.addr = (uint64_t) &wakeups;
+    sqe.len = sizeof(wakeups);
+    sqe.user_data = kWakeup;
+    inflight++;
+  };
+  // the rest of the read or write of slot i
+  const auto submit = [&](size_t i, bool isWrite) {
+    Slot &slot = slots[i];
+    io_uring_sqe &sqe = ring.Prepare();
+    sqe.opcode = isWrite ? (fixed ? IORING_OP_WRITE_FIXED : IORING_OP_WRITE)
+                         : (fixed ? IORING_OP_READ_FIXED : IORING_OP_READ);
+    sqe.fd = isWrite ? out : in;
+    sqe.addr = (uint64_t) (isWrite ? slot.out + slot.stored : slot.in + slot.read);
+    sqe.len = (unsigned) (isWrite ? slot.written - slot.stored : slot.len - slot.read);
+    sqe.off = isWrite ? slot.writeOffset + slot.stored : slot.readOffset + slot.read;
+    sqe.buf_index = (uint16_t) (2 * i + (isWrite ? 1 : 0));
+    sqe.user_data = 2 * i + (isWrite ? 1 : 0);
+    inflight++;
+  };
+
+  std::vector<State> states(depth, State::kFree);
+  std::mutex mutex;
+  std::condition_variable queued;
+  // slots for the encryption thread, slots it is done with, in file order
+  std::deque<size_t> toEncrypt, encrypted;
+  bool stop = false;
+  std::exception_ptr encryptError;
+
+  std::thread encryptor([&] {
+    while (true) {
+      size_t i;
+      {
+        std::unique_lock<std::mutex> lock(mutex);
+        queued.wait(lock, [&] { return stop || !toEncrypt.empty(); });
+        if (stop) {
+          return;
+        }
+        i = toEncrypt.front();
+        toEncrypt.pop_front();
+      }
+      std::exception_ptr error;
+      try {
+        Encrypt(stream, slots[i]);
+      } catch (...) {
+        error = std::current_exception();
+      }
+      {
+        const std::lock_guard<std::mutex> lock(mutex);
+        encrypted.push_back(i);
+        if (error && !encryptError) {
+          encryptError = error;
+        }
+      }
+      const uint64_t one = 1;
+      if (write(wakeup, &one, sizeof(one)) != sizeof(one)) {
+        return;
+      }
+    }
+  });
+
+  const uint64_t buffers = (size + options.bufferBytes - 1) / options.bufferBytes;
+  uint64_t nextRead = 0, nextEncrypt = 0, done = 0, written = 0;
+  std::exception_ptr error;
+  try {
+    armWakeup();
+    while (done < buffers) {
+      for (; nextRead < buffers && states[nextRead % depth] == State::kFree; nextRead++) {
+        StartSlot(slots[nextRead % depth], nextRead, size, options.bufferBytes);
+        states[nextRead % depth] = State::kReading;
+        submit(nextRead % depth, false);
+      }
+      ring.Enter(1);
+
+      ring.Reap([&](uint64_t data, int32_t res) {
+        inflight--;
+        if (data == kWakeup) {
+          std::deque<size_t> ready;
+          {
+            const std::lock_guard<std::mutex> lock(mutex);
+            if (encryptError) {
+              std::rethrow_exception(encryptError);
+            }
+            ready.swap(encrypted);
+          }
+          for (size_t i : ready) {
+            Slot &slot = slots[i];
+            slot.writeOffset = written;
+            written += slot.written;
+            if (slot.written == 0) {
+              states[i] = State::kFree;
+              done++;
+            } else {
+              states[i] = State::kWriting;
+              submit(i, true);
+            }
+          }
+          armWakeup();
+          return;
+        }
+        const size_t i = (size_t) (data / 2);
+        Slot &slot = slots[i];
+        if (res < 0) {
+          throw SystemError(data % 2 ? "io_uring write" : "io_uring read", -res);
+        }
+        if (data % 2 == 0) {
+          if (res == 0) {
+            throw std::runtime_error("Input file shrank while reading");
+          }
+          slot.read += (size_t) res;
+          if (slot.read < slot.len) {
+            submit(i, false);
+          } else {
+            states[i] = State::kRead;
+          }
+        } else {
+          slot.stored += (size_t) res;
+          if (slot.stored < slot.written) {
+            submit(i, true);
+          } else {
+            states[i] = State::kFree;
+            done++;
+          }
+        }
+      });
+
+      for (; nextEncrypt < nextRead && states[nextEncrypt % depth] == State::kRead; nextEncrypt++) {
+        states[nextEncrypt % depth] = State::kEncrypting;
+        const std::lock_guard<std::mutex> lock(mutex);
+        toEncrypt.push_back(nextEncrypt % depth);
+        queued.notify_one();
+      }
+    }
+  } catch (...) {
+    error = std::current_exception();
+  }
+
+  {
+    const std::lock_guard<std::mutex> lock(mutex);
+    stop = true;
+    queued.notify_one();
+  }
+  encryptor.join();
+  // completes the pending eventfd read, then every buffer is left alone by the kernel before it is freed
+  const uint64_t one = 1;
+  if (write(wakeup, &one, sizeof(one)) == sizeof(one)) {
+    while (inflight > 0) {
+      ring.Enter(1);
+      ring.Reap([&](uint64_t, int32_t) { inflight--; });
+    }
+  }
+  close(wakeup);
+  if (error) {
+    std::rethrow_exception(error);
+  }
+  return written;
+}
+
+uint64_t RunPipeline(int in, int out, uint64_t size, const PipelineStream &stream, const PipelineOptions &options,
+                     PipelineBackend &used) {
+  if (options.queueDepth == 0 || options.queueDepth > 4096) {
+    throw std::invalid_argument("Queue depth must be between 1 and 4096");
+  }
+  if (options.bufferBytes == 0 || options.bufferBytes > (1u << 30u)) {
+    throw std::invalid_argument("Buffer size must be between 1 byte and 1 GB");
+  }
+  used = options.backend;
+  if (used == PipelineBackend::kAuto) {
+    used = UringAvailable() ? PipelineBackend::kUring : PipelineBackend::kThreads;
+  }
+  if (used == PipelineBackend::kSync || size == 0) {
+    return RunSync(in, out, size, stream, options);
+  }
+  if (used == PipelineBackend::kThreads) {
+    return RunThreads(in, out, size, stream, options);
+  }
+  return RunUring(in, out, size, stream, options);
+}
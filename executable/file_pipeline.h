@@ -0,0 +1,55 @@
+#ifndef AES_KALYNA_EXECUTABLE_FILE_PIPELINE_H_
+#define AES_KALYNA_EXECUTABLE_FILE_PIPELINE_H_
+
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+
+// Streams a file through an AesStream or KalynaStream: buffers are read, passed to the
+// context in file order on an encryption thread and written behind the reads, so the disk
+// and the cipher work at the same time. The output is the concatenation of every Update
+// and the Final of the context, written from offset 0 of out.
+
+enum class PipelineBackend {
+  // pread, Update, pwrite on the calling thread, one buffer at a time
+  kSync,
+  // a reader and a writer thread with blocking pread/pwrite, encryption on the calling thread
+  kThreads,
+  // io_uring through raw syscalls: up to queueDepth reads and writes in flight from the
+  // calling thread into registered buffers, the encryption thread wakes it with an eventfd
+  kUring,
+  // kUring when UringAvailable, kThreads otherwise
+  kAuto
+};
+
+struct PipelineOptions {
+  // buffers cycling between reading, encryption and writing
+  size_t queueDepth = 8;
+  // bytes read per buffer, a multiple of the block size keeps CBC from holding bytes back
+  size_t bufferBytes = 1u << 20u;
+  PipelineBackend backend = PipelineBackend::kAuto;
+};
+
+// Update and Final of a stream context, see AesStream and KalynaStream.
+// update may write up to len + blockBytes bytes to an out that does not overlap in.
+struct PipelineStream {
+  std::function<size_t(const uint8_t in[], uint8_t out[], size_t len)> update;
+  std::function<size_t(uint8_t out[])> final;
+  size_t blockBytes;
+};
+
+// io_uring_setup is allowed and the kernel implements the read and write opcodes (5.6+)
+bool UringAvailable();
+
+// pread and pwrite of exactly len bytes, retried after short transfers; throw std::runtime_error
+void ReadFull(int fd, uint8_t buffer[], size_t len, uint64_t offset);
+
+void WriteFull(int fd, const uint8_t buffer[], size_t len, uint64_t offset);
+
+// Encrypts size bytes of in into out, returns the number of bytes written and sets used to
+// the backend that ran (never kAuto). Throws std::runtime_error on I/O errors and rethrows
+// what the stream throws.
+uint64_t RunPipeline(int in, int out, uint64_t size, const PipelineStream &stream, const PipelineOptions &options,
+                     PipelineBackend &used);
+
+#endif //AES_KALYNA_EXECUTABLE_FILE_PIPELINE_H_
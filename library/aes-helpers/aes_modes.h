@@ -0,0 +1,53 @@
+#ifndef AES_KALYNA_LIBRARY_AES_HELPERS_AES_MODES_H_
+#define AES_KALYNA_LIBRARY_AES_HELPERS_AES_MODES_H_
+
+#include <cstring>
+
+#include "aes.h"
+#include "block_modes.h"
+#include "transformations.h"
+#include "workers.h"
+
+// AES and an expanded key seen as a BlockModes cipher. Decryption runs the equivalent
+// inverse cipher, the counter is a 64-bit big endian block number after 8 bytes of nonce,
+// and ranges of the threaded modes go to the worker pool of the AES object.
+class AesModes : public BlockModes<AesModes, 16, 8 * 16> {
+ public:
+  AesModes(const AES &aes, const AesKey &key) : aes(aes), key(key) {}
+
+  void EncryptBlock(const uint8_t in[], uint8_t out[]) const {
+    aes.EncryptBlock(in, out, key.encKeys);
+  }
+
+  void EncryptBlocks(const uint8_t in[], uint8_t out[], size_t blocks) const {
+    aes.EncryptBlocks(in, out, blocks, key.encKeys);
+  }
+
+  void DecryptBlocks(const uint8_t in[], uint8_t out[], size_t blocks) const {
+    aes.DecryptBlocks(in, out, blocks, key.decKeys);
+  }
+
+  void CounterStart(const uint8_t iv[], uint64_t block, uint8_t counter[]) const {
+    memcpy(counter, iv, kBlockBytes);
+    AddCtr(counter + kBlockBytes / 2, block);
+  }
+
+  static void CounterAdd(uint8_t counter[], uint64_t n) {
+    AddCtr(counter + kBlockBytes / 2, n);
+  }
+
+  size_t Parts(size_t blocks) const {
+    return aes.Parts(blocks);
+  }
+
+  template<typename Range>
+  void ForRanges(size_t blocks, size_t parts, const Range &range) const {
+    ForEachRange(aes.Pool(), blocks, parts, range);
+  }
+
+ private:
+  const AES &aes;
+  const AesKey &key;
+};
+
+#endif //AES_KALYNA_LIBRARY_AES_HELPERS_AES_MODES_H_
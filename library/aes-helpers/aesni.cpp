@@ -0,0 +1,171 @@
+#include "aesni.h"
+#include "cpu.h"
+
+#ifdef AES_KALYNA_AESNI
+
+#include <cstring>
+#include <wmmintrin.h>
+
+bool AesNiAvailable() {
+  return CpuHasAesNi();
+}
+
+void AesNiKeyExpansion(const uint8_t key[], uint8_t w[], size_t keyWords, size_t rounds) {
+  static const uint8_t rcon[] = {0x01, 0x02, 0x04, 0x08, 0x10, 0x20, 0x40, 0x80, 0x1b, 0x36};
+  const size_t totalWords = 4 * (rounds + 1);
+
+  uint32_t words[60];
+  memcpy(words, key, 4 * keyWords);
+
+  for (size_t i = keyWords; i < totalWords; i++) {
+    uint32_t temp = words[i - 1];
+
+    if (i % keyWords == 0 || (keyWords > 6 && i % keyWords == 4)) {
+      // AESKEYGENASSIST returns SubWord(X1) in dword 0 and RotWord(SubWord(X3)) in dword 3
+      const __m128i assist = _mm_aeskeygenassist_si128(_mm_set1_epi32((int) temp), 0);
+      if (i % keyWords == 0) {
+        temp = (uint32_t) _mm_cvtsi128_si32(_mm_shuffle_epi32(assist, 0xff)) ^ rcon[i / keyWords - 1];
+      } else {
+        temp = (uint32_t) _mm_cvtsi128_si32(assist);
+      }
+    }
+
+    words[i] = words[i - keyWords] ^ temp;
+  }
+
+  memcpy(w, words, 4 * totalWords);
+}
+
+void AesNiInvKeyExpansion(const uint8_t w[], uint8_t dw[], size_t rounds) {
+  const auto *rk = (const __m128i *) w;
+  auto *drk = (__m128i *) dw;
+
+  _mm_storeu_si128(drk, _mm_loadu_si128(rk + rounds));
+  for (size_t round = 1; round < rounds; round++) {
+    _mm_storeu_si128(drk + round, _mm_aesimc_si128(_mm_loadu_si128(rk + rounds - round)));
+  }
+  _mm_storeu_si128(drk + rounds, _mm_loadu_si128(rk));
+}
+
+void AesNiEncryptBlock(const uint8_t in[], uint8_t out[], const uint8_t *roundKeys, size_t rounds) {
+  const auto *rk = (const __m128i *) roundKeys;
+
+  __m128i state = _mm_xor_si128(_mm_loadu_si128((const __m128i *) in), _mm_loadu_si128(rk));
+  for (size_t round = 1; round < rounds; round++) {
+    state = _mm_aesenc_si128(state, _mm_loadu_si128(rk + round));
+  }
+  state = _mm_aesenclast_si128(state, _mm_loadu_si128(rk + rounds));
+
+  _mm_storeu_si128((__m128i *) out, state);
+}
+
+void AesNiDecryptBlock(const uint8_t in[], uint8_t out[], const uint8_t *roundKeys, size_t rounds) {
+  const auto *rk = (const __m128i *) roundKeys;
+
+  __m128i state = _mm_xor_si128(_mm_loadu_si128((const __m128i *) in), _mm_loadu_si128(rk));
+  for (size_t round = 1; round < rounds; round++) {
+    state = _mm_aesdec_si128(state, _mm_loadu_si128(rk + round));
+  }
+  state = _mm_aesdeclast_si128(state, _mm_loadu_si128(rk + rounds));
+
+  _mm_storeu_si128((__m128i *) out, state);
+}
+
+// number of blocks processed together by the multi-block functions
+static const size_t kLanes = 8;
+
+void AesNiEncryptBlocks(const uint8_t in[], uint8_t out[], size_t blocks, const uint8_t *roundKeys, size_t rounds) {
+  const auto *rk = (const __m128i *) roundKeys;
+  __m128i keys[15];
+  for (size_t round = 0; round <= rounds; round++) {
+    keys[round] = _mm_loadu_si128(rk + round);
+  }
+
+  for (; blocks >= kLanes; blocks -= kLanes, in += 16 * kLanes, out += 16 * kLanes) {
+    __m128i state[kLanes];
+    for (size_t lane = 0; lane < kLanes; lane++) {
+      state[lane] = _mm_xor_si128(_mm_loadu_si128((const __m128i *) in + lane), keys[0]);
+    }
+    for (size_t round = 1; round < rounds; round++) {
+      for (size_t lane = 0; lane < kLanes; lane++) {
+        state[lane] = _mm_aesenc_si128(state[lane], keys[round]);
+      }
+    }
+    for (size_t lane = 0; lane < kLanes; lane++) {
+      _mm_storeu_si128((__m128i *) out + lane, _mm_aesenclast_si128(state[lane], keys[rounds]));
+    }
+  }
+
+  for (; blocks > 0; blocks--, in += 16, out += 16) {
+    __m128i state = _mm_xor_si128(_mm_loadu_si128((const __m128i *) in), keys[0]);
+    for (size_t round = 1; round < rounds; round++) {
+      state = _mm_aesenc_si128(state, keys[round]);
+    }
+    _mm_storeu_si128((__m128i *) out, _mm_aesenclast_si128(state, keys[rounds]));
+  }
+}
+
+void AesNiDecryptBlocks(const uint8_t in[], uint8_t out[], size_t blocks, const uint8_t *roundKeys, size_t rounds) {
+  const auto *rk = (const __m128i *) roundKeys;
+  __m128i keys[15];
+  for (size_t round = 0; round <= rounds; round++) {
+    keys[round] = _mm_loadu_si128(rk + round);
+  }
+
+  for (; blocks >= kLanes; blocks -= kLanes, in += 16 * kLanes, out += 16 * kLanes) {
+    __m128i state[kLanes];
+    for (size_t lane = 0; lane < kLanes; lane++) {
+      state[lane] = _mm_xor_si128(_mm_loadu_si128((const __m128i *) in + lane), keys[0]);
+    }
+    for (size_t round = 1; round < rounds; round++) {
+      for (size_t lane = 0; lane < kLanes; lane++) {
+        state[lane] = _mm_aesdec_si128(state[lane], keys[round]);
+      }
+    }
+    for (size_t lane = 0; lane < kLanes; lane++) {
+      _mm_storeu_si128((__m128i *) out + lane, _mm_aesdeclast_si128(state[lane], keys[rounds]));
+    }
+  }
+
+  for (; blocks > 0; blocks--, in += 16, out += 16) {
+    __m128i state = _mm_xor_si128(_mm_loadu_si128((const __m128i *) in), keys[0]);
+    for (size_t round = 1; round < rounds; round++) {
+      state = _mm_aesdec_si128(state, keys[round]);
+    }
+    _mm_storeu_si128((__m128i *) out, _mm_aesdeclast_si128(state, keys[rounds]));
+  }
+}
+
+#else
+
+#include <stdexcept>
+
+bool AesNiAvailable() {
+  return false;
+}
+
+void AesNiKeyExpansion(const uint8_t[], uint8_t[], size_t, size_t) {
+  throw std::logic_error("AES-NI support is not compiled in");
+}
+
+void AesNiInvKeyExpansion(const uint8_t[], uint8_t[], size_t) {
+  throw std::logic_error("AES-NI support is not compiled in");
+}
+
+void AesNiEncryptBlock(const uint8_t[], uint8_t[], const uint8_t *, size_t) {
+  throw std::logic_error("AES-NI support is not compiled in");
+}
+
+void AesNiDecryptBlock(const uint8_t[], uint8_t[], const uint8_t *, size_t) {
+  throw std::logic_error("AES-NI support is not compiled in");
+}
+
+void AesNiEncryptBlocks(const uint8_t[], uint8_t[], size_t, const uint8_t *, size_t) {
+  throw std::logic_error("AES-NI support is not compiled in");
+}
+
+void AesNiDecryptBlocks(const uint8_t[], uint8_t[], size_t, const uint8_t *, size_t) {
+  throw std::logic_error("AES-NI support is not compiled in");
+}
+
+#endif
@@ -0,0 +1,27 @@
+#ifndef AES_KALYNA_LIBRARY_AES_HELPERS_AESNI_H_
+#define AES_KALYNA_LIBRARY_AES_HELPERS_AESNI_H_
+
+#include <cstdint>
+#include <cstdio>
+
+// library was built with AES-NI support and the CPU has it
+bool AesNiAvailable();
+
+// Only call these after AesNiAvailable() returned true.
+// Round keys use the same byte layout as the portable KeyExpansion/InvKeyExpansion.
+
+void AesNiKeyExpansion(const uint8_t key[], uint8_t w[], size_t keyWords, size_t rounds);
+
+void AesNiInvKeyExpansion(const uint8_t w[], uint8_t dw[], size_t rounds);
+
+void AesNiEncryptBlock(const uint8_t in[], uint8_t out[], const uint8_t *roundKeys, size_t rounds);
+
+void AesNiDecryptBlock(const uint8_t in[], uint8_t out[], const uint8_t *roundKeys, size_t rounds);
+
+// encrypt consecutive blocks, eight of them are in flight at once
+void AesNiEncryptBlocks(const uint8_t in[], uint8_t out[], size_t blocks, const uint8_t *roundKeys, size_t rounds);
+
+// decrypt consecutive blocks, eight of them are in flight at once
+void AesNiDecryptBlocks(const uint8_t in[], uint8_t out[], size_t blocks, const uint8_t *roundKeys, size_t rounds);
+
+#endif //AES_KALYNA_LIBRARY_AES_HELPERS_AESNI_H_
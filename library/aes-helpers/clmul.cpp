@@ -0,0 +1,222 @@
+#include "clmul.h"
+#include "cpu.h"
+
+#ifdef AES_KALYNA_AESNI
+
+#include <wmmintrin.h>
+#include <tmmintrin.h>
+
+bool ClmulAvailable() {
+  return CpuHasPclmul();
+}
+
+// GHASH works on bit-reflected values, reversing the bytes makes x^0 the top bit of the register
+static inline __m128i ByteSwap(__m128i v) {
+  return _mm_shuffle_epi8(v, _mm_set_epi8(0, 1, 2, 3, 4, 5, 6, 7, 8, 9, 10, 11, 12, 13, 14, 15));
+}
+
+// 256-bit carry-less product, Karatsuba-free since four multiplications pipeline well
+static inline void Multiply(__m128i a, __m128i b, __m128i &lo, __m128i &hi) {
+  const __m128i middle = _mm_xor_si128(_mm_clmulepi64_si128(a, b, 0x10), _mm_clmulepi64_si128(a, b, 0x01));
+  lo = _mm_xor_si128(_mm_clmulepi64_si128(a, b, 0x00), _mm_slli_si128(middle, 8));
+  hi = _mm_xor_si128(_mm_clmulepi64_si128(a, b, 0x11), _mm_srli_si128(middle, 8));
+}
+
+// shift the reflected product left by one and reduce it modulo x^128 + x^7 + x^2 + x + 1
+static inline __m128i Reduce(__m128i lo, __m128i hi) {
+  __m128i carryLo = _mm_srli_epi32(lo, 31);
+  __m128i carryHi = _mm_srli_epi32(hi, 31);
+  lo = _mm_slli_epi32(lo, 1);
+  hi = _mm_slli_epi32(hi, 1);
+  const __m128i across = _mm_srli_si128(carryLo, 12);
+  carryHi = _mm_slli_si128(carryHi, 4);
+  carryLo = _mm_slli_si128(carryLo, 4);
+  lo = _mm_or_si128(lo, carryLo);
+  hi = _mm_or_si128(_mm_or_si128(hi, carryHi), across);
+
+  __m128i a = _mm_xor_si128(_mm_xor_si128(_mm_slli_epi32(lo, 31), _mm_slli_epi32(lo, 30)), _mm_slli_epi32(lo, 25));
+  const __m128i b = _mm_srli_si128(a, 4);
+  a = _mm_slli_si128(a, 12);
+  lo = _mm_xor_si128(lo, a);
+
+  __m128i c = _mm_xor_si128(_mm_xor_si128(_mm_srli_epi32(lo, 1), _mm_srli_epi32(lo, 2)), _mm_srli_epi32(lo, 7));
+  c = _mm_xor_si128(c, b);
+  lo = _mm_xor_si128(lo, c);
+  return _mm_xor_si128(hi, lo);
+}
+
+static inline __m128i GfMultiply(__m128i a, __m128i b) {
+  __m128i lo, hi;
+  Multiply(a, b, lo, hi);
+  return Reduce(lo, hi);
+}
+
+// (x ^ d0) * H^4 ^ d1 * H^3 ^ d2 * H^2 ^ d3 * H with a single reduction, all values byte swapped
+static inline __m128i GhashFour(__m128i x, const __m128i d[4], const __m128i h[4]) {
+  __m128i lo, hi, plo, phi;
+  Multiply(_mm_xor_si128(x, d[0]), h[3], lo, hi);
+  for (int i = 1; i < 4; i++) {
+    Multiply(d[i], h[3 - i], plo, phi);
+    lo = _mm_xor_si128(lo, plo);
+    hi = _mm_xor_si128(hi, phi);
+  }
+  return Reduce(lo, hi);
+}
+
+void ClmulGhashInit(const uint8_t h[], uint8_t powers[]) {
+  auto *p = (__m128i *) powers;
+  const __m128i h1 = ByteSwap(_mm_loadu_si128((const __m128i *) h));
+  __m128i power = h1;
+  _mm_storeu_si128(p, power);
+  for (int i = 1; i < 4; i++) {
+    power = GfMultiply(power, h1);
+    _mm_storeu_si128(p + i, power);
+  }
+}
+
+static void LoadPowers(const uint8_t powers[], __m128i h[4]) {
+  for (int i = 0; i < 4; i++) {
+    h[i] = _mm_loadu_si128((const __m128i *) powers + i);
+  }
+}
+
+void ClmulGhashBlocks(uint8_t x[], const uint8_t data[], size_t blocks, const uint8_t powers[]) {
+  __m128i h[4];
+  LoadPowers(powers, h);
+  __m128i acc = ByteSwap(_mm_loadu_si128((const __m128i *) x));
+
+  for (; blocks >= 4; blocks -= 4, data += 64) {
+    __m128i d[4];
+    for (int i = 0; i < 4; i++) {
+      d[i] = ByteSwap(_mm_loadu_si128((const __m128i *) data + i));
+    }
+    acc = GhashFour(acc, d, h);
+  }
+  for (; blocks > 0; blocks--, data += 16) {
+    acc = GfMultiply(_mm_xor_si128(acc, ByteSwap(_mm_loadu_si128((const __m128i *) data))), h[0]);
+  }
+
+  _mm_storeu_si128((__m128i *) x, ByteSwap(acc));
+}
+
+// blocks encrypted per loop iteration, matches the GHASH aggregation
+static const size_t kLanes = 4;
+
+// encrypt kLanes counter blocks; the 32-bit counter is the low dword of the byte swapped block
+static inline void EncryptCounters(__m128i &counter, const __m128i keys[], size_t rounds, __m128i state[]) {
+  const __m128i one = _mm_set_epi32(0, 0, 0, 1);
+  for (size_t lane = 0; lane < kLanes; lane++) {
+    state[lane] = _mm_xor_si128(ByteSwap(counter), keys[0]);
+    counter = _mm_add_epi32(counter, one);
+  }
+  for (size_t round = 1; round < rounds; round++) {
+    for (size_t lane = 0; lane < kLanes; lane++) {
+      state[lane] = _mm_aesenc_si128(state[lane], keys[round]);
+    }
+  }
+  for (size_t lane = 0; lane < kLanes; lane++) {
+    state[lane] = _mm_aesenclast_si128(state[lane], keys[rounds]);
+  }
+}
+
+static void GcmBlocks(const uint8_t in[], uint8_t out[], size_t blocks, const uint8_t *roundKeys, size_t rounds,
+                      uint8_t counter[], uint8_t x[], const uint8_t powers[], bool encrypt) {
+  const auto *rk = (const __m128i *) roundKeys;
+  __m128i keys[15];
+  for (size_t round = 0; round <= rounds; round++) {
+    keys[round] = _mm_loadu_si128(rk + round);
+  }
+  __m128i h[4];
+  LoadPowers(powers, h);
+  __m128i acc = ByteSwap(_mm_loadu_si128((const __m128i *) x));
+  __m128i ctr = ByteSwap(_mm_loadu_si128((const __m128i *) counter));
+
+  // Encryption hashes the ciphertext of the previous group while the current one goes through
+  // the AES rounds, decryption hashes the current input; the two chains don't depend on each
+  // other, so the out-of-order core overlaps AESENC and PCLMULQDQ.
+  __m128i pending[kLanes];
+  bool hasPending = false;
+  for (; blocks >= kLanes; blocks -= kLanes, in += 16 * kLanes, out += 16 * kLanes) {
+    __m128i state[kLanes];
+    __m128i data[kLanes];
+    for (size_t lane = 0; lane < kLanes; lane++) {
+      data[lane] = _mm_loadu_si128((const __m128i *) in + lane);
+    }
+    EncryptCounters(ctr, keys, rounds, state);
+
+    if (encrypt) {
+      if (hasPending) {
+        acc = GhashFour(acc, pending, h);
+      }
+      for (size_t lane = 0; lane < kLanes; lane++) {
+        state[lane] = _mm_xor_si128(state[lane], data[lane]);
+        _mm_storeu_si128((__m128i *) out + lane, state[lane]);
+        pending[lane] = ByteSwap(state[lane]);
+      }
+      hasPending = true;
+    } else {
+      for (size_t lane = 0; lane < kLanes; lane++) {
+        _mm_storeu_si128((__m128i *) out + lane, _mm_xor_si128(state[lane], data[lane]));
+        data[lane] = ByteSwap(data[lane]);
+      }
+      acc = GhashFour(acc, data, h);
+    }
+  }
+  if (hasPending) {
+    acc = GhashFour(acc, pending, h);
+  }
+
+  const __m128i one = _mm_set_epi32(0, 0, 0, 1);
+  for (; blocks > 0; blocks--, in += 16, out += 16) {
+    __m128i state = _mm_xor_si128(ByteSwap(ctr), keys[0]);
+    ctr = _mm_add_epi32(ctr, one);
+    for (size_t round = 1; round < rounds; round++) {
+      state = _mm_aesenc_si128(state, keys[round]);
+    }
+    const __m128i data = _mm_loadu_si128((const __m128i *) in);
+    state = _mm_xor_si128(_mm_aesenclast_si128(state, keys[rounds]), data);
+    _mm_storeu_si128((__m128i *) out, state);
+    acc = GfMultiply(_mm_xor_si128(acc, ByteSwap(encrypt ? state : data)), h[0]);
+  }
+
+  _mm_storeu_si128((__m128i *) x, ByteSwap(acc));
+  _mm_storeu_si128((__m128i *) counter, ByteSwap(ctr));
+}
+
+void ClmulGcmEncryptBlocks(const uint8_t in[], uint8_t out[], size_t blocks, const uint8_t *roundKeys,
+                           size_t rounds, uint8_t counter[], uint8_t x[], const uint8_t powers[]) {
+  GcmBlocks(in, out, blocks, roundKeys, rounds, counter, x, powers, true);
+}
+
+void ClmulGcmDecryptBlocks(const uint8_t in[], uint8_t out[], size_t blocks, const uint8_t *roundKeys,
+                           size_t rounds, uint8_t counter[], uint8_t x[], const uint8_t powers[]) {
+  GcmBlocks(in, out, blocks, roundKeys, rounds, counter, x, powers, false);
+}
+
+#else
+
+#include <stdexcept>
+
+bool ClmulAvailable() {
+  return false;
+}
+
+void ClmulGhashInit(const uint8_t[], uint8_t[]) {
+  throw std::logic_error("PCLMULQDQ support is not compiled in");
+}
+
+void ClmulGhashBlocks(uint8_t[], const uint8_t[], size_t, const uint8_t[]) {
+  throw std::logic_error("PCLMULQDQ support is not compiled in");
+}
+
+void ClmulGcmEncryptBlocks(const uint8_t[], uint8_t[], size_t, const uint8_t *, size_t, uint8_t[], uint8_t[],
+                           const uint8_t[]) {
+  throw std::logic_error("PCLMULQDQ support is not compiled in");
+}
+
+void ClmulGcmDecryptBlocks(const uint8_t[], uint8_t[], size_t, const uint8_t *, size_t, uint8_t[], uint8_t[],
+                           const uint8_t[]) {
+  throw std::logic_error("PCLMULQDQ support is not compiled in");
+}
+
+#endif
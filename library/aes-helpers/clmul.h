@@ -0,0 +1,27 @@
+#ifndef AES_KALYNA_LIBRARY_AES_HELPERS_CLMUL_H_
+#define AES_KALYNA_LIBRARY_AES_HELPERS_CLMUL_H_
+
+#include <cstdint>
+#include <cstdio>
+
+// library was built with PCLMULQDQ support and the CPU has it
+bool ClmulAvailable();
+
+// Only call these after ClmulAvailable() returned true. x is the GHASH accumulator in the
+// byte order of the specification, powers holds H, H^2, H^3 and H^4 from ClmulGhashInit.
+
+void ClmulGhashInit(const uint8_t h[], uint8_t powers[]);
+
+// x = (x ^ data_i) * H for each of the blocks, four of them reduced together
+void ClmulGhashBlocks(uint8_t x[], const uint8_t data[], size_t blocks, const uint8_t powers[]);
+
+// Also need AES-NI. CTR with the 32-bit GCM counter, which is advanced past the used blocks,
+// and GHASH of the ciphertext in the same loop so both units stay busy.
+
+void ClmulGcmEncryptBlocks(const uint8_t in[], uint8_t out[], size_t blocks, const uint8_t *roundKeys,
+                           size_t rounds, uint8_t counter[], uint8_t x[], const uint8_t powers[]);
+
+void ClmulGcmDecryptBlocks(const uint8_t in[], uint8_t out[], size_t blocks, const uint8_t *roundKeys,
+                           size_t rounds, uint8_t counter[], uint8_t x[], const uint8_t powers[]);
+
+#endif //AES_KALYNA_LIBRARY_AES_HELPERS_CLMUL_H_
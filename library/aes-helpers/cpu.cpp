@@ -0,0 +1,36 @@
+#include "cpu.h"
+
+#if defined(__x86_64__) || defined(__i386__)
+#include <cpuid.h>
+#elif defined(_M_X64) || defined(_M_IX86)
+#include <intrin.h>
+#endif
+
+#include <cstdint>
+
+// ecx of CPUID leaf 1
+static uint32_t CpuidFeatures() {
+#if defined(__x86_64__) || defined(__i386__)
+  unsigned int eax, ebx, ecx, edx;
+  if (!__get_cpuid(1, &eax, &ebx, &ecx, &edx)) {
+    return 0;
+  }
+  return ecx;
+#elif defined(_M_X64) || defined(_M_IX86)
+  int info[4];
+  __cpuid(info, 1);
+  return (uint32_t) info[2];
+#else
+  return 0;
+#endif
+}
+
+bool CpuHasAesNi() {
+  static const bool supported = (CpuidFeatures() >> 25u) & 1u;
+  return supported;
+}
+
+bool CpuHasPclmul() {
+  static const bool supported = (CpuidFeatures() >> 1u) & 1u;
+  return supported;
+}
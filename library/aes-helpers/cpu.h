@@ -0,0 +1,10 @@
+#ifndef AES_KALYNA_LIBRARY_AES_HELPERS_CPU_H_
+#define AES_KALYNA_LIBRARY_AES_HELPERS_CPU_H_
+
+// AESENC/AESDEC/AESKEYGENASSIST/AESIMC instructions, checked once through CPUID
+bool CpuHasAesNi();
+
+// PCLMULQDQ carry-less multiplication, checked once through CPUID
+bool CpuHasPclmul();
+
+#endif //AES_KALYNA_LIBRARY_AES_HELPERS_CPU_H_
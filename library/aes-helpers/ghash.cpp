@@ -0,0 +1,76 @@
+#include "ghash.h"
+
+// reduction of the four bits shifted out of the low end, x^128 = x^7 + x^2 + x + 1
+static const uint64_t kLast4[16] =
+    {0x0000, 0x1c20, 0x3840, 0x2460, 0x7080, 0x6ca0, 0x48c0, 0x54e0,
+     0xe100, 0xfd20, 0xd940, 0xc560, 0x9180, 0x8da0, 0xa9c0, 0xb5e0};
+
+static uint64_t LoadBigEndian64(const uint8_t *p) {
+  uint64_t v = 0;
+  for (int i = 0; i < 8; i++) {
+    v = (v << 8u) | p[i];
+  }
+  return v;
+}
+
+static void StoreBigEndian64(uint64_t v, uint8_t *p) {
+  for (int i = 7; i >= 0; i--, v >>= 8u) {
+    p[i] = (uint8_t) v;
+  }
+}
+
+void GhashInit(const uint8_t h[], uint64_t tableHi[16], uint64_t tableLo[16]) {
+  uint64_t vh = LoadBigEndian64(h);
+  uint64_t vl = LoadBigEndian64(h + 8);
+
+  // bit order is reflected: index 8 is H itself, 4, 2 and 1 are H * x, x^2, x^3
+  tableHi[0] = 0;
+  tableLo[0] = 0;
+  tableHi[8] = vh;
+  tableLo[8] = vl;
+  for (int i = 4; i > 0; i >>= 1) {
+    const uint64_t carry = (vl & 1u) * 0xe100000000000000ULL;
+    vl = (vh << 63u) | (vl >> 1u);
+    vh = (vh >> 1u) ^ carry;
+    tableHi[i] = vh;
+    tableLo[i] = vl;
+  }
+  for (int i = 2; i <= 8; i *= 2) {
+    for (int j = 1; j < i; j++) {
+      tableHi[i + j] = tableHi[i] ^ tableHi[j];
+      tableLo[i + j] = tableLo[i] ^ tableLo[j];
+    }
+  }
+}
+
+void GhashBlocks(uint8_t x[], const uint8_t data[], size_t blocks, const uint64_t tableHi[16],
+                 const uint64_t tableLo[16]) {
+  for (; blocks > 0; blocks--, data += 16) {
+    uint8_t y[16];
+    for (int i = 0; i < 16; i++) {
+      y[i] = x[i] ^ data[i];
+    }
+
+    uint64_t zh = tableHi[y[15] & 0xfu];
+    uint64_t zl = tableLo[y[15] & 0xfu];
+    for (int i = 15; i >= 0; i--) {
+      const unsigned lo = y[i] & 0xfu;
+      const unsigned hi = y[i] >> 4u;
+      uint64_t rem;
+
+      if (i != 15) {
+        rem = zl & 0xfu;
+        zl = (zh << 60u) | (zl >> 4u);
+        zh = (zh >> 4u) ^ (kLast4[rem] << 48u) ^ tableHi[lo];
+        zl ^= tableLo[lo];
+      }
+      rem = zl & 0xfu;
+      zl = (zh << 60u) | (zl >> 4u);
+      zh = (zh >> 4u) ^ (kLast4[rem] << 48u) ^ tableHi[hi];
+      zl ^= tableLo[hi];
+    }
+
+    StoreBigEndian64(zh, x);
+    StoreBigEndian64(zl, x + 8);
+  }
+}
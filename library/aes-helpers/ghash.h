@@ -0,0 +1,13 @@
+#ifndef AES_KALYNA_LIBRARY_AES_HELPERS_GHASH_H_
+#define AES_KALYNA_LIBRARY_AES_HELPERS_GHASH_H_
+
+#include <cstdint>
+#include <cstdio>
+
+// multiples of H by every 4-bit value, tableHi and tableLo are the halves of the 128-bit field elements
+void GhashInit(const uint8_t h[], uint64_t tableHi[16], uint64_t tableLo[16]);
+
+// x = (x ^ data_i) * H for each of the blocks, four bits of x at a time
+void GhashBlocks(uint8_t x[], const uint8_t data[], size_t blocks, const uint64_t tableHi[16], const uint64_t tableLo[16]);
+
+#endif //AES_KALYNA_LIBRARY_AES_HELPERS_GHASH_H_
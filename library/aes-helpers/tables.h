@@ -6,4 +6,7 @@
 extern const uint8_t sbox[16][16];
 extern const uint8_t inv_sbox[16][16];
 
+extern const uint32_t t_enc[4][256];
+extern const uint32_t t_dec[4][256];
+
 #endif //AES_KALYNA_LIBRARY_AES_HELPERS_TABLES_H_
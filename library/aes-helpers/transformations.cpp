@@ -8,6 +8,18 @@ uint8_t *IncrementCtr(uint8_t in[], uint32_t len){
   return in;
 }
 
+uint8_t *AddCtr(uint8_t in[], uint64_t n) {
+  uint64_t counter = 0;
+  for (int i = 0; i < 8; i++) {
+    counter = (counter << 8u) | in[i];
+  }
+  counter += n;
+  for (int i = 7; i >= 0; i--, counter >>= 8u) {
+    in[i] = (uint8_t) counter;
+  }
+  return in;
+}
+
 uint8_t *PaddingNulls(uint8_t in[], uint32_t inLen, uint32_t alignLen) {
   auto *alignIn = new uint8_t[alignLen];
   memcpy(alignIn, in, inLen);
@@ -47,7 +59,7 @@ void MixSingleColumn(uint8_t *r) {
 }
 
 void MixColumns(uint8_t **state) {
-  auto *temp = new uint8_t[4];
+  uint8_t temp[4];
 
   for (int i = 0; i < 4; ++i) {
     for (int j = 0; j < 4; ++j) {
@@ -58,7 +70,6 @@ void MixColumns(uint8_t **state) {
       state[j][i] = temp[j];
     }
   }
-  delete[] temp;
 }
 
 void SubWord(uint8_t *a) {
@@ -114,8 +125,17 @@ uint8_t MulBytes(uint8_t a, uint8_t b) {
   return p;
 }
 
-void XorBlocks(const uint8_t *a, const uint8_t *b, uint8_t *c, uint32_t len) {
-  for (uint32_t i = 0; i < len; i++) {
+void XorBlocks(const uint8_t *a, const uint8_t *b, uint8_t *c, size_t len) {
+  size_t i = 0;
+  // eight bytes at a time, memcpy keeps unaligned buffers legal
+  for (; i + sizeof(uint64_t) <= len; i += sizeof(uint64_t)) {
+    uint64_t x, y;
+    memcpy(&x, a + i, sizeof(x));
+    memcpy(&y, b + i, sizeof(y));
+    x ^= y;
+    memcpy(c + i, &x, sizeof(x));
+  }
+  for (; i < len; i++) {
     c[i] = a[i] ^ b[i];
   }
 }
@@ -193,6 +213,16 @@ void InvMixColumns(uint8_t **state, size_t words_in_block) {
   }
 }
 
+void InvMixSingleColumn(uint8_t *r) {
+  uint8_t s[4];
+  memcpy(s, r, 4);
+
+  r[0] = (unsigned) MulBytes(0x0e, s[0]) ^ MulBytes(0x0b, s[1]) ^ MulBytes(0x0d, s[2]) ^ MulBytes(0x09, s[3]);
+  r[1] = (unsigned) MulBytes(0x09, s[0]) ^ MulBytes(0x0e, s[1]) ^ MulBytes(0x0b, s[2]) ^ MulBytes(0x0d, s[3]);
+  r[2] = (unsigned) MulBytes(0x0d, s[0]) ^ MulBytes(0x09, s[1]) ^ MulBytes(0x0e, s[2]) ^ MulBytes(0x0b, s[3]);
+  r[3] = (unsigned) MulBytes(0x0b, s[0]) ^ MulBytes(0x0d, s[1]) ^ MulBytes(0x09, s[2]) ^ MulBytes(0x0e, s[3]);
+}
+
 void InvShiftRows(uint8_t **state, size_t words_in_block) {
   ShiftRow(state, 1, words_in_block - 1, words_in_block);
   ShiftRow(state, 2, words_in_block - 2, words_in_block);
@@ -15,6 +15,9 @@ uint8_t *PaddingNulls(uint8_t in[], uint32_t inLen, uint32_t alignLen);
 
 uint8_t *IncrementCtr(uint8_t in[], uint32_t len);
 
+// add n to the 64-bit big endian counter in[0..8), wrapping like IncrementCtr
+uint8_t *AddCtr(uint8_t in[], uint64_t n);
+
 void MixColumns(uint8_t **state);
 
 void MixSingleColumn(uint8_t *r);
@@ -27,7 +30,7 @@ void XorWords(const uint8_t *a, const uint8_t *b, uint8_t *c);
 
 void Rcon(uint8_t *a, size_t n);
 
-void XorBlocks(const uint8_t *a, const uint8_t *b, uint8_t *c, uint32_t len);
+void XorBlocks(const uint8_t *a, const uint8_t *b, uint8_t *c, size_t len);
 
 void SubBytes(uint8_t **state, size_t words_in_blocks);
 
@@ -42,6 +45,8 @@ void InvSubBytes(uint8_t **state, size_t words_in_block);
 
 void InvMixColumns(uint8_t **state, size_t words_in_block);
 
+void InvMixSingleColumn(uint8_t *r);
+
 void InvShiftRows(uint8_t **state, size_t words_in_block);
 
 #endif //AES_KALYNA_LIBRARY_AES_HELPERS_TRANSFORMATIONS_H_
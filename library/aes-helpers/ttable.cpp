@@ -0,0 +1,185 @@
+#include "tables.h"
+#include "ttable.h"
+
+#include <cstring>
+
+uint32_t LoadColumn(const uint8_t *p) {
+  return ((uint32_t) p[0] << 24u) | ((uint32_t) p[1] << 16u) | ((uint32_t) p[2] << 8u) | (uint32_t) p[3];
+}
+
+void StoreColumn(uint32_t w, uint8_t *p) {
+  p[0] = (uint8_t) (w >> 24u);
+  p[1] = (uint8_t) (w >> 16u);
+  p[2] = (uint8_t) (w >> 8u);
+  p[3] = (uint8_t) w;
+}
+
+void TTableEncryptBlock(const uint8_t in[], uint8_t out[], const uint8_t *roundKeys, size_t rounds) {
+  const uint8_t *s_box = &sbox[0][0];
+
+  uint32_t s0 = LoadColumn(in) ^ LoadColumn(roundKeys);
+  uint32_t s1 = LoadColumn(in + 4) ^ LoadColumn(roundKeys + 4);
+  uint32_t s2 = LoadColumn(in + 8) ^ LoadColumn(roundKeys + 8);
+  uint32_t s3 = LoadColumn(in + 12) ^ LoadColumn(roundKeys + 12);
+
+  // SubBytes, ShiftRows and MixColumns of a column are four lookups
+  for (size_t round = 1; round < rounds; round++) {
+    const uint8_t *rk = roundKeys + 16 * round;
+    const uint32_t t0 = t_enc[0][s0 >> 24u] ^ t_enc[1][(s1 >> 16u) & 0xffu] ^ t_enc[2][(s2 >> 8u) & 0xffu]
+        ^ t_enc[3][s3 & 0xffu] ^ LoadColumn(rk);
+    const uint32_t t1 = t_enc[0][s1 >> 24u] ^ t_enc[1][(s2 >> 16u) & 0xffu] ^ t_enc[2][(s3 >> 8u) & 0xffu]
+        ^ t_enc[3][s0 & 0xffu] ^ LoadColumn(rk + 4);
+    const uint32_t t2 = t_enc[0][s2 >> 24u] ^ t_enc[1][(s3 >> 16u) & 0xffu] ^ t_enc[2][(s0 >> 8u) & 0xffu]
+        ^ t_enc[3][s1 & 0xffu] ^ LoadColumn(rk + 8);
+    const uint32_t t3 = t_enc[0][s3 >> 24u] ^ t_enc[1][(s0 >> 16u) & 0xffu] ^ t_enc[2][(s1 >> 8u) & 0xffu]
+        ^ t_enc[3][s2 & 0xffu] ^ LoadColumn(rk + 12);
+    s0 = t0;
+    s1 = t1;
+    s2 = t2;
+    s3 = t3;
+  }
+
+  // last round has no MixColumns
+  const uint8_t *rk = roundKeys + 16 * rounds;
+  const uint32_t t0 = ((uint32_t) s_box[s0 >> 24u] << 24u) ^ ((uint32_t) s_box[(s1 >> 16u) & 0xffu] << 16u)
+      ^ ((uint32_t) s_box[(s2 >> 8u) & 0xffu] << 8u) ^ (uint32_t) s_box[s3 & 0xffu];
+  const uint32_t t1 = ((uint32_t) s_box[s1 >> 24u] << 24u) ^ ((uint32_t) s_box[(s2 >> 16u) & 0xffu] << 16u)
+      ^ ((uint32_t) s_box[(s3 >> 8u) & 0xffu] << 8u) ^ (uint32_t) s_box[s0 & 0xffu];
+  const uint32_t t2 = ((uint32_t) s_box[s2 >> 24u] << 24u) ^ ((uint32_t) s_box[(s3 >> 16u) & 0xffu] << 16u)
+      ^ ((uint32_t) s_box[(s0 >> 8u) & 0xffu] << 8u) ^ (uint32_t) s_box[s1 & 0xffu];
+  const uint32_t t3 = ((uint32_t) s_box[s3 >> 24u] << 24u) ^ ((uint32_t) s_box[(s0 >> 16u) & 0xffu] << 16u)
+      ^ ((uint32_t) s_box[(s1 >> 8u) & 0xffu] << 8u) ^ (uint32_t) s_box[s2 & 0xffu];
+
+  StoreColumn(t0 ^ LoadColumn(rk), out);
+  StoreColumn(t1 ^ LoadColumn(rk + 4), out + 4);
+  StoreColumn(t2 ^ LoadColumn(rk + 8), out + 8);
+  StoreColumn(t3 ^ LoadColumn(rk + 12), out + 12);
+}
+
+void TTableDecryptBlock(const uint8_t in[], uint8_t out[], const uint8_t *roundKeys, size_t rounds) {
+  const uint8_t *inv_s_box = &inv_sbox[0][0];
+
+  uint32_t s0 = LoadColumn(in) ^ LoadColumn(roundKeys);
+  uint32_t s1 = LoadColumn(in + 4) ^ LoadColumn(roundKeys + 4);
+  uint32_t s2 = LoadColumn(in + 8) ^ LoadColumn(roundKeys + 8);
+  uint32_t s3 = LoadColumn(in + 12) ^ LoadColumn(roundKeys + 12);
+
+  // InvSubBytes, InvShiftRows and InvMixColumns of a column are four lookups,
+  // round keys already went through InvMixColumns
+  for (size_t round = 1; round < rounds; round++) {
+    const uint8_t *rk = roundKeys + 16 * round;
+    const uint32_t t0 = t_dec[0][s0 >> 24u] ^ t_dec[1][(s3 >> 16u) & 0xffu] ^ t_dec[2][(s2 >> 8u) & 0xffu]
+        ^ t_dec[3][s1 & 0xffu] ^ LoadColumn(rk);
+    const uint32_t t1 = t_dec[0][s1 >> 24u] ^ t_dec[1][(s0 >> 16u) & 0xffu] ^ t_dec[2][(s3 >> 8u) & 0xffu]
+        ^ t_dec[3][s2 & 0xffu] ^ LoadColumn(rk + 4);
+    const uint32_t t2 = t_dec[0][s2 >> 24u] ^ t_dec[1][(s1 >> 16u) & 0xffu] ^ t_dec[2][(s0 >> 8u) & 0xffu]
+        ^ t_dec[3][s3 & 0xffu] ^ LoadColumn(rk + 8);
+    const uint32_t t3 = t_dec[0][s3 >> 24u] ^ t_dec[1][(s2 >> 16u) & 0xffu] ^ t_dec[2][(s1 >> 8u) & 0xffu]
+        ^ t_dec[3][s0 & 0xffu] ^ LoadColumn(rk + 12);
+    s0 = t0;
+    s1 = t1;
+    s2 = t2;
+    s3 = t3;
+  }
+
+  // last round has no InvMixColumns
+  const uint8_t *rk = roundKeys + 16 * rounds;
+  const uint32_t t0 = ((uint32_t) inv_s_box[s0 >> 24u] << 24u) ^ ((uint32_t) inv_s_box[(s3 >> 16u) & 0xffu] << 16u)
+      ^ ((uint32_t) inv_s_box[(s2 >> 8u) & 0xffu] << 8u) ^ (uint32_t) inv_s_box[s1 & 0xffu];
+  const uint32_t t1 = ((uint32_t) inv_s_box[s1 >> 24u] << 24u) ^ ((uint32_t) inv_s_box[(s0 >> 16u) & 0xffu] << 16u)
+      ^ ((uint32_t) inv_s_box[(s3 >> 8u) & 0xffu] << 8u) ^ (uint32_t) inv_s_box[s2 & 0xffu];
+  const uint32_t t2 = ((uint32_t) inv_s_box[s2 >> 24u] << 24u) ^ ((uint32_t) inv_s_box[(s1 >> 16u) & 0xffu] << 16u)
+      ^ ((uint32_t) inv_s_box[(s0 >> 8u) & 0xffu] << 8u) ^ (uint32_t) inv_s_box[s3 & 0xffu];
+  const uint32_t t3 = ((uint32_t) inv_s_box[s3 >> 24u] << 24u) ^ ((uint32_t) inv_s_box[(s2 >> 16u) & 0xffu] << 16u)
+      ^ ((uint32_t) inv_s_box[(s1 >> 8u) & 0xffu] << 8u) ^ (uint32_t) inv_s_box[s0 & 0xffu];
+
+  StoreColumn(t0 ^ LoadColumn(rk), out);
+  StoreColumn(t1 ^ LoadColumn(rk + 4), out + 4);
+  StoreColumn(t2 ^ LoadColumn(rk + 8), out + 8);
+  StoreColumn(t3 ^ LoadColumn(rk + 12), out + 12);
+}
+
+// number of blocks processed together by the multi-block functions
+static const size_t kLanes = 4;
+
+void TTableEncryptBlocks(const uint8_t in[], uint8_t out[], size_t blocks, const uint8_t *roundKeys, size_t rounds) {
+  const uint8_t *s_box = &sbox[0][0];
+
+  for (; blocks >= kLanes; blocks -= kLanes, in += 16 * kLanes, out += 16 * kLanes) {
+    uint32_t s[kLanes][4], t[kLanes][4];
+
+    for (size_t lane = 0; lane < kLanes; lane++) {
+      for (size_t c = 0; c < 4; c++) {
+        s[lane][c] = LoadColumn(in + 16 * lane + 4 * c) ^ LoadColumn(roundKeys + 4 * c);
+      }
+    }
+
+    for (size_t round = 1; round < rounds; round++) {
+      const uint8_t *rk = roundKeys + 16 * round;
+      const uint32_t k[4] = {LoadColumn(rk), LoadColumn(rk + 4), LoadColumn(rk + 8), LoadColumn(rk + 12)};
+      for (size_t lane = 0; lane < kLanes; lane++) {
+        for (size_t c = 0; c < 4; c++) {
+          t[lane][c] = t_enc[0][s[lane][c] >> 24u] ^ t_enc[1][(s[lane][(c + 1) % 4] >> 16u) & 0xffu]
+              ^ t_enc[2][(s[lane][(c + 2) % 4] >> 8u) & 0xffu] ^ t_enc[3][s[lane][(c + 3) % 4] & 0xffu] ^ k[c];
+        }
+      }
+      memcpy(s, t, sizeof(s));
+    }
+
+    const uint8_t *rk = roundKeys + 16 * rounds;
+    for (size_t lane = 0; lane < kLanes; lane++) {
+      for (size_t c = 0; c < 4; c++) {
+        const uint32_t w = ((uint32_t) s_box[s[lane][c] >> 24u] << 24u)
+            ^ ((uint32_t) s_box[(s[lane][(c + 1) % 4] >> 16u) & 0xffu] << 16u)
+            ^ ((uint32_t) s_box[(s[lane][(c + 2) % 4] >> 8u) & 0xffu] << 8u)
+            ^ (uint32_t) s_box[s[lane][(c + 3) % 4] & 0xffu];
+        StoreColumn(w ^ LoadColumn(rk + 4 * c), out + 16 * lane + 4 * c);
+      }
+    }
+  }
+
+  for (; blocks > 0; blocks--, in += 16, out += 16) {
+    TTableEncryptBlock(in, out, roundKeys, rounds);
+  }
+}
+
+void TTableDecryptBlocks(const uint8_t in[], uint8_t out[], size_t blocks, const uint8_t *roundKeys, size_t rounds) {
+  const uint8_t *inv_s_box = &inv_sbox[0][0];
+
+  for (; blocks >= kLanes; blocks -= kLanes, in += 16 * kLanes, out += 16 * kLanes) {
+    uint32_t s[kLanes][4], t[kLanes][4];
+
+    for (size_t lane = 0; lane < kLanes; lane++) {
+      for (size_t c = 0; c < 4; c++) {
+        s[lane][c] = LoadColumn(in + 16 * lane + 4 * c) ^ LoadColumn(roundKeys + 4 * c);
+      }
+    }
+
+    for (size_t round = 1; round < rounds; round++) {
+      const uint8_t *rk = roundKeys + 16 * round;
+      const uint32_t k[4] = {LoadColumn(rk), LoadColumn(rk + 4), LoadColumn(rk + 8), LoadColumn(rk + 12)};
+      for (size_t lane = 0; lane < kLanes; lane++) {
+        for (size_t c = 0; c < 4; c++) {
+          t[lane][c] = t_dec[0][s[lane][c] >> 24u] ^ t_dec[1][(s[lane][(c + 3) % 4] >> 16u) & 0xffu]
+              ^ t_dec[2][(s[lane][(c + 2) % 4] >> 8u) & 0xffu] ^ t_dec[3][s[lane][(c + 1) % 4] & 0xffu] ^ k[c];
+        }
+      }
+      memcpy(s, t, sizeof(s));
+    }
+
+    const uint8_t *rk = roundKeys + 16 * rounds;
+    for (size_t lane = 0; lane < kLanes; lane++) {
+      for (size_t c = 0; c < 4; c++) {
+        const uint32_t w = ((uint32_t) inv_s_box[s[lane][c] >> 24u] << 24u)
+            ^ ((uint32_t) inv_s_box[(s[lane][(c + 3) % 4] >> 16u) & 0xffu] << 16u)
+            ^ ((uint32_t) inv_s_box[(s[lane][(c + 2) % 4] >> 8u) & 0xffu] << 8u)
+            ^ (uint32_t) inv_s_box[s[lane][(c + 1) % 4] & 0xffu];
+        StoreColumn(w ^ LoadColumn(rk + 4 * c), out + 16 * lane + 4 * c);
+      }
+    }
+  }
+
+  for (; blocks > 0; blocks--, in += 16, out += 16) {
+    TTableDecryptBlock(in, out, roundKeys, rounds);
+  }
+}
@@ -0,0 +1,24 @@
+#ifndef AES_KALYNA_LIBRARY_AES_HELPERS_TTABLE_H_
+#define AES_KALYNA_LIBRARY_AES_HELPERS_TTABLE_H_
+
+#include <cstdint>
+#include <cstdio>
+
+// load/store 32-bit column in big endian order (row 0 in the high byte)
+uint32_t LoadColumn(const uint8_t *p);
+
+void StoreColumn(uint32_t w, uint8_t *p);
+
+// encrypt one block with 32-bit lookup tables, roundKeys is the KeyExpansion output
+void TTableEncryptBlock(const uint8_t in[], uint8_t out[], const uint8_t *roundKeys, size_t rounds);
+
+// decrypt one block with 32-bit lookup tables, roundKeys is the InvKeyExpansion output
+void TTableDecryptBlock(const uint8_t in[], uint8_t out[], const uint8_t *roundKeys, size_t rounds);
+
+// encrypt consecutive blocks, four of them are interleaved to hide lookup latency
+void TTableEncryptBlocks(const uint8_t in[], uint8_t out[], size_t blocks, const uint8_t *roundKeys, size_t rounds);
+
+// decrypt consecutive blocks, four of them are interleaved to hide lookup latency
+void TTableDecryptBlocks(const uint8_t in[], uint8_t out[], size_t blocks, const uint8_t *roundKeys, size_t rounds);
+
+#endif //AES_KALYNA_LIBRARY_AES_HELPERS_TTABLE_H_
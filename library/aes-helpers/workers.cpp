@@ -0,0 +1,73 @@
+#include "workers.h"
+
+WorkerPool::WorkerPool(size_t workers) {
+  for (size_t i = 0; i < workers; i++) {
+    threads.emplace_back(&WorkerPool::Loop, this);
+  }
+}
+
+WorkerPool::~WorkerPool() {
+  {
+    std::lock_guard<std::mutex> lock(mutex);
+    stop = true;
+  }
+  wake.notify_all();
+  for (auto &thread : threads) {
+    thread.join();
+  }
+}
+
+size_t WorkerPool::Workers() const {
+  return threads.size();
+}
+
+WorkerPool &WorkerPool::Shared() {
+  static WorkerPool pool(std::thread::hardware_concurrency() > 1 ? std::thread::hardware_concurrency() - 1 : 0);
+  return pool;
+}
+
+void WorkerPool::RunTasks(size_t count, TaskFunction task, const void *taskContext) {
+  std::unique_lock<std::mutex> job(busy, std::try_to_lock);
+  if (!job.owns_lock() || threads.empty()) {
+    for (size_t i = 0; i < count; i++) {
+      task(taskContext, i);
+    }
+    return;
+  }
+
+  std::unique_lock<std::mutex> lock(mutex);
+  function = task;
+  context = taskContext;
+  tasks = count;
+  next = 0;
+  finished = 0;
+  wake.notify_all();
+
+  Drain(lock);
+  done.wait(lock, [this] { return finished == tasks; });
+  function = nullptr;
+  context = nullptr;
+}
+
+void WorkerPool::Drain(std::unique_lock<std::mutex> &lock) {
+  while (next < tasks) {
+    const size_t index = next++;
+    lock.unlock();
+    function(context, index);
+    lock.lock();
+    if (++finished == tasks) {
+      done.notify_all();
+    }
+  }
+}
+
+void WorkerPool::Loop() {
+  std::unique_lock<std::mutex> lock(mutex);
+  while (true) {
+    wake.wait(lock, [this] { return stop || next < tasks; });
+    if (stop) {
+      return;
+    }
+    Drain(lock);
+  }
+}
@@ -0,0 +1,74 @@
+#ifndef AES_KALYNA_LIBRARY_AES_HELPERS_WORKERS_H_
+#define AES_KALYNA_LIBRARY_AES_HELPERS_WORKERS_H_
+
+#include <condition_variable>
+#include <cstdint>
+#include <cstdio>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+// Fixed set of threads that run numbered tasks of one job at a time.
+// Nothing is allocated per job, the task is passed by reference.
+class WorkerPool {
+ public:
+  explicit WorkerPool(size_t workers);
+
+  ~WorkerPool();
+
+  WorkerPool(const WorkerPool &) = delete;
+
+  WorkerPool &operator=(const WorkerPool &) = delete;
+
+  // Runs task(0) .. task(tasks - 1) and returns once all of them finished. The calling
+  // thread takes tasks too. When another job is in progress everything runs on the caller.
+  template<typename Task>
+  void Run(size_t tasks, const Task &task) {
+    RunTasks(tasks, [](const void *context, size_t index) { (*(const Task *) context)(index); }, &task);
+  }
+
+  size_t Workers() const;
+
+  // one worker less than the hardware threads, the caller is the last one
+  static WorkerPool &Shared();
+
+ private:
+  using TaskFunction = void (*)(const void *context, size_t index);
+
+  void RunTasks(size_t tasks, TaskFunction function, const void *context);
+
+  // take and run tasks of the current job until none are left, lock is held on entry and exit
+  void Drain(std::unique_lock<std::mutex> &lock);
+
+  void Loop();
+
+  std::vector<std::thread> threads;
+
+  std::mutex busy;
+  std::mutex mutex;
+  std::condition_variable wake;
+  std::condition_variable done;
+
+  TaskFunction function = nullptr;
+  const void *context = nullptr;
+  size_t tasks = 0;
+  size_t next = 0;
+  size_t finished = 0;
+  bool stop = false;
+};
+
+// calls range(first, count, part) for parts contiguous ranges covering items,
+// on pool when there is more than one
+template<typename Range>
+void ForEachRange(WorkerPool &pool, size_t items, size_t parts, const Range &range) {
+  if (parts <= 1) {
+    range(0, items, 0);
+    return;
+  }
+  pool.Run(parts, [&](size_t part) {
+    const size_t first = items * part / parts;
+    range(first, items * (part + 1) / parts - first, part);
+  });
+}
+
+#endif //AES_KALYNA_LIBRARY_AES_HELPERS_WORKERS_H_
@@ -4,9 +4,122 @@
 #include <cstdint>
 #include <cstdio>
 
+// implementation used for the single block transformations
+enum class AESBackend {
+  // byte matrix state, straight from the specification
+  kReference,
+  // 32-bit lookup tables, four lookups per column and round
+  kTTable,
+  // AESENC/AESDEC instructions, requires a CPU with AES-NI
+  kAesNi,
+  // AES-NI when CPUID reports it, lookup tables otherwise
+  kAuto
+};
+
+class WorkerPool;
+
+// Expanded encryption and decryption round keys. Built once by AES::ExpandKey,
+// never modified afterwards, so one instance can be shared between threads.
+class AesKey {
+ public:
+  // number of rounds the schedule was expanded for
+  size_t Rounds() const;
+
+ private:
+  friend class AES;
+  friend class AesGcm;
+  friend class AesModes;
+  friend class AesStream;
+  friend class AesXts;
+
+  explicit AesKey(size_t rounds);
+
+  // room for the 15 round keys of AES-256
+  static const size_t kMaxRoundKeysLen = 240;
+
+  alignas(16) uint8_t encKeys[kMaxRoundKeysLen];
+  // equivalent inverse cipher keys in decryption order
+  alignas(16) uint8_t decKeys[kMaxRoundKeysLen];
+
+  size_t rounds;
+};
+
 class AES {
  public:
-  explicit AES(int keyLen = 256);
+  explicit AES(int keyLen = 256, AESBackend backend = AESBackend::kAuto);
+
+  // backend in use, never kAuto
+  AESBackend Backend() const;
+
+  // smallest buffer split across threads unless SetParallelism says otherwise
+  static const size_t kDefaultParallelBytes = 1u << 20u;
+
+  // ECB, CTR and the CBC/CFB decryption of buffers of at least minBytes are split into one
+  // contiguous range of blocks per thread; the output is the same as with threads = 1,
+  // which keeps every call on the calling thread. Defaults to the hardware thread count.
+  void SetParallelism(size_t threads, size_t minBytes = kDefaultParallelBytes);
+
+  size_t Threads() const;
+
+  // Runs the split calls on pool instead of the shared one, which has one worker less than
+  // the hardware threads. The pool must outlive the calls, nullptr goes back to the shared one.
+  void SetWorkerPool(WorkerPool *pool);
+
+  // run the key schedule once, the result can be passed to every mode
+  AesKey ExpandKey(const uint8_t key[]) const;
+
+  // Caller-buffer API: out must hold len bytes and may be the same buffer as in,
+  // nothing is allocated. ECB and CBC need len to be a multiple of the block size,
+  // CFB, OFB and CTR take any length.
+
+  void EncryptECB(const uint8_t in[], uint8_t out[], size_t len, const AesKey &key) const;
+
+  void DecryptECB(const uint8_t in[], uint8_t out[], size_t len, const AesKey &key) const;
+
+  void EncryptCBC(const uint8_t in[], uint8_t out[], size_t len, const AesKey &key, const uint8_t iv[]) const;
+
+  void DecryptCBC(const uint8_t in[], uint8_t out[], size_t len, const AesKey &key, const uint8_t iv[]) const;
+
+  // s is the number of ciphertext bytes shifted into the feedback register per block
+  void EncryptCFB(const uint8_t in[], uint8_t out[], size_t len, uint32_t s, const AesKey &key,
+                  const uint8_t iv[]) const;
+
+  void DecryptCFB(const uint8_t in[], uint8_t out[], size_t len, uint32_t s, const AesKey &key,
+                  const uint8_t iv[]) const;
+
+  void EncryptOFB(const uint8_t in[], uint8_t out[], size_t len, const AesKey &key, const uint8_t iv[]) const;
+
+  void DecryptOFB(const uint8_t in[], uint8_t out[], size_t len, const AesKey &key, const uint8_t iv[]) const;
+
+  // counter is the first counter block: 8 bytes of nonce and a 64-bit big endian block counter.
+  // in[0] is the byte at position offset of the stream, so any range can be processed on its own.
+  void EncryptCTR(const uint8_t in[], uint8_t out[], size_t len, const AesKey &key, const uint8_t counter[],
+                  uint64_t offset = 0) const;
+
+  void DecryptCTR(const uint8_t in[], uint8_t out[], size_t len, const AesKey &key, const uint8_t counter[],
+                  uint64_t offset = 0) const;
+
+  // Allocating API: returns a new[] buffer, encryption pads the input with zeros to whole blocks.
+
+  uint8_t *EncryptECB(uint8_t in[], uint32_t inLen, const AesKey &key, uint32_t &outLen);
+
+  uint8_t *DecryptECB(uint8_t in[], uint32_t inLen, const AesKey &key);
+
+  uint8_t *EncryptCBC(uint8_t in[], uint32_t inLen, const AesKey &key, uint8_t *iv, uint32_t &outLen);
+
+  uint8_t *DecryptCBC(uint8_t in[], uint32_t inLen, const AesKey &key, uint8_t *iv);
+
+  uint8_t *EncryptCFB(uint8_t in[], uint32_t s, uint32_t inLen, const AesKey &key, uint8_t *iv, uint32_t &outLen);
+
+  uint8_t *DecryptCFB(uint8_t in[], uint32_t s, uint32_t inLen, const AesKey &key, uint8_t *iv);
+
+  uint8_t *EncryptOFB(uint8_t in[], uint32_t inLen, const AesKey &key, uint8_t *iv, uint32_t &outLen);
+
+  uint8_t *DecryptOFB(uint8_t in[], uint32_t inLen, const AesKey &key, uint8_t *iv);
+
+  uint8_t *EncryptCTR(uint8_t in[], uint32_t inLen, const AesKey &key, uint32_t &outLen);
+
+  uint8_t *DecryptCTR(uint8_t in[], uint32_t inLen, const AesKey &key);
 
   uint8_t *EncryptECB(uint8_t in[], uint32_t inLen, uint8_t key[], uint32_t &outLen);
 
@@ -29,17 +142,45 @@ class AES {
   uint8_t *DecryptCTR(uint8_t in[], uint32_t inLen, uint8_t key[]);
 
  private:
+  friend class AesGcm;
+  friend class AesModes;
+  friend class AesStream;
+  friend class AesXts;
+
+  // throws if the key was expanded for another key length
+  void CheckKey(const AesKey &key) const;
+
+  // number of ranges a call on blocks blocks is split into, 1 keeps it on the calling thread
+  size_t Parts(size_t blocks) const;
+
+  // pool the parts run on
+  WorkerPool &Pool() const;
+
   void KeyExpansion(const uint8_t key[], uint8_t w[]) const;
 
+  // round keys of the equivalent inverse cipher in decryption order, used by DecryptBlock
+  void InvKeyExpansion(const uint8_t w[], uint8_t dw[]) const;
+
   void EncryptBlock(const uint8_t in[], uint8_t out[], const uint8_t key[]) const;
 
   void DecryptBlock(const uint8_t in[], uint8_t out[], const uint8_t key[]) const;
 
+  // independent consecutive blocks, interleaved by the backend
+  void EncryptBlocks(const uint8_t in[], uint8_t out[], size_t blocks, const uint8_t key[]) const;
+
+  void DecryptBlocks(const uint8_t in[], uint8_t out[], size_t blocks, const uint8_t key[]) const;
+
  private:
   const size_t Nb = 4;
   const size_t blockBytesLen = 4 * Nb * sizeof(uint8_t);
 
   size_t Nk, Nr;
+
+  AESBackend backend;
+
+  size_t threads;
+  size_t parallelBytes;
+  WorkerPool *pool;
 };
 
 #endif //AES_KALYNA_LIBRARY_INCLUDE_AES_H_
@@ -0,0 +1,85 @@
+#ifndef AES_KALYNA_LIBRARY_INCLUDE_AES_GCM_H_
+#define AES_KALYNA_LIBRARY_INCLUDE_AES_GCM_H_
+
+#include <cstdint>
+#include <cstdio>
+
+#include "aes.h"
+
+// implementation of the GHASH multiplication by H
+enum class GhashBackend {
+  // 4-bit tables, 256 bytes per key; the lookups depend on the data
+  kTable,
+  // PCLMULQDQ, stitched with the AES-NI rounds when AES runs on AES-NI
+  kClmul,
+  // PCLMULQDQ when CPUID reports it, tables otherwise
+  kAuto
+};
+
+// Galois/Counter Mode (NIST SP 800-38D) for one message at a time: Init, any number of
+// UpdateAad calls, any number of Update calls, then Final or Verify. Like AesStream the
+// context keeps only a few blocks of state, whatever the message length is.
+class AesGcm {
+ public:
+  // aes and key are copied
+  AesGcm(const AES &aes, const AesKey &key, bool encrypt, GhashBackend ghash = GhashBackend::kAuto);
+
+  // any IV length is accepted, 12 bytes is the fast and recommended one
+  void Init(const uint8_t iv[], size_t ivLen);
+
+  // additional authenticated data, all of it has to come before the first Update
+  void UpdateAad(const uint8_t aad[], size_t len);
+
+  // writes exactly len bytes, out may be the same buffer as in
+  void Update(const uint8_t in[], uint8_t out[], size_t len);
+
+  // authentication tag of the message, tagLen from 4 to 16 bytes
+  void Final(uint8_t tag[], size_t tagLen = 16);
+
+  // compares the tag in constant time; decrypted data must not be used when it returns false
+  bool Verify(const uint8_t tag[], size_t tagLen = 16);
+
+  GhashBackend Backend() const;
+
+ private:
+  // feeds whole blocks to the GHASH backend
+  void Hash(const uint8_t data[], size_t blocks);
+
+  // hashes the zero padded AAD tail once the data starts
+  void FinishAad();
+
+  // xor up to len bytes with the unused part of the current keystream block
+  size_t XorKeystream(const uint8_t in[], uint8_t out[], size_t len);
+
+  AES aes;
+  AesKey key;
+  bool encrypt;
+  GhashBackend ghash;
+  // AES-NI rounds and GHASH run in the same loop
+  bool stitched;
+
+  // 4-bit multiples of H for kTable, H to H^4 for kClmul
+  uint64_t tableHi[16];
+  uint64_t tableLo[16];
+  alignas(16) uint8_t powers[64];
+
+  // E(K, J0), masks the final GHASH value
+  uint8_t tagMask[16];
+  // GHASH accumulator
+  uint8_t x[16];
+  // next counter block, the last 4 bytes are a big endian 32-bit counter
+  uint8_t counter[16];
+  // keystream of the current data block
+  uint8_t keystream[16];
+  // AAD or ciphertext of the current block, hashed once complete
+  uint8_t pending[16];
+  // bytes of pending that are filled
+  size_t used;
+
+  uint64_t aadLength;
+  uint64_t length;
+  bool started;
+  bool dataStarted;
+};
+
+#endif //AES_KALYNA_LIBRARY_INCLUDE_AES_GCM_H_
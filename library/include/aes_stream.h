@@ -0,0 +1,66 @@
+#ifndef AES_KALYNA_LIBRARY_INCLUDE_AES_STREAM_H_
+#define AES_KALYNA_LIBRARY_INCLUDE_AES_STREAM_H_
+
+#include <cstdint>
+#include <cstdio>
+
+#include "aes.h"
+
+enum class AesStreamMode { kCBC, kCFB, kOFB, kCTR };
+
+// Incremental encryption or decryption of one message at a time. The data can arrive
+// in Update calls of any length, the context only keeps one block of state and one
+// block of buffered input or keystream, whatever the total length is.
+class AesStream {
+ public:
+  // aes and key are copied, s is the CFB segment size in bytes and is ignored by other modes
+  AesStream(const AES &aes, const AesKey &key, AesStreamMode mode, bool encrypt, uint32_t s = 16);
+
+  // start a new message, iv is the initial counter block for CTR
+  void Init(const uint8_t iv[]);
+
+  // Returns the number of bytes written to out.
+  // CFB, OFB and CTR write exactly len bytes and out may be the same buffer as in.
+  // CBC only writes whole blocks, out needs room for len + 15 bytes and must not overlap in.
+  size_t Update(const uint8_t in[], uint8_t out[], size_t len);
+
+  // Ends the message and returns the number of bytes written. CBC encryption pads the
+  // buffered tail with zeros and writes the last block, CBC decryption throws if the
+  // ciphertext was not a whole number of blocks. Init must be called before the next message.
+  size_t Final(uint8_t out[]);
+
+  // CTR only: continue at byte offset of the message, counted from the Init counter block
+  void Seek(uint64_t offset);
+
+  // position in the message: bytes passed to Update since Init, plus the last Seek offset
+  uint64_t Length() const;
+
+ private:
+  // xor up to len bytes with the unused part of the current keystream block
+  size_t XorKeystream(const uint8_t in[], uint8_t out[], size_t len);
+
+  // produce the keystream block for the partial block that follows
+  void NextKeystream();
+
+  AES aes;
+  AesKey key;
+  AesStreamMode mode;
+  bool encrypt;
+  uint32_t s;
+
+  // block passed to Init, Seek restarts from it
+  uint8_t iv[16];
+  // CBC chaining value, CFB shift register, OFB keystream block or CTR counter block
+  uint8_t state[16];
+  // CBC input waiting for a whole block, keystream of the current block for the other modes
+  uint8_t buffer[16];
+  // CFB ciphertext of the current block, shifted into the register once the block is complete
+  uint8_t feedback[16];
+  // bytes of buffer that are filled (CBC) or already used (keystream)
+  size_t used;
+
+  uint64_t length;
+  bool started;
+};
+
+#endif //AES_KALYNA_LIBRARY_INCLUDE_AES_STREAM_H_
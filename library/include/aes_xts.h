@@ -0,0 +1,55 @@
+#ifndef AES_KALYNA_LIBRARY_INCLUDE_AES_XTS_H_
+#define AES_KALYNA_LIBRARY_INCLUDE_AES_XTS_H_
+
+#include <cstdint>
+#include <cstdio>
+
+#include "aes.h"
+
+// XTS-AES (IEEE 1619) for storage: every data unit (sector) is encrypted on its own with
+// a 16-byte tweak, lengths that are not whole blocks use ciphertext stealing.
+// Nothing is modified after construction, so one instance can be shared between threads.
+class AesXts {
+ public:
+  // key is the data key followed by the tweak key, twice the key length of aes
+  AesXts(const AES &aes, const uint8_t key[]);
+
+  AesXts(const AES &aes, const AesKey &dataKey, const AesKey &tweakKey);
+
+  // One data unit of at least one block, tweak is usually the little endian sector number.
+  // out may be the same buffer as in.
+  void Encrypt(const uint8_t in[], uint8_t out[], size_t len, const uint8_t tweak[]) const;
+
+  void Decrypt(const uint8_t in[], uint8_t out[], size_t len, const uint8_t tweak[]) const;
+
+  // sectors consecutive data units of sectorLen bytes, unit i uses the tweak firstSector + i
+  // as a 128-bit little endian number, carrying into the upper 8 bytes past 2^64 - 1; large
+  // batches are spread across the AES threads
+  void EncryptSectors(const uint8_t in[], uint8_t out[], size_t sectorLen, size_t sectors,
+                      uint64_t firstSector) const;
+
+  void DecryptSectors(const uint8_t in[], uint8_t out[], size_t sectorLen, size_t sectors,
+                      uint64_t firstSector) const;
+
+  // same, with a caller supplied 16-byte tweak for every sector
+  void EncryptSectors(const uint8_t in[], uint8_t out[], size_t sectorLen, size_t sectors,
+                      const uint8_t tweaks[]) const;
+
+  void DecryptSectors(const uint8_t in[], uint8_t out[], size_t sectorLen, size_t sectors,
+                      const uint8_t tweaks[]) const;
+
+ private:
+  // one data unit, tweak is the plain 16-byte tweak before its encryption with the tweak key
+  void Unit(const uint8_t in[], uint8_t out[], size_t len, const uint8_t tweak[], bool encrypt) const;
+
+  // splits the sectors into ranges for the worker pool, tweakOf(i, tweak) fills the tweak of sector i
+  template<typename TweakOf>
+  void Sectors(const uint8_t in[], uint8_t out[], size_t sectorLen, size_t sectors, const TweakOf &tweakOf,
+               bool encrypt) const;
+
+  AES aes;
+  AesKey dataKey;
+  AesKey tweakKey;
+};
+
+#endif //AES_KALYNA_LIBRARY_INCLUDE_AES_XTS_H_
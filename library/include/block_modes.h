@@ -0,0 +1,305 @@
+#ifndef AES_KALYNA_LIBRARY_INCLUDE_BLOCK_MODES_H_
+#define AES_KALYNA_LIBRARY_INCLUDE_BLOCK_MODES_H_
+
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <stdexcept>
+
+// Modes of operation over byte buffers for any block cipher, shared by AES and Kalyna.
+// Derived is a view of one cipher and one expanded key and provides
+//
+//   void EncryptBlocks(const uint8_t in[], uint8_t out[], size_t blocks) const;
+//   void DecryptBlocks(const uint8_t in[], uint8_t out[], size_t blocks) const;
+//   // first counter of the CTR mode for the block at index block
+//   void CounterStart(const uint8_t iv[], uint64_t block, uint8_t counter[]) const;
+//   static void CounterAdd(uint8_t counter[], uint64_t n);
+//
+// and may shadow EncryptBlock, Parts and ForRanges below. Every call is resolved at compile
+// time and the block size is a constant, so the per-block loops are unrolled for it.
+//
+// out must hold len bytes and may be the same buffer as in, nothing is allocated. ECB and CBC
+// need len to be a multiple of the block size, CFB, OFB and CTR take any length. The chained
+// kernels update their chaining argument in place so a later call continues the stream, the
+// CFB register is only shifted after complete blocks.
+//
+// BlockBytes: block size in bytes.
+// ParallelBytes: bytes handed to EncryptBlocks and DecryptBlocks at once by the modes whose
+// blocks are independent.
+template<typename Derived, size_t BlockBytes, size_t ParallelBytes>
+class BlockModes {
+ public:
+  static constexpr size_t kBlockBytes = BlockBytes;
+  static constexpr size_t kParallelBlocks = ParallelBytes / BlockBytes;
+  // upper bound of the ranges a call is split into, keeps the per-range state on the stack
+  static constexpr size_t kMaxParts = 64;
+
+  static_assert(kParallelBlocks > 0, "ParallelBytes must hold a block");
+
+  // one block, CBC and CFB encryption and OFB chain every block to the one before
+  void EncryptBlock(const uint8_t in[], uint8_t out[]) const {
+    Self().EncryptBlocks(in, out, 1);
+  }
+
+  // number of ranges a call on blocks blocks is split into, 1 keeps it on the calling thread
+  size_t Parts(size_t) const {
+    return 1;
+  }
+
+  // calls range(first, count, part) for parts contiguous ranges covering blocks
+  template<typename Range>
+  void ForRanges(size_t blocks, size_t, const Range &range) const {
+    range(0, blocks, 0);
+  }
+
+  void EncryptECB(const uint8_t in[], uint8_t out[], size_t len) const {
+    CheckBlockLength(len);
+    const size_t blocks = len / BlockBytes;
+    Self().ForRanges(blocks, Self().Parts(blocks), [&](size_t first, size_t count, size_t) {
+      Self().EncryptBlocks(in + first * BlockBytes, out + first * BlockBytes, count);
+    });
+  }
+
+  void DecryptECB(const uint8_t in[], uint8_t out[], size_t len) const {
+    CheckBlockLength(len);
+    const size_t blocks = len / BlockBytes;
+    Self().ForRanges(blocks, Self().Parts(blocks), [&](size_t first, size_t count, size_t) {
+      Self().DecryptBlocks(in + first * BlockBytes, out + first * BlockBytes, count);
+    });
+  }
+
+  void EncryptCBC(const uint8_t in[], uint8_t out[], size_t len, const uint8_t iv[]) const {
+    CheckBlockLength(len);
+    uint8_t chain[BlockBytes];
+    memcpy(chain, iv, BlockBytes);
+    CbcEncrypt(in, out, len / BlockBytes, chain);
+  }
+
+  void DecryptCBC(const uint8_t in[], uint8_t out[], size_t len, const uint8_t iv[]) const {
+    CheckBlockLength(len);
+    uint8_t chain[BlockBytes];
+    memcpy(chain, iv, BlockBytes);
+    CbcDecrypt(in, out, len / BlockBytes, chain);
+  }
+
+  // s is the number of ciphertext bytes shifted into the feedback register per block
+  void EncryptCFB(const uint8_t in[], uint8_t out[], size_t len, uint32_t s, const uint8_t iv[]) const {
+    CheckSegment(s);
+    uint8_t reg[BlockBytes];
+    memcpy(reg, iv, BlockBytes);
+    CfbEncrypt(in, out, len, s, reg);
+  }
+
+  void DecryptCFB(const uint8_t in[], uint8_t out[], size_t len, uint32_t s, const uint8_t iv[]) const {
+    CheckSegment(s);
+    uint8_t reg[BlockBytes];
+    memcpy(reg, iv, BlockBytes);
+    CfbDecrypt(in, out, len, s, reg);
+  }
+
+  void EncryptOFB(const uint8_t in[], uint8_t out[], size_t len, const uint8_t iv[]) const {
+    uint8_t block[BlockBytes];
+    memcpy(block, iv, BlockBytes);
+    OfbXor(in, out, len, block);
+  }
+
+  // in[0] is the byte at position offset of the stream, so any range can be processed on its own
+  void EncryptCTR(const uint8_t in[], uint8_t out[], size_t len, const uint8_t iv[], uint64_t offset) const {
+    // jump straight to the block that holds offset, the keystream before it is never produced
+    uint8_t counter[BlockBytes];
+    Self().CounterStart(iv, offset / BlockBytes, counter);
+
+    const size_t skip = offset % BlockBytes;
+    if (skip > 0 && len > 0) {
+      uint8_t keystream[BlockBytes];
+      Self().EncryptBlock(counter, keystream);
+      Derived::CounterAdd(counter, 1);
+      const size_t chunk = BlockBytes - skip < len ? BlockBytes - skip : len;
+      Xor(in, keystream + skip, out, chunk);
+      in += chunk;
+      out += chunk;
+      len -= chunk;
+    }
+    CtrXor(in, out, len, counter);
+  }
+
+  // xor len bytes with the keystream of counter, which is advanced past the used blocks
+  void CtrXor(const uint8_t in[], uint8_t out[], size_t len, uint8_t counter[]) const {
+    const size_t blocks = (len + BlockBytes - 1) / BlockBytes;
+
+    // every range starts from its own counter, no keystream is shared between them
+    Self().ForRanges(blocks, Self().Parts(blocks), [&](size_t first, size_t count, size_t) {
+      uint8_t next[BlockBytes];
+      uint8_t counters[kParallelBlocks * BlockBytes];
+      uint8_t keystream[kParallelBlocks * BlockBytes];
+      memcpy(next, counter, BlockBytes);
+      Derived::CounterAdd(next, first);
+
+      size_t offset = first * BlockBytes;
+      const size_t end = offset + count * BlockBytes < len ? offset + count * BlockBytes : len;
+      while (offset < end) {
+        const size_t remaining = (end - offset + BlockBytes - 1) / BlockBytes;
+        const size_t batch = remaining < kParallelBlocks ? remaining : kParallelBlocks;
+        for (size_t j = 0; j < batch; j++) {
+          memcpy(counters + j * BlockBytes, next, BlockBytes);
+          Derived::CounterAdd(next, 1);
+        }
+        Self().EncryptBlocks(counters, keystream, batch);
+
+        const size_t chunk = batch * BlockBytes < end - offset ? batch * BlockBytes : end - offset;
+        Xor(in + offset, keystream, out + offset, chunk);
+        offset += chunk;
+      }
+    });
+
+    Derived::CounterAdd(counter, blocks);
+  }
+
+  void CbcEncrypt(const uint8_t in[], uint8_t out[], size_t blocks, uint8_t chain[]) const {
+    for (size_t i = 0; i < blocks * BlockBytes; i += BlockBytes) {
+      Xor(chain, in + i, chain, BlockBytes);
+      Self().EncryptBlock(chain, out + i);
+      memcpy(chain, out + i, BlockBytes);
+    }
+  }
+
+  void CbcDecrypt(const uint8_t in[], uint8_t out[], size_t blocks, uint8_t chain[]) const {
+    if (blocks == 0) {
+      return;
+    }
+
+    // the chaining value of every range is the ciphertext block before it, taken
+    // before any range runs because out may overwrite in
+    const size_t parts = Self().Parts(blocks);
+    uint8_t chains[kMaxParts * BlockBytes];
+    memcpy(chains, chain, BlockBytes);
+    for (size_t part = 1; part < parts; part++) {
+      memcpy(chains + part * BlockBytes, in + (blocks * part / parts - 1) * BlockBytes, BlockBytes);
+    }
+    memcpy(chain, in + (blocks - 1) * BlockBytes, BlockBytes);
+
+    Self().ForRanges(blocks, parts, [&](size_t begin, size_t count, size_t part) {
+      uint8_t *previous = chains + part * BlockBytes;
+      uint8_t ciphertext[kParallelBlocks * BlockBytes];
+
+      // every block only needs the previous ciphertext, so decrypt a whole batch at once;
+      // the batch is copied first because out may overwrite in
+      for (size_t first = begin; first < begin + count; first += kParallelBlocks) {
+        const size_t batch = begin + count - first < kParallelBlocks ? begin + count - first : kParallelBlocks;
+        const size_t offset = first * BlockBytes;
+        memcpy(ciphertext, in + offset, batch * BlockBytes);
+        Self().DecryptBlocks(ciphertext, out + offset, batch);
+        Xor(previous, out + offset, out + offset, BlockBytes);
+        Xor(ciphertext, out + offset + BlockBytes, out + offset + BlockBytes, (batch - 1) * BlockBytes);
+        memcpy(previous, ciphertext + (batch - 1) * BlockBytes, BlockBytes);
+      }
+    });
+  }
+
+  void CfbEncrypt(const uint8_t in[], uint8_t out[], size_t len, uint32_t s, uint8_t reg[]) const {
+    uint8_t keystream[BlockBytes];
+    for (size_t i = 0; i < len; i += BlockBytes) {
+      const size_t chunk = len - i < BlockBytes ? len - i : BlockBytes;
+      Self().EncryptBlock(reg, keystream);
+      Xor(in + i, keystream, out + i, chunk);
+      if (chunk == BlockBytes) {
+        memmove(reg, reg + s, BlockBytes - s);
+        memcpy(reg + BlockBytes - s, out + i, s);
+      }
+    }
+  }
+
+  void CfbDecrypt(const uint8_t in[], uint8_t out[], size_t len, uint32_t s, uint8_t reg[]) const {
+    const size_t blocks = (len + BlockBytes - 1) / BlockBytes;
+    if (blocks == 0) {
+      return;
+    }
+
+    // register of every range rebuilt from the ciphertext before it, before out may overwrite in
+    const size_t parts = Self().Parts(blocks);
+    uint8_t starts[kMaxParts * BlockBytes];
+    for (size_t part = 0; part < parts; part++) {
+      CfbRegister(in, blocks * part / parts, s, reg, starts + part * BlockBytes);
+    }
+    CfbRegister(in, len / BlockBytes, s, reg, reg);
+
+    Self().ForRanges(blocks, parts, [&](size_t begin, size_t count, size_t part) {
+      uint8_t *block = starts + part * BlockBytes;
+      uint8_t registers[kParallelBlocks * BlockBytes];
+      uint8_t keystream[kParallelBlocks * BlockBytes];
+
+      // the shift register only depends on the ciphertext, so several of them can be encrypted together
+      for (size_t first = begin; first < begin + count; first += kParallelBlocks) {
+        const size_t batch = begin + count - first < kParallelBlocks ? begin + count - first : kParallelBlocks;
+        const size_t offset = first * BlockBytes;
+        for (size_t j = 0; j < batch; j++) {
+          memcpy(registers + j * BlockBytes, block, BlockBytes);
+          if (offset + (j + 1) * BlockBytes <= len) {
+            memmove(block, block + s, BlockBytes - s);
+            memcpy(block + BlockBytes - s, in + offset + j * BlockBytes, s);
+          }
+        }
+        Self().EncryptBlocks(registers, keystream, batch);
+
+        const size_t chunk = len - offset < batch * BlockBytes ? len - offset : batch * BlockBytes;
+        Xor(in + offset, keystream, out + offset, chunk);
+      }
+    });
+  }
+
+  // block holds the last keystream block
+  void OfbXor(const uint8_t in[], uint8_t out[], size_t len, uint8_t block[]) const {
+    for (size_t i = 0; i < len; i += BlockBytes) {
+      const size_t chunk = len - i < BlockBytes ? len - i : BlockBytes;
+      Self().EncryptBlock(block, block);
+      Xor(in + i, block, out + i, chunk);
+    }
+  }
+
+  // throws if len is not a whole number of blocks
+  static void CheckBlockLength(size_t len) {
+    if (len % BlockBytes) {
+      throw std::invalid_argument("Length is not a multiple of the block size");
+    }
+  }
+
+  // throws if s is not a valid CFB segment size
+  static void CheckSegment(uint32_t s) {
+    if (s == 0 || s > BlockBytes) {
+      throw std::invalid_argument("Incorrect CFB segment size");
+    }
+  }
+
+  // out = a ^ b over len bytes, out may be the same buffer as a or b
+  static void Xor(const uint8_t a[], const uint8_t b[], uint8_t out[], size_t len) {
+    size_t i = 0;
+    for (; i + sizeof(uint64_t) <= len; i += sizeof(uint64_t)) {
+      uint64_t x, y;
+      memcpy(&x, a + i, sizeof(x));
+      memcpy(&y, b + i, sizeof(y));
+      x ^= y;
+      memcpy(out + i, &x, sizeof(x));
+    }
+    for (; i < len; i++) {
+      out[i] = a[i] ^ b[i];
+    }
+  }
+
+ private:
+  const Derived &Self() const {
+    return static_cast<const Derived &>(*this);
+  }
+
+  // CFB shift register in front of block, given the register in front of block 0
+  static void CfbRegister(const uint8_t in[], size_t block, uint32_t s, const uint8_t reg[], uint8_t out[]) {
+    // BlockBytes shifts push out at least the whole register, older ciphertext doesn't matter
+    const size_t start = block > BlockBytes ? block - BlockBytes : 0;
+    memmove(out, reg, BlockBytes);
+    for (size_t i = start; i < block; i++) {
+      memmove(out, out + s, BlockBytes - s);
+      memcpy(out + BlockBytes - s, in + i * BlockBytes, s);
+    }
+  }
+};
+
+#endif //AES_KALYNA_LIBRARY_INCLUDE_BLOCK_MODES_H_
@@ -4,10 +4,197 @@
 #include <cstdint>
 #include <cstdlib>
 #include <cstring>
+#include <variant>
 
+#include "kalyna_cipher.h"
+
+/*!
+ * Implementation of the multi-block functions behind the modes. The row-sliced
+ * backends hand blocks left over from their batches to the narrower ones and pad
+ * the last of them to an SSSE3 batch, so they never fall back to the tables, but
+ * modes that encipher one block at a time (CBC and CFB encryption, OFB) pay for
+ * a whole batch per block.
+ *
+ * kSsse3 and kAvx2 are an explicit constant-time option for CPUs without VBMI:
+ * they run 1.7 to 3.5 times slower than the tables, so kAuto never picks them.
+ */
+enum class KalynaBackend {
+  // KalynaCipher: S-box and MDS tables of 16 KB per direction, the lookups depend on the data
+  kTable,
+  // row-sliced SSSE3, 128 bytes per batch; PSHUFB lookups only, no memory access depends on the data
+  kSsse3,
+  // row-sliced AVX2, 256 bytes per batch, constant time like kSsse3
+  kAvx2,
+  // row-sliced AVX-512 with VBMI byte permutes for the S-boxes, 512 bytes per batch, constant time like kSsse3
+  kAvx512,
+  // kAvx512 when CPUID reports VBMI, tables otherwise
+  kAuto
+};
+
+/*!
+ * Expanded Kalyna round keys. Built once by Kalyna::ExpandKey and never
+ * modified afterwards, so one instance can be shared between threads.
+ */
+class KalynaKey {
+ public:
+  /*!
+ * @return Block size in bits the key was expanded for.
+ */
+  size_t BlockSize() const;
+
+  /*!
+ * @return Key size in bits the key was expanded for.
+ */
+  size_t KeySize() const;
+
+ private:
+  friend class Kalyna;
+
+  /*!
+ * Empty schedule of the given configuration, throws std::invalid_argument
+ * for sizes DSTU 7624 does not define.
+ */
+  KalynaKey(size_t block_size, size_t key_size);
+
+  std::variant<KalynaCipher<128, 128>,
+               KalynaCipher<128, 256>,
+               KalynaCipher<256, 256>,
+               KalynaCipher<256, 512>,
+               KalynaCipher<512, 512>> cipher;
+};
+
+/*!
+ * Kalyna with the block and key size chosen at run time. Dispatches to the
+ * KalynaCipher instance of the configuration, so the state and round keys are
+ * fixed-size arrays and nothing is allocated.
+ *
+ * The const functions taking a KalynaKey keep their state on the stack and
+ * can be called from any number of threads with the same key. KeyExpand and
+ * the Encipher/Decipher overloads without a key use a key stored in the object
+ * and must not race with each other.
+ */
 class Kalyna {
  public:
-  Kalyna(size_t block_size, size_t key_size);
+  /*!
+ * @param backend Implementation of the modes, throws std::invalid_argument if
+ * the CPU lacks the instruction set. kAuto, the default, detects the CPU.
+ */
+  Kalyna(size_t block_size, size_t key_size, KalynaBackend backend = KalynaBackend::kAuto);
+
+  /*!
+ * @return Backend in use, never kAuto.
+ */
+  KalynaBackend Backend() const;
+
+  /*!
+ * Run the key schedule once, the result can be passed to every call.
+ *
+ * @param key Kalyna enciphering key of Nk words.
+ * @return Expanded round keys.
+ */
+  KalynaKey ExpandKey(const uint64_t *key) const;
+
+  /*!
+ * Run the key schedule of many keys at once, several of them interleaved, for
+ * workloads that change the key more often than they encipher. Nothing is
+ * allocated.
+ *
+ * @param keys count Kalyna enciphering keys of Nk words, one after another.
+ * @param expanded count keys of any sizes, e.g. earlier ExpandKey results,
+ * overwritten with the round keys.
+ */
+  void ExpandKeys(const uint64_t *keys, size_t count, KalynaKey expanded[]) const;
+
+  /*!
+ * Encipher one block, plaintext and ciphertext may be the same buffer.
+ *
+ * @param plaintext Plaintext of length Nb words for enciphering.
+ * @param ciphertext The result of enciphering.
+ * @param key Round keys from ExpandKey of a Kalyna with the same sizes.
+ */
+  void Encipher(const uint64_t *plaintext, uint64_t *ciphertext, const KalynaKey &key) const;
+
+  /*!
+ * Decipher one block, ciphertext and plaintext may be the same buffer.
+ *
+ * @param ciphertext Enciphered data of length Nb words.
+ * @param plaintext The result of deciphering.
+ * @param key Round keys from ExpandKey of a Kalyna with the same sizes.
+ */
+  void Decipher(const uint64_t *ciphertext, uint64_t *plaintext, const KalynaKey &key) const;
+
+  /*
+   * Byte interface for keys and blocks taken straight from packet or file
+   * buffers: words are read and written as little endian whatever the host, the
+   * buffers need no alignment and nothing is copied besides the state itself.
+   * The word interface above uses the words as they are in memory.
+   */
+
+  /*!
+ * @param key Kalyna enciphering key of Nk * 8 bytes.
+ * @return Expanded round keys.
+ */
+  KalynaKey ExpandKey(const uint8_t key[]) const;
+
+  /*!
+ * Encipher one block of BlockBytes(), plaintext and ciphertext may be the same buffer.
+ */
+  void Encipher(const uint8_t plaintext[], uint8_t ciphertext[], const KalynaKey &key) const;
+
+  /*!
+ * Decipher one block of BlockBytes(), ciphertext and plaintext may be the same buffer.
+ */
+  void Decipher(const uint8_t ciphertext[], uint8_t plaintext[], const KalynaKey &key) const;
+
+  /*!
+ * @return Block size in bytes: 16, 32 or 64.
+ */
+  size_t BlockBytes() const;
+
+  // Largest block of the standard, in bytes.
+  static const size_t kMaxBlockBytes = 64;
+
+  /*
+   * DSTU 7624 modes over byte buffers. Blocks are read as little endian words.
+   * out must hold len bytes and may be the same buffer as in, nothing is
+   * allocated. ECB and CBC need len to be a multiple of the block size, CFB, OFB
+   * and CTR take any length. iv is one block.
+   */
+
+  void EncryptECB(const uint8_t in[], uint8_t out[], size_t len, const KalynaKey &key) const;
+
+  void DecryptECB(const uint8_t in[], uint8_t out[], size_t len, const KalynaKey &key) const;
+
+  void EncryptCBC(const uint8_t in[], uint8_t out[], size_t len, const KalynaKey &key, const uint8_t iv[]) const;
+
+  void DecryptCBC(const uint8_t in[], uint8_t out[], size_t len, const KalynaKey &key, const uint8_t iv[]) const;
+
+  /*!
+ * @param s Number of ciphertext bytes shifted into the feedback register per
+ * block, from 1 to the block size.
+ */
+  void EncryptCFB(const uint8_t in[], uint8_t out[], size_t len, uint32_t s, const KalynaKey &key,
+                  const uint8_t iv[]) const;
+
+  void DecryptCFB(const uint8_t in[], uint8_t out[], size_t len, uint32_t s, const KalynaKey &key,
+                  const uint8_t iv[]) const;
+
+  void EncryptOFB(const uint8_t in[], uint8_t out[], size_t len, const KalynaKey &key, const uint8_t iv[]) const;
+
+  void DecryptOFB(const uint8_t in[], uint8_t out[], size_t len, const KalynaKey &key, const uint8_t iv[]) const;
+
+  /*!
+ * Gamming mode: the counter starts at the enciphered iv and is incremented as a
+ * little endian integer before every block.
+ *
+ * @param offset Position of in[0] in the stream, so any range can be processed
+ * on its own.
+ */
+  void EncryptCTR(const uint8_t in[], uint8_t out[], size_t len, const KalynaKey &key, const uint8_t iv[],
+                  uint64_t offset = 0) const;
+
+  void DecryptCTR(const uint8_t in[], uint8_t out[], size_t len, const KalynaKey &key, const uint8_t iv[],
+                  uint64_t offset = 0) const;
 
   /*!
  * Compute round keys given the enciphering key and store them in cipher.
@@ -32,26 +219,41 @@ class Kalyna {
  */
   void Decipher(uint64_t *ciphertext, uint64_t *plaintext);
 
-  ~Kalyna();
-
  private:
-  void KeyExpandKt(uint64_t *key, uint64_t *kt);
+  friend class KalynaGcm;
+  friend class KalynaStream;
+
+  /*!
+ * Throws std::invalid_argument if key was expanded for other sizes.
+ */
+  void CheckKey(const KalynaKey &key) const;
 
-  void KeyExpandEven(uint64_t *key, uint64_t *kt);
+  /*!
+ * Throws std::invalid_argument if s is not a valid CFB segment size.
+ */
+  void CheckSegment(uint32_t s) const;
 
-  void KeyExpandOdd();
+  /*!
+ * Call function with the KalynaModes view (kalyna_modes.h) of key, whose
+ * block size is a compile-time constant. Throws like CheckKey.
+ */
+  template<typename Function>
+  void WithModes(const KalynaKey &key, const Function &function) const;
 
- private:
-  // Number of 64-bit words in enciphering block.
-  size_t nb;
-  // Number of 64-bit words in key.
-  size_t nk;
-  // Number of enciphering rounds.
-  size_t nr;
-  // Current cipher state.
-  uint64_t *state;
-  // Round key computed from enciphering key.
-  uint64_t **round_keys;
+  void EncipherBlocks(const uint8_t in[], uint8_t out[], size_t blocks, const KalynaKey &key) const;
+
+  void DecipherBlocks(const uint8_t in[], uint8_t out[], size_t blocks, const KalynaKey &key) const;
+
+  /*!
+ * First counter of the gamming mode for the block at index `block`.
+ */
+  void CtrStart(const uint8_t iv[], uint64_t block, const KalynaKey &key, uint8_t counter[]) const;
+
+  // Key used by the overloads without a KalynaKey argument.
+  KalynaKey key;
+  // Block size in bytes.
+  size_t block_bytes;
+  KalynaBackend backend;
 };
 
 #endif //AES_KALYNA_LIBRARY_INCLUDE_KALYNA_H_
@@ -0,0 +1,129 @@
+#ifndef AES_KALYNA_LIBRARY_INCLUDE_KALYNA_CIPHER_H_
+#define AES_KALYNA_LIBRARY_INCLUDE_KALYNA_CIPHER_H_
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+
+/*!
+ * Kalyna (DSTU 7624:2014) with the block and key size fixed at compile time.
+ * State and round keys are fixed-size arrays, the rounds, their columns and
+ * table lookups are unrolled and the ShiftRows offsets are constants.
+ * Instantiated in the library for the five standard configurations:
+ * 128/128, 128/256, 256/256, 256/512 and 512/512.
+ *
+ * @tparam BlockBits Block size in bits.
+ * @tparam KeyBits Key size in bits.
+ */
+template<size_t BlockBits, size_t KeyBits>
+class KalynaCipher {
+ public:
+  static_assert((BlockBits == 128 && (KeyBits == 128 || KeyBits == 256)) ||
+                    (BlockBits == 256 && (KeyBits == 256 || KeyBits == 512)) ||
+                    (BlockBits == 512 && KeyBits == 512),
+                "Unsupported Kalyna block and key size");
+
+  // Number of 64-bit words in enciphering block.
+  static constexpr size_t kNb = BlockBits / 64;
+  // Number of 64-bit words in key.
+  static constexpr size_t kNk = KeyBits / 64;
+  // Number of enciphering rounds.
+  static constexpr size_t kNr = KeyBits == 128 ? 10 : KeyBits == 256 ? 14 : 18;
+
+  using Block = std::array<uint64_t, kNb>;
+
+  /*!
+ * Compute round keys given the enciphering key.
+ *
+ * @param key Kalyna enciphering key of kNk words.
+ */
+  void KeyExpand(const uint64_t *key);
+
+  // Keys expanded together by KeyExpandBatch, wider blocks have enough even round keys of their own.
+  static constexpr size_t kKeyBatchWidth = kNb == 2 ? 4 : 1;
+
+  /*!
+ * Compute the round keys of `count` keys, kKeyBatchWidth at a time. The three
+ * rounds giving the intermediate key of one key depend on each other, those of
+ * different keys don't, so they are interleaved like the blocks of
+ * EncipherBlocks. The even round keys of one key are interleaved as well.
+ *
+ * @param keys count enciphering keys of kNk words, one after another.
+ * @param ciphers count instances receiving the round keys.
+ */
+  static void KeyExpandBatch(const uint64_t *keys, KalynaCipher *const ciphers[], size_t count);
+
+  /*!
+ * Encipher one block, plaintext and ciphertext may be the same buffer.
+ *
+ * @param plaintext Plaintext of length kNb words for enciphering.
+ * @param ciphertext The result of enciphering.
+ */
+  void Encipher(const uint64_t *plaintext, uint64_t *ciphertext) const;
+
+  /*!
+ * Decipher one block, ciphertext and plaintext may be the same buffer.
+ *
+ * @param ciphertext Enciphered data of length kNb words.
+ * @param plaintext The result of deciphering.
+ */
+  void Decipher(const uint64_t *ciphertext, uint64_t *plaintext) const;
+
+  // Blocks interleaved by EncipherBlocks and DecipherBlocks unless told otherwise.
+  static constexpr size_t kBatchWidth = 2;
+
+  /*!
+ * Encipher consecutive independent blocks given as bytes, each block is read
+ * as kNb little endian words. in and out may be the same buffer.
+ * The rounds of `width` blocks are interleaved: one round depends on the one
+ * before, the rounds of different blocks don't, so their lookups overlap.
+ *
+ * @param blocks Number of blocks of kNb * 8 bytes.
+ * @param width Blocks per batch: 1, 2, 4 or 8.
+ */
+  void EncipherBlocks(const uint8_t *in, uint8_t *out, size_t blocks, size_t width = kBatchWidth) const;
+
+  /*!
+ * Decipher consecutive independent blocks given as bytes, `width` at a time.
+ *
+ * @param blocks Number of blocks of kNb * 8 bytes.
+ * @param width Blocks per batch: 1, 2, 4 or 8.
+ */
+  void DecipherBlocks(const uint8_t *in, uint8_t *out, size_t blocks, size_t width = kBatchWidth) const;
+
+  /*!
+ * @return Enciphering round keys 0 .. kNr of kNb words each, one after another.
+ */
+  const uint64_t *RoundKeys() const {
+    return round_keys[0].data();
+  }
+
+ private:
+  template<size_t Width>
+  static void KeyExpandLanes(const uint64_t *keys, KalynaCipher *const ciphers[]);
+
+  template<size_t Width>
+  void EncipherBatch(const uint8_t *in, uint8_t *out) const;
+
+  template<size_t Width>
+  void DecipherBatch(const uint8_t *in, uint8_t *out) const;
+
+  template<size_t Width>
+  void EncipherBatches(const uint8_t *in, uint8_t *out, size_t blocks) const;
+
+  template<size_t Width>
+  void DecipherBatches(const uint8_t *in, uint8_t *out, size_t blocks) const;
+
+  // Round keys computed from enciphering key, contiguous and cache line aligned.
+  alignas(64) std::array<Block, kNr + 1> round_keys{};
+  // Round keys 1 .. kNr - 1 after InvMixColumns, for the equivalent inverse cipher.
+  alignas(64) std::array<Block, kNr + 1> dec_round_keys{};
+};
+
+extern template class KalynaCipher<128, 128>;
+extern template class KalynaCipher<128, 256>;
+extern template class KalynaCipher<256, 256>;
+extern template class KalynaCipher<256, 512>;
+extern template class KalynaCipher<512, 512>;
+
+#endif //AES_KALYNA_LIBRARY_INCLUDE_KALYNA_CIPHER_H_
@@ -0,0 +1,120 @@
+#ifndef AES_KALYNA_LIBRARY_INCLUDE_KALYNA_GCM_H_
+#define AES_KALYNA_LIBRARY_INCLUDE_KALYNA_GCM_H_
+
+#include <cstdint>
+#include <cstdio>
+
+#include "kalyna.h"
+
+/*!
+ * Implementation of the multiplication by H in GF(2^128), GF(2^256) or GF(2^512).
+ */
+enum class KalynaGmacBackend {
+  // 4-bit tables, 16 field elements per key; the lookups depend on the data
+  kTable,
+  // PCLMULQDQ, four blocks per reduction
+  kClmul,
+  // PCLMULQDQ when CPUID reports it, tables otherwise
+  kAuto
+};
+
+/*!
+ * Galois/Counter Mode of DSTU 7624 for one message at a time: Init, any number of
+ * UpdateAad calls, any number of Update calls, then Final or Verify. The context
+ * keeps a few blocks of state, whatever the message length is.
+ *
+ * Data is enciphered in the CTR (gamming) mode of Kalyna::EncryptCTR. H = E(0),
+ * the hash is taken over the zero padded AAD and ciphertext, then over the
+ * lengths block (AAD bits as a 64-bit little endian word at byte 0, data bits at
+ * byte BlockBytes / 2), and the tag is E(hash) truncated. GMAC is the same
+ * computation with the message passed as AAD only.
+ *
+ * The tests check this construction against a bitwise reference for every block
+ * size; the known-answer vectors of the standard have not been run against it yet.
+ */
+class KalynaGcm {
+ public:
+  /*!
+ * kalyna and key are copied.
+ */
+  KalynaGcm(const Kalyna &kalyna, const KalynaKey &key, bool encrypt,
+            KalynaGmacBackend gmac = KalynaGmacBackend::kAuto);
+
+  /*!
+ * Start a new message.
+ *
+ * @param iv From 1 byte to one block, shorter ones are padded with zeros in
+ * front to a whole block.
+ */
+  void Init(const uint8_t iv[], size_t ivLen);
+
+  /*!
+ * Additional authenticated data, all of it has to come before the first Update.
+ */
+  void UpdateAad(const uint8_t aad[], size_t len);
+
+  /*!
+ * Writes exactly len bytes, out may be the same buffer as in.
+ */
+  void Update(const uint8_t in[], uint8_t out[], size_t len);
+
+  /*!
+ * Authentication tag of the message.
+ *
+ * @param tagLen From 8 bytes to the block size, 0 for the block size.
+ */
+  void Final(uint8_t tag[], size_t tagLen = 0);
+
+  /*!
+ * Compare the tag in constant time, decrypted data must not be used when it
+ * returns false.
+ */
+  bool Verify(const uint8_t tag[], size_t tagLen = 0);
+
+  KalynaGmacBackend Backend() const;
+
+ private:
+  /*!
+ * Feed whole blocks to the GMAC backend.
+ */
+  void Hash(const uint8_t data[], size_t blocks);
+
+  /*!
+ * Hash the zero padded AAD tail once the data starts.
+ */
+  void FinishAad();
+
+  /*!
+ * XOR up to len bytes with the unused part of the current gamma block.
+ */
+  size_t XorGamma(const uint8_t in[], uint8_t out[], size_t len);
+
+  Kalyna kalyna;
+  KalynaKey key;
+  bool encrypt;
+  KalynaGmacBackend gmac;
+  size_t block_bytes;
+  // Number of 64-bit words in a block.
+  size_t nb;
+
+  // 4-bit multiples of H for kTable, H to H^4 for kClmul.
+  alignas(16) uint64_t table[16 * 8];
+
+  // Hash accumulator.
+  alignas(16) uint64_t x[8];
+  // Next counter of the gamming mode.
+  uint8_t counter[Kalyna::kMaxBlockBytes];
+  // Gamma of the current data block.
+  uint8_t gamma[Kalyna::kMaxBlockBytes];
+  // AAD or ciphertext of the current block, hashed once complete.
+  uint8_t pending[Kalyna::kMaxBlockBytes];
+  // Bytes of pending that are filled.
+  size_t used;
+
+  uint64_t aad_length;
+  uint64_t length;
+  bool started;
+  bool data_started;
+};
+
+#endif //AES_KALYNA_LIBRARY_INCLUDE_KALYNA_GCM_H_
@@ -0,0 +1,95 @@
+#ifndef AES_KALYNA_LIBRARY_INCLUDE_KALYNA_STREAM_H_
+#define AES_KALYNA_LIBRARY_INCLUDE_KALYNA_STREAM_H_
+
+#include <cstdint>
+#include <cstdio>
+
+#include "kalyna.h"
+
+enum class KalynaStreamMode { kCBC, kCFB, kOFB, kCTR };
+
+/*!
+ * Incremental encryption or decryption of one message at a time with a DSTU 7624
+ * mode. The data can arrive in Update calls of any length, the context only keeps
+ * one block of state and one block of buffered input or gamma, whatever the total
+ * length is.
+ */
+class KalynaStream {
+ public:
+  /*!
+ * kalyna and key are copied.
+ *
+ * @param s CFB segment size in bytes, the block size if 0, ignored by other modes.
+ */
+  KalynaStream(const Kalyna &kalyna, const KalynaKey &key, KalynaStreamMode mode, bool encrypt, uint32_t s = 0);
+
+  /*!
+ * Start a new message.
+ *
+ * @param iv One block, CTR enciphers it to get the first counter.
+ */
+  void Init(const uint8_t iv[]);
+
+  /*!
+ * CFB, OFB and CTR write exactly len bytes and out may be the same buffer as in.
+ * CBC only writes whole blocks, out needs room for len plus one block and must
+ * not overlap in.
+ *
+ * @return Number of bytes written to out.
+ */
+  size_t Update(const uint8_t in[], uint8_t out[], size_t len);
+
+  /*!
+ * End the message. CBC encryption pads the buffered tail with zeros and writes
+ * the last block, CBC decryption throws if the ciphertext was not a whole number
+ * of blocks. Init must be called before the next message.
+ *
+ * @return Number of bytes written to out.
+ */
+  size_t Final(uint8_t out[]);
+
+  /*!
+ * CTR only: continue at byte offset of the message.
+ */
+  void Seek(uint64_t offset);
+
+  /*!
+ * @return Position in the message: bytes passed to Update since Init, plus the
+ * last Seek offset.
+ */
+  uint64_t Length() const;
+
+ private:
+  /*!
+ * XOR up to len bytes with the unused part of the current gamma block.
+ */
+  size_t XorGamma(const uint8_t in[], uint8_t out[], size_t len);
+
+  /*!
+ * Produce the gamma block for the partial block that follows.
+ */
+  void NextGamma();
+
+  Kalyna kalyna;
+  KalynaKey key;
+  KalynaStreamMode mode;
+  bool encrypt;
+  uint32_t s;
+  size_t block_bytes;
+
+  // Block passed to Init, Seek restarts from it.
+  uint8_t iv[Kalyna::kMaxBlockBytes];
+  // CBC chaining value, CFB shift register, OFB gamma block or CTR counter.
+  uint8_t state[Kalyna::kMaxBlockBytes];
+  // CBC input waiting for a whole block, gamma of the current block for the other modes.
+  uint8_t buffer[Kalyna::kMaxBlockBytes];
+  // CFB ciphertext of the current block, shifted into the register once the block is complete.
+  uint8_t feedback[Kalyna::kMaxBlockBytes];
+  // Bytes of buffer that are filled (CBC) or already used (gamma).
+  size_t used;
+
+  uint64_t length;
+  bool started;
+};
+
+#endif //AES_KALYNA_LIBRARY_INCLUDE_KALYNA_STREAM_H_
@@ -0,0 +1,200 @@
+#ifndef AES_KALYNA_LIBRARY_INCLUDE_PERF_COUNTERS_H_
+#define AES_KALYNA_LIBRARY_INCLUDE_PERF_COUNTERS_H_
+
+#include <cstddef>
+#include <cstdint>
+
+#ifdef AES_KALYNA_PERF_COUNTERS
+#include <atomic>
+#if defined(__x86_64__) || defined(__i386__)
+#include <x86intrin.h>
+#endif
+#endif
+
+// Optional instrumentation of the aes and kalyna libraries, built in with the CMake option
+// AES_KALYNA_PERF_COUNTERS. Every public mode call, GCM and XTS call, stream update, key
+// expansion and buffer of the allocating AES API is counted per cipher, backend, mode and
+// direction, with the time stamp counter ticks spent inside. Without the option the hooks
+// are empty inline functions that compile to nothing and PerfSnapshot returns zeros.
+//
+// The counters are process wide relaxed atomics: a snapshot taken while other threads
+// encrypt is not a single point in time, but no update is lost.
+
+enum class PerfCipher { kAes, kKalyna };
+
+// kCBC to kCTR have the values of AesStreamMode and KalynaStreamMode plus one
+enum class PerfMode { kECB, kCBC, kCFB, kOFB, kCTR, kGCM, kXTS };
+
+const size_t kPerfCiphers = 2;
+const size_t kPerfModes = 7;
+// backends are indexed by the value of AESBackend or KalynaBackend, kAuto is resolved first
+const size_t kPerfBackends = 4;
+
+struct PerfModeCounters {
+  uint64_t calls;
+  uint64_t bytes;
+  // blocks the bytes take up, a partial block counts as one
+  uint64_t blocks;
+  // time stamp counter ticks inside the calls, 0 without rdtsc
+  uint64_t cycles;
+};
+
+struct PerfCounters {
+  // indexed by cipher, backend, mode and direction (0 encrypt, 1 decrypt)
+  PerfModeCounters modes[kPerfCiphers][kPerfBackends][kPerfModes][2];
+  uint64_t keyExpansions[kPerfCiphers];
+  uint64_t keyCycles[kPerfCiphers];
+  // new[] buffers returned by the allocating AES API
+  uint64_t allocations;
+  uint64_t allocatedBytes;
+
+  const PerfModeCounters &Mode(PerfCipher cipher, size_t backend, PerfMode mode, bool encrypt) const {
+    return modes[(size_t) cipher][backend][(size_t) mode][encrypt ? 0 : 1];
+  }
+};
+
+#ifdef AES_KALYNA_PERF_COUNTERS
+
+constexpr bool PerfCountersEnabled() {
+  return true;
+}
+
+inline uint64_t PerfTicks() {
+#if defined(__x86_64__) || defined(__i386__)
+  return __rdtsc();
+#else
+  return 0;
+#endif
+}
+
+// storage behind PerfCounters, one instance shared by both libraries
+struct PerfAtomicCounters {
+  struct Mode {
+    std::atomic<uint64_t> calls, bytes, blocks, cycles;
+  };
+
+  Mode modes[kPerfCiphers][kPerfBackends][kPerfModes][2];
+  std::atomic<uint64_t> keyExpansions[kPerfCiphers];
+  std::atomic<uint64_t> keyCycles[kPerfCiphers];
+  std::atomic<uint64_t> allocations;
+  std::atomic<uint64_t> allocatedBytes;
+};
+
+inline PerfAtomicCounters perfCounters;
+
+inline PerfCounters PerfSnapshot() {
+  PerfCounters snapshot{};
+  for (size_t c = 0; c < kPerfCiphers; c++) {
+    for (size_t b = 0; b < kPerfBackends; b++) {
+      for (size_t m = 0; m < kPerfModes; m++) {
+        for (size_t d = 0; d < 2; d++) {
+          const PerfAtomicCounters::Mode &from = perfCounters.modes[c][b][m][d];
+          PerfModeCounters &to = snapshot.modes[c][b][m][d];
+          to.calls = from.calls.load(std::memory_order_relaxed);
+          to.bytes = from.bytes.load(std::memory_order_relaxed);
+          to.blocks = from.blocks.load(std::memory_order_relaxed);
+          to.cycles = from.cycles.load(std::memory_order_relaxed);
+        }
+      }
+    }
+    snapshot.keyExpansions[c] = perfCounters.keyExpansions[c].load(std::memory_order_relaxed);
+    snapshot.keyCycles[c] = perfCounters.keyCycles[c].load(std::memory_order_relaxed);
+  }
+  snapshot.allocations = perfCounters.allocations.load(std::memory_order_relaxed);
+  snapshot.allocatedBytes = perfCounters.allocatedBytes.load(std::memory_order_relaxed);
+  return snapshot;
+}
+
+inline void PerfReset() {
+  for (size_t c = 0; c < kPerfCiphers; c++) {
+    for (size_t b = 0; b < kPerfBackends; b++) {
+      for (size_t m = 0; m < kPerfModes; m++) {
+        for (size_t d = 0; d < 2; d++) {
+          PerfAtomicCounters::Mode &mode = perfCounters.modes[c][b][m][d];
+          mode.calls.store(0, std::memory_order_relaxed);
+          mode.bytes.store(0, std::memory_order_relaxed);
+          mode.blocks.store(0, std::memory_order_relaxed);
+          mode.cycles.store(0, std::memory_order_relaxed);
+        }
+      }
+    }
+    perfCounters.keyExpansions[c].store(0, std::memory_order_relaxed);
+    perfCounters.keyCycles[c].store(0, std::memory_order_relaxed);
+  }
+  perfCounters.allocations.store(0, std::memory_order_relaxed);
+  perfCounters.allocatedBytes.store(0, std::memory_order_relaxed);
+}
+
+// counts one call of len bytes and the ticks until the end of the enclosing scope
+class PerfModeScope {
+ public:
+  PerfModeScope(PerfCipher cipher, size_t backend, PerfMode mode, bool encrypt, size_t len, size_t blockBytes)
+      : counters(perfCounters.modes[(size_t) cipher][backend][(size_t) mode][encrypt ? 0 : 1]), start(PerfTicks()) {
+    counters.calls.fetch_add(1, std::memory_order_relaxed);
+    counters.bytes.fetch_add(len, std::memory_order_relaxed);
+    counters.blocks.fetch_add((len + blockBytes - 1) / blockBytes, std::memory_order_relaxed);
+  }
+
+  ~PerfModeScope() {
+    counters.cycles.fetch_add(PerfTicks() - start, std::memory_order_relaxed);
+  }
+
+  PerfModeScope(const PerfModeScope &) = delete;
+  PerfModeScope &operator=(const PerfModeScope &) = delete;
+
+ private:
+  PerfAtomicCounters::Mode &counters;
+  uint64_t start;
+};
+
+// counts key expansions and the ticks until the end of the enclosing scope
+class PerfKeyScope {
+ public:
+  PerfKeyScope(PerfCipher cipher, size_t keys) : cipher((size_t) cipher), start(PerfTicks()) {
+    perfCounters.keyExpansions[this->cipher].fetch_add(keys, std::memory_order_relaxed);
+  }
+
+  ~PerfKeyScope() {
+    perfCounters.keyCycles[cipher].fetch_add(PerfTicks() - start, std::memory_order_relaxed);
+  }
+
+  PerfKeyScope(const PerfKeyScope &) = delete;
+  PerfKeyScope &operator=(const PerfKeyScope &) = delete;
+
+ private:
+  size_t cipher;
+  uint64_t start;
+};
+
+inline void PerfCountAllocation(size_t bytes) {
+  perfCounters.allocations.fetch_add(1, std::memory_order_relaxed);
+  perfCounters.allocatedBytes.fetch_add(bytes, std::memory_order_relaxed);
+}
+
+#else
+
+constexpr bool PerfCountersEnabled() {
+  return false;
+}
+
+inline PerfCounters PerfSnapshot() {
+  return PerfCounters{};
+}
+
+inline void PerfReset() {}
+
+class PerfModeScope {
+ public:
+  PerfModeScope(PerfCipher, size_t, PerfMode, bool, size_t, size_t) {}
+};
+
+class PerfKeyScope {
+ public:
+  PerfKeyScope(PerfCipher, size_t) {}
+};
+
+inline void PerfCountAllocation(size_t) {}
+
+#endif
+
+#endif //AES_KALYNA_LIBRARY_INCLUDE_PERF_COUNTERS_H_
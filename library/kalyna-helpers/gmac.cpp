@@ -0,0 +1,110 @@
+#include "gmac.h"
+
+/* x^7 + x^2 + x + 1, x^10 + x^5 + x^2 + 1, x^8 + x^5 + x^2 + 1 */
+static const uint64_t kGmacPolynomial128 = 0x0087u;
+static const uint64_t kGmacPolynomial256 = 0x0425u;
+static const uint64_t kGmacPolynomial512 = 0x0125u;
+
+uint64_t GmacPolynomial(size_t nw) {
+  return nw == 2 ? kGmacPolynomial128 : nw == 4 ? kGmacPolynomial256 : kGmacPolynomial512;
+}
+
+/*!
+ * Carry-less product of a 4-bit value and r(x), fits in a word since r(x) has degree 10 at most.
+ */
+static uint64_t MultiplyNibble(uint64_t nibble, uint64_t r) {
+  uint64_t product = 0;
+  for (unsigned bit = 0; bit < 4; ++bit) {
+    if ((nibble >> bit) & 1u) {
+      product ^= r << bit;
+    }
+  }
+  return product;
+}
+
+/*!
+ * v = v * x^{bits} for bits from 1 to 4.
+ */
+static inline void ShiftUp(uint64_t *v, size_t nw, unsigned bits, const uint64_t *reduce) {
+  const uint64_t overflow = v[nw - 1] >> (64u - bits);
+  for (size_t i = nw - 1; i > 0; --i) {
+    v[i] = (v[i] << bits) | (v[i - 1] >> (64u - bits));
+  }
+  v[0] = (v[0] << bits) ^ reduce[overflow];
+}
+
+static uint64_t LoadLittleEndian64(const uint8_t *p) {
+  uint64_t v = 0;
+  for (int i = 7; i >= 0; --i) {
+    v = (v << 8u) | p[i];
+  }
+  return v;
+}
+
+void GmacTableInit(const uint64_t *h, size_t nw, uint64_t *table) {
+  uint64_t reduce[16];
+  for (uint64_t nibble = 0; nibble < 16; ++nibble) {
+    reduce[nibble] = MultiplyNibble(nibble, GmacPolynomial(nw));
+  }
+
+  for (size_t i = 0; i < nw; ++i) {
+    table[i] = 0;
+    table[nw + i] = h[i];
+  }
+  // H * x^k for the powers of two, the other entries are sums of them
+  for (size_t power = 2; power < 16; power <<= 1u) {
+    for (size_t i = 0; i < nw; ++i) {
+      table[power * nw + i] = table[power / 2 * nw + i];
+    }
+    ShiftUp(table + power * nw, nw, 1, reduce);
+    for (size_t low = 1; low < power; ++low) {
+      for (size_t i = 0; i < nw; ++i) {
+        table[(power + low) * nw + i] = table[power * nw + i] ^ table[low * nw + i];
+      }
+    }
+  }
+}
+
+/*!
+ * GmacTableBlocks with the element size known at compile time, so the word loops unroll.
+ */
+template<size_t Nw>
+static void TableBlocks(uint64_t *x, const uint8_t *data, size_t blocks, const uint64_t *table) {
+  uint64_t reduce[16];
+  for (uint64_t nibble = 0; nibble < 16; ++nibble) {
+    reduce[nibble] = MultiplyNibble(nibble, GmacPolynomial(Nw));
+  }
+
+  uint64_t z[Nw];
+  for (size_t block = 0; block < blocks; ++block, data += Nw * 8) {
+    for (size_t i = 0; i < Nw; ++i) {
+      x[i] ^= LoadLittleEndian64(data + i * 8);
+      z[i] = 0;
+    }
+
+    // Horner's rule from the highest nibble of x
+    for (size_t word = Nw; word-- > 0;) {
+      for (int shift = 60; shift >= 0; shift -= 4) {
+        ShiftUp(z, Nw, 4, reduce);
+        const uint64_t *multiple = table + ((x[word] >> (unsigned) shift) & 0xfu) * Nw;
+        for (size_t i = 0; i < Nw; ++i) {
+          z[i] ^= multiple[i];
+        }
+      }
+    }
+
+    for (size_t i = 0; i < Nw; ++i) {
+      x[i] = z[i];
+    }
+  }
+}
+
+void GmacTableBlocks(uint64_t *x, const uint8_t *data, size_t blocks, size_t nw, const uint64_t *table) {
+  if (nw == 2) {
+    TableBlocks<2>(x, data, blocks, table);
+  } else if (nw == 4) {
+    TableBlocks<4>(x, data, blocks, table);
+  } else {
+    TableBlocks<8>(x, data, blocks, table);
+  }
+}
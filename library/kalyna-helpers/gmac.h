@@ -0,0 +1,32 @@
+#ifndef AES_KALYNA_LIBRARY_KALYNA_HELPERS_GMAC_H_
+#define AES_KALYNA_LIBRARY_KALYNA_HELPERS_GMAC_H_
+
+#include <cstdint>
+#include <cstdio>
+
+/*
+ * Field arithmetic of the DSTU 7624 GCM and GMAC modes. An element of GF(2^{64 nw})
+ * is nw little endian 64-bit words, bit i of word j is the coefficient of x^{64 j + i}.
+ * The fields are x^128 + x^7 + x^2 + x + 1, x^256 + x^10 + x^5 + x^2 + 1 and
+ * x^512 + x^8 + x^5 + x^2 + 1 for blocks of 2, 4 and 8 words.
+ */
+
+/*!
+ * @return Low terms r(x) of the field polynomial x^{64 nw} + r(x).
+ */
+uint64_t GmacPolynomial(size_t nw);
+
+/*!
+ * Multiples of H by every polynomial of degree below 4.
+ *
+ * @param table 16 elements of nw words.
+ */
+void GmacTableInit(const uint64_t *h, size_t nw, uint64_t *table);
+
+/*!
+ * x = (x ^ data_i) * H for each of the blocks, four bits of x at a time.
+ * Blocks are read as little endian words.
+ */
+void GmacTableBlocks(uint64_t *x, const uint8_t *data, size_t blocks, size_t nw, const uint64_t *table);
+
+#endif //AES_KALYNA_LIBRARY_KALYNA_HELPERS_GMAC_H_
@@ -0,0 +1,149 @@
+#include "gmac_clmul.h"
+#include "gmac.h"
+
+#ifdef AES_KALYNA_AESNI
+
+#if defined(__x86_64__) || defined(__i386__)
+#include <cpuid.h>
+#elif defined(_M_X64) || defined(_M_IX86)
+#include <intrin.h>
+#endif
+
+#include <wmmintrin.h>
+#include <emmintrin.h>
+
+bool GmacClmulAvailable() {
+#if defined(__x86_64__) || defined(__i386__)
+  unsigned int eax, ebx, ecx, edx;
+  static const bool supported = __get_cpuid(1, &eax, &ebx, &ecx, &edx) && ((ecx >> 1u) & 1u);
+#else
+  int info[4];
+  __cpuid(info, 1);
+  static const bool supported = (info[2] >> 1) & 1;
+#endif
+  return supported;
+}
+
+/* Largest element: 512 bits, four registers. */
+static const size_t kMaxLanes = 4;
+
+/*!
+ * product ^= a * b without reduction, 2 * lanes registers. Schoolbook: the 128-bit
+ * halves of the operands are multiplied pairwise with four PCLMULQDQ each.
+ */
+static inline void MultiplyAdd(const __m128i *a, const __m128i *b, size_t lanes, __m128i *product) {
+  for (size_t i = 0; i < lanes; ++i) {
+    for (size_t j = 0; j < lanes; ++j) {
+      const __m128i middle = _mm_xor_si128(_mm_clmulepi64_si128(a[i], b[j], 0x10),
+                                           _mm_clmulepi64_si128(a[i], b[j], 0x01));
+      product[i + j] = _mm_xor_si128(product[i + j],
+                                     _mm_xor_si128(_mm_clmulepi64_si128(a[i], b[j], 0x00), _mm_slli_si128(middle, 8)));
+      product[i + j + 1] = _mm_xor_si128(product[i + j + 1],
+                                         _mm_xor_si128(_mm_clmulepi64_si128(a[i], b[j], 0x11),
+                                                       _mm_srli_si128(middle, 8)));
+    }
+  }
+}
+
+/*!
+ * Reduce a product of 2 * lanes registers modulo x^n + r(x): the upper half times r(x)
+ * is added to the lower half, the few bits that overflow n are folded once more.
+ */
+static inline void Reduce(const __m128i *product, size_t lanes, __m128i r, __m128i *out) {
+  __m128i carry = _mm_setzero_si128();
+  for (size_t k = 0; k < lanes; ++k) {
+    const __m128i upper = product[lanes + k];
+    const __m128i even = _mm_clmulepi64_si128(upper, r, 0x00);
+    const __m128i odd = _mm_clmulepi64_si128(upper, r, 0x01);
+    out[k] = _mm_xor_si128(_mm_xor_si128(product[k], even), _mm_xor_si128(_mm_slli_si128(odd, 8), carry));
+    carry = _mm_srli_si128(odd, 8);
+  }
+  out[0] = _mm_xor_si128(out[0], _mm_clmulepi64_si128(carry, r, 0x00));
+}
+
+static inline void Load(const void *p, size_t lanes, __m128i *v) {
+  for (size_t k = 0; k < lanes; ++k) {
+    v[k] = _mm_loadu_si128((const __m128i *) p + k);
+  }
+}
+
+static inline void Store(const __m128i *v, size_t lanes, void *p) {
+  for (size_t k = 0; k < lanes; ++k) {
+    _mm_storeu_si128((__m128i *) p + k, v[k]);
+  }
+}
+
+void GmacClmulInit(const uint64_t *h, size_t nw, uint64_t *powers) {
+  const size_t lanes = nw / 2;
+  const __m128i r = _mm_set_epi64x(0, (long long) GmacPolynomial(nw));
+  __m128i h1[kMaxLanes], power[kMaxLanes], product[2 * kMaxLanes];
+  Load(h, lanes, h1);
+  Load(h, lanes, power);
+  Store(power, lanes, powers);
+  for (size_t i = 1; i < 4; ++i) {
+    for (size_t k = 0; k < 2 * lanes; ++k) {
+      product[k] = _mm_setzero_si128();
+    }
+    MultiplyAdd(power, h1, lanes, product);
+    Reduce(product, lanes, r, power);
+    Store(power, lanes, powers + i * nw);
+  }
+}
+
+void GmacClmulBlocks(uint64_t *x, const uint8_t *data, size_t blocks, size_t nw, const uint64_t *powers) {
+  const size_t lanes = nw / 2;
+  const __m128i r = _mm_set_epi64x(0, (long long) GmacPolynomial(nw));
+  __m128i h[4][kMaxLanes], acc[kMaxLanes], d[kMaxLanes], product[2 * kMaxLanes];
+  for (size_t i = 0; i < 4; ++i) {
+    Load(powers + i * nw, lanes, h[i]);
+  }
+  Load(x, lanes, acc);
+
+  // (x ^ d0) * H^4 ^ d1 * H^3 ^ d2 * H^2 ^ d3 * H with a single reduction
+  size_t block = 0;
+  for (; block + 4 <= blocks; block += 4) {
+    for (size_t k = 0; k < 2 * lanes; ++k) {
+      product[k] = _mm_setzero_si128();
+    }
+    for (size_t i = 0; i < 4; ++i) {
+      Load(data + (block + i) * nw * 8, lanes, d);
+      if (i == 0) {
+        for (size_t k = 0; k < lanes; ++k) {
+          d[k] = _mm_xor_si128(d[k], acc[k]);
+        }
+      }
+      MultiplyAdd(d, h[3 - i], lanes, product);
+    }
+    Reduce(product, lanes, r, acc);
+  }
+
+  for (; block < blocks; ++block) {
+    Load(data + block * nw * 8, lanes, d);
+    for (size_t k = 0; k < lanes; ++k) {
+      d[k] = _mm_xor_si128(d[k], acc[k]);
+      product[k] = _mm_setzero_si128();
+      product[lanes + k] = _mm_setzero_si128();
+    }
+    MultiplyAdd(d, h[0], lanes, product);
+    Reduce(product, lanes, r, acc);
+  }
+  Store(acc, lanes, x);
+}
+
+#else
+
+#include <stdexcept>
+
+bool GmacClmulAvailable() {
+  return false;
+}
+
+void GmacClmulInit(const uint64_t *, size_t, uint64_t *) {
+  throw std::logic_error("PCLMULQDQ support is not compiled in");
+}
+
+void GmacClmulBlocks(uint64_t *, const uint8_t *, size_t, size_t, const uint64_t *) {
+  throw std::logic_error("PCLMULQDQ support is not compiled in");
+}
+
+#endif
@@ -0,0 +1,24 @@
+#ifndef AES_KALYNA_LIBRARY_KALYNA_HELPERS_GMAC_CLMUL_H_
+#define AES_KALYNA_LIBRARY_KALYNA_HELPERS_GMAC_CLMUL_H_
+
+#include <cstdint>
+#include <cstdio>
+
+/*!
+ * @return true if the library was built with PCLMULQDQ support and the CPU has it.
+ */
+bool GmacClmulAvailable();
+
+/*
+ * Only call these after GmacClmulAvailable() returned true. Field elements are
+ * laid out as in gmac.h, powers holds H, H^2, H^3 and H^4 of nw words each.
+ */
+
+void GmacClmulInit(const uint64_t *h, size_t nw, uint64_t *powers);
+
+/*!
+ * x = (x ^ data_i) * H for each of the blocks, four of them reduced together.
+ */
+void GmacClmulBlocks(uint64_t *x, const uint8_t *data, size_t blocks, size_t nw, const uint64_t *powers);
+
+#endif //AES_KALYNA_LIBRARY_KALYNA_HELPERS_GMAC_CLMUL_H_
@@ -0,0 +1,75 @@
+#ifndef AES_KALYNA_LIBRARY_KALYNA_HELPERS_KALYNA_MODES_H_
+#define AES_KALYNA_LIBRARY_KALYNA_HELPERS_KALYNA_MODES_H_
+
+#include <type_traits>
+
+#include "block_modes.h"
+#include "kalyna.h"
+#include "transformations.h"
+
+// Bytes handed to the cipher together by the block-parallel modes, one AVX-512 batch.
+const size_t kKalynaParallelBytes = 512;
+
+/*!
+ * Encipher blocks with the row-sliced kernels of backend, which is not kTable.
+ */
+void SlicedEncipherBlocks(KalynaBackend backend, const uint8_t in[], uint8_t out[], size_t blocks, size_t nb,
+                          size_t nr, const uint64_t *round_keys);
+
+/*!
+ * Decipher blocks with the row-sliced kernels of backend, which is not kTable.
+ */
+void SlicedDecipherBlocks(KalynaBackend backend, const uint8_t in[], uint8_t out[], size_t blocks, size_t nb,
+                          size_t nr, const uint64_t *round_keys);
+
+/*!
+ * KalynaCipher of one configuration with its round keys seen as a BlockModes
+ * cipher. The gamming (CTR) counter starts at the enciphered iv and is a little
+ * endian integer over the whole block.
+ *
+ * @tparam Cipher KalynaCipher instance.
+ */
+template<typename Cipher>
+class KalynaModes : public BlockModes<KalynaModes<Cipher>, Cipher::kNb * sizeof(uint64_t), kKalynaParallelBytes> {
+ public:
+  KalynaModes(const Cipher &cipher, KalynaBackend backend) : cipher(cipher), backend(backend) {}
+
+  void EncryptBlocks(const uint8_t in[], uint8_t out[], size_t blocks) const {
+    if (backend == KalynaBackend::kTable) {
+      cipher.EncipherBlocks(in, out, blocks);
+    } else {
+      SlicedEncipherBlocks(backend, in, out, blocks, Cipher::kNb, Cipher::kNr, cipher.RoundKeys());
+    }
+  }
+
+  void DecryptBlocks(const uint8_t in[], uint8_t out[], size_t blocks) const {
+    if (backend == KalynaBackend::kTable) {
+      cipher.DecipherBlocks(in, out, blocks);
+    } else {
+      SlicedDecipherBlocks(backend, in, out, blocks, Cipher::kNb, Cipher::kNr, cipher.RoundKeys());
+    }
+  }
+
+  void CounterStart(const uint8_t iv[], uint64_t block, uint8_t counter[]) const {
+    EncryptBlocks(iv, counter, 1);
+    AddCounter(counter, Cipher::kNb * sizeof(uint64_t), block + 1);
+  }
+
+  static void CounterAdd(uint8_t counter[], uint64_t n) {
+    AddCounter(counter, Cipher::kNb * sizeof(uint64_t), n);
+  }
+
+ private:
+  const Cipher &cipher;
+  KalynaBackend backend;
+};
+
+template<typename Function>
+void Kalyna::WithModes(const KalynaKey &key, const Function &function) const {
+  CheckKey(key);
+  std::visit([&](const auto &cipher) {
+    function(KalynaModes<std::decay_t<decltype(cipher)>>(cipher, backend));
+  }, key.cipher);
+}
+
+#endif //AES_KALYNA_LIBRARY_KALYNA_HELPERS_KALYNA_MODES_H_
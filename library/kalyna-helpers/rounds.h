@@ -0,0 +1,84 @@
+#ifndef AES_KALYNA_LIBRARY_KALYNA_HELPERS_ROUNDS_H_
+#define AES_KALYNA_LIBRARY_KALYNA_HELPERS_ROUNDS_H_
+
+#include <array>
+#include <cstdint>
+#include <utility>
+
+#include "tables.h"
+
+/*
+ * Round transformations with the block size as a template parameter. Folding over
+ * index sequences unrolls every column and every table lookup at compile time,
+ * the ShiftRows offsets become constants.
+ */
+
+template<size_t Nb>
+using State = std::array<uint64_t, Nb>;
+
+using StateRows = std::make_index_sequence<8>;
+
+/* Column that ShiftRows moves byte `Row` of column `Col` from. */
+template<size_t Nb, size_t Col, size_t Row>
+constexpr size_t kShiftSource = (Col + Nb - Row * Nb / 8) % Nb;
+
+/* Column that InvShiftRows moves byte `Row` of column `Col` from. */
+template<size_t Nb, size_t Col, size_t Row>
+constexpr size_t kInvShiftSource = (Col + Row * Nb / 8) % Nb;
+
+template<size_t Row>
+inline uint8_t StateByte(uint64_t word) {
+  return (uint8_t) (word >> (Row * 8u));
+}
+
+template<size_t Nb, size_t Col, size_t... Row>
+inline uint64_t EncipherColumn(const State<Nb> &s, std::index_sequence<Row...>) {
+  return (mds_sbox_enc[Row][StateByte<Row>(s[kShiftSource<Nb, Col, Row>])] ^ ...);
+}
+
+template<size_t Nb, size_t Col, size_t... Row>
+inline uint64_t DecipherColumn(const State<Nb> &s, std::index_sequence<Row...>) {
+  return (mds_sbox_dec[Row][StateByte<Row>(s[kInvShiftSource<Nb, Col, Row>])] ^ ...);
+}
+
+template<size_t Nb, size_t Col, size_t... Row>
+inline uint64_t DecipherLastColumn(const State<Nb> &s, std::index_sequence<Row...>) {
+  return (((uint64_t) sboxes_dec[Row % 4][StateByte<Row>(s[kInvShiftSource<Nb, Col, Row>])] << (Row * 8u)) | ...);
+}
+
+template<size_t... Row>
+inline uint64_t InvMixColumn(uint64_t word, std::index_sequence<Row...>) {
+  return (mds_sbox_dec[Row][sboxes_enc[Row % 4][StateByte<Row>(word)]] ^ ...);
+}
+
+/* SubBytes, ShiftRows, MixColumns, then XOR with the round key. */
+template<size_t Nb, size_t... Col>
+inline State<Nb> UnrolledEncipherRound(const State<Nb> &s, const State<Nb> &key, std::index_sequence<Col...>) {
+  return {(EncipherColumn<Nb, Col>(s, StateRows()) ^ key[Col])...};
+}
+
+/* InvShiftRows, InvSubBytes and the next InvMixColumns, then XOR with the transformed round key. */
+template<size_t Nb, size_t... Col>
+inline State<Nb> UnrolledDecipherRound(const State<Nb> &s, const State<Nb> &key, std::index_sequence<Col...>) {
+  return {(DecipherColumn<Nb, Col>(s, StateRows()) ^ key[Col])...};
+}
+
+/* Last enciphering round, the round key is added modulo 2^{64}. */
+template<size_t Nb, size_t... Col>
+inline State<Nb> UnrolledEncipherLastRound(const State<Nb> &s, const State<Nb> &key, std::index_sequence<Col...>) {
+  return {(EncipherColumn<Nb, Col>(s, StateRows()) + key[Col])...};
+}
+
+/* InvShiftRows, InvSubBytes and subtraction of the first round key modulo 2^{64}. */
+template<size_t Nb, size_t... Col>
+inline State<Nb> UnrolledDecipherLastRound(const State<Nb> &s, const State<Nb> &key, std::index_sequence<Col...>) {
+  return {(DecipherLastColumn<Nb, Col>(s, StateRows()) - key[Col])...};
+}
+
+/* InvMixColumns of every word. */
+template<size_t Nb, size_t... Col>
+inline State<Nb> UnrolledInvMixColumns(const State<Nb> &s, std::index_sequence<Col...>) {
+  return {InvMixColumn(s[Col], StateRows())...};
+}
+
+#endif //AES_KALYNA_LIBRARY_KALYNA_HELPERS_ROUNDS_H_
@@ -0,0 +1,94 @@
+#include <cstring>
+
+#include "sliced.h"
+#include "tables.h"
+#include "transformations.h"
+
+static void Fill(SlicedTable &table, const uint8_t *bytes) {
+  for (size_t i = 0; i < 32; ++i) {
+    table.bytes[i] = bytes[i % 16];
+  }
+}
+
+static SlicedConstants BuildConstants() {
+  SlicedConstants c{};
+  uint8_t bytes[16];
+
+  const uint8_t (*sboxes[2])[256] = {sboxes_enc, sboxes_dec};
+  for (size_t inverse = 0; inverse < 2; ++inverse) {
+    for (size_t k = 0; k < 4; ++k) {
+      for (size_t h = 0; h < 16; ++h) {
+        // the lookups for high nibbles h .. 7 (or h .. 15) all hit, the differences telescope to S[h]
+        const bool last = h % 8 == 7;
+        for (size_t n = 0; n < 16; ++n) {
+          bytes[n] = (uint8_t) (sboxes[inverse][k][h * 16 + n] ^ (last ? 0 : sboxes[inverse][k][(h + 1) * 16 + n]));
+        }
+        Fill(c.sbox[inverse][k][h], bytes);
+      }
+    }
+  }
+  for (size_t h = 0; h < 8; ++h) {
+    memset(bytes, (int) (0x70 - 16 * h), sizeof(bytes));
+    Fill(c.bias[h], bytes);
+  }
+
+  const uint8_t (*matrices[2])[8] = {mds_matrix, mds_inv_matrix};
+  for (size_t inverse = 0; inverse < 2; ++inverse) {
+    for (size_t k = 0; k < 8; ++k) {
+      const uint8_t factor = matrices[inverse][0][k];
+      for (size_t n = 0; n < 16; ++n) {
+        bytes[n] = MultiplyGF((uint8_t) n, factor);
+      }
+      Fill(c.mul_low[inverse][k], bytes);
+      for (size_t n = 0; n < 16; ++n) {
+        bytes[n] = MultiplyGF((uint8_t) (n << 4u), factor);
+      }
+      Fill(c.mul_high[inverse][k], bytes);
+    }
+  }
+
+  for (size_t n = 0; n < 3; ++n) {
+    const size_t nb = (size_t) 2 << n;
+    for (size_t row = 0; row < 8; ++row) {
+      // byte p = s * nb + col of the row register comes from the same row of another column of block s
+      for (size_t p = 0; p < 16; ++p) {
+        const size_t first = p - p % nb;
+        bytes[p] = (uint8_t) (first + (p % nb + nb - row * nb / 8) % nb);
+      }
+      Fill(c.shift[0][n][row], bytes);
+      for (size_t p = 0; p < 16; ++p) {
+        const size_t first = p - p % nb;
+        bytes[p] = (uint8_t) (first + (p % nb + row * nb / 8) % nb);
+      }
+      Fill(c.shift[1][n][row], bytes);
+
+      // a 16-byte chunk holds key words 2q and 2q + 1, PSHUFB reads zero for index 0x80
+      for (size_t q = 0; q < 4; ++q) {
+        for (size_t p = 0; p < 16; ++p) {
+          const size_t col = p % nb;
+          bytes[p] = col / 2 == q ? (uint8_t) (col % 2 * 8 + row) : 0x80;
+        }
+        Fill(c.key_row[n][row][q], bytes);
+      }
+    }
+  }
+
+  for (size_t row = 0; row < 8; ++row) {
+    for (size_t word = 0; word < 2; ++word) {
+      bytes[2 * row + word] = (uint8_t) (8 * word + row);
+    }
+  }
+  Fill(c.gather, bytes);
+  for (size_t row = 0; row < 8; ++row) {
+    for (size_t word = 0; word < 2; ++word) {
+      bytes[8 * word + row] = (uint8_t) (2 * row + word);
+    }
+  }
+  Fill(c.scatter, bytes);
+  return c;
+}
+
+const SlicedConstants &GetSlicedConstants() {
+  static const SlicedConstants constants = BuildConstants();
+  return constants;
+}
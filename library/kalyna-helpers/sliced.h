@@ -0,0 +1,271 @@
+#ifndef AES_KALYNA_LIBRARY_KALYNA_HELPERS_SLICED_H_
+#define AES_KALYNA_LIBRARY_KALYNA_HELPERS_SLICED_H_
+
+#include <cstddef>
+#include <cstdint>
+
+#include "tables.h"
+
+/*
+ * Row-sliced Kalyna for the SIMD backends. A batch of blocks is transposed so
+ * that every 128-bit lane of a register holds one row (byte position in the
+ * state words) of 16 columns: column c of block s of the lane is byte s * nb + c.
+ * All bytes of a register then use the same S-box, ShiftRows is a byte shuffle
+ * inside the register and MixColumns multiplies whole registers by constants.
+ *
+ * GF(2^8) products are PSHUFB lookups in 16-byte tables indexed by one nibble.
+ * With SSSE3 and AVX2 an S-box takes 16 such lookups, PSHUFB reads zero where
+ * the index has bit 7 set, with AVX-512 VBMI it is two 128-byte permutes. No
+ * memory address depends on the data or the key.
+ */
+
+/* 16-byte table stored twice, so AVX2 can use it as a 256-bit operand. */
+struct alignas(32) SlicedTable {
+  uint8_t bytes[32];
+};
+
+struct SlicedConstants {
+  /*
+   * [inverse][row % 4][h]: S-box differences for the 16 low nibbles. Lookup h of
+   * the lower half reads a table only if the high nibble is at most h, so table h
+   * holds S[h] ^ S[h + 1] and table 7 holds S[7]; the upper half works the same
+   * on the byte with bit 7 flipped, in tables 8 .. 15.
+   */
+  SlicedTable sbox[2][4][16];
+  /* [h]: 0x70 - 16 * h, saturating addition sets bit 7 of bytes above 16 * h + 15. */
+  SlicedTable bias[8];
+  /* [inverse][k]: products of the low and high nibble by entry k of the first row of the (inverse) MDS matrix. */
+  SlicedTable mul_low[2][8];
+  SlicedTable mul_high[2][8];
+  /* [inverse][nb index][row]: (Inv)ShiftRows of one row register. */
+  SlicedTable shift[2][3][8];
+  /* [nb index][row][chunk]: row bytes of 16-byte chunk `chunk` of a round key, zero for the other chunks. */
+  SlicedTable key_row[3][8][4];
+  /* Pairs up row r of the two words of a lane as 16-bit element r, and back. */
+  SlicedTable gather;
+  SlicedTable scatter;
+};
+
+/*!
+ * @return Tables built from the scalar S-boxes and MDS matrices on first use.
+ */
+const SlicedConstants &GetSlicedConstants();
+
+/*!
+ * @return Index of the tables for nb = 2, 4 or 8 words.
+ */
+static inline size_t SlicedNbIndex(size_t nb) {
+  return nb == 2 ? 0 : nb == 4 ? 1 : 2;
+}
+
+/*!
+ * Both matrices are circulant, row i is the first row rotated right by i. The
+ * first row of the MDS matrix is 01 01 05 01 08 06 07 04, the entries equal to
+ * one need no lookup; the inverse has none.
+ */
+static constexpr bool SlicedMdsIdentity(size_t inverse, size_t k) {
+  return inverse == 0 && (k == 0 || k == 1 || k == 3);
+}
+
+/*
+ * Engine templates. Ops provides the register type Vec, kLanes (128-bit lanes
+ * per register), kPermuteBytes (whole S-box lookups) and the few instructions
+ * used below; every backend compiles these with its own instruction set.
+ */
+
+template<typename Ops>
+struct Sliced {
+  using Vec = typename Ops::Vec;
+
+  /* Blocks of nb words transformed by one batch. */
+  static size_t BatchBlocks(size_t nb) {
+    return 16 * Ops::kLanes / nb;
+  }
+
+  /* Words 2 * i and 2 * i + 1 of every lane of a round key, in the input layout. */
+  static Vec KeyWords(const uint64_t *round_key, size_t i, size_t nb) {
+    return Ops::LoadKey(round_key + 2 * (i % (nb / 2)));
+  }
+
+  /* 8x8 transpose of 16-bit elements in every lane, its own inverse. */
+  static void Transpose(Vec *v) {
+    Vec a[8];
+    for (size_t k = 0; k < 8; k += 2) {
+      a[k] = Ops::UnpackLow16(v[k], v[k + 1]);
+      a[k + 1] = Ops::UnpackHigh16(v[k], v[k + 1]);
+    }
+    const Vec b[8] = {Ops::UnpackLow32(a[0], a[2]), Ops::UnpackHigh32(a[0], a[2]),
+                      Ops::UnpackLow32(a[1], a[3]), Ops::UnpackHigh32(a[1], a[3]),
+                      Ops::UnpackLow32(a[4], a[6]), Ops::UnpackHigh32(a[4], a[6]),
+                      Ops::UnpackLow32(a[5], a[7]), Ops::UnpackHigh32(a[5], a[7])};
+    for (size_t k = 0; k < 4; ++k) {
+      v[2 * k] = Ops::UnpackLow64(b[k], b[k + 4]);
+      v[2 * k + 1] = Ops::UnpackHigh64(b[k], b[k + 4]);
+    }
+  }
+
+  /* Words to rows: each register of two words is grouped by row, then the 16-bit pairs are transposed. */
+  static void ToRows(Vec *v, const SlicedConstants &c) {
+    for (size_t i = 0; i < 8; ++i) {
+      v[i] = Ops::Shuffle(v[i], Ops::Table(c.gather));
+    }
+    Transpose(v);
+  }
+
+  static void ToWords(Vec *v, const SlicedConstants &c) {
+    Transpose(v);
+    for (size_t i = 0; i < 8; ++i) {
+      v[i] = Ops::Shuffle(v[i], Ops::Table(c.scatter));
+    }
+  }
+
+  /* Rows r and r + 4 use the same S-box and share the table loads. */
+  template<size_t Inverse>
+  static void SubBytes(Vec *rows, const SlicedConstants &c) {
+    if constexpr (Ops::kPermuteBytes) {
+      const uint8_t (*sboxes)[256] = Inverse ? sboxes_dec : sboxes_enc;
+      for (size_t r = 0; r < 4; ++r) {
+        rows[r] = Ops::Permute(rows[r], sboxes[r]);
+        rows[r + 4] = Ops::Permute(rows[r + 4], sboxes[r]);
+      }
+    } else {
+      const Vec top = Ops::Set1(0x80);
+      for (size_t r = 0; r < 4; ++r) {
+        const Vec x[2] = {rows[r], rows[r + 4]};
+        const Vec flipped[2] = {Ops::Xor(x[0], top), Ops::Xor(x[1], top)};
+        Vec result[2] = {Ops::Zero(), Ops::Zero()};
+        for (size_t h = 0; h < 8; ++h) {
+          const Vec bias = Ops::Table(c.bias[h]);
+          const Vec low_half = Ops::Table(c.sbox[Inverse][r][h]);
+          const Vec high_half = Ops::Table(c.sbox[Inverse][r][h + 8]);
+          for (size_t k = 0; k < 2; ++k) {
+            result[k] = Ops::Xor(result[k], Ops::Shuffle(low_half, Ops::AddSaturate(x[k], bias)));
+            result[k] = Ops::Xor(result[k], Ops::Shuffle(high_half, Ops::AddSaturate(flipped[k], bias)));
+          }
+        }
+        rows[r] = result[0];
+        rows[r + 4] = result[1];
+      }
+    }
+  }
+
+  template<size_t Inverse>
+  static void ShiftRows(Vec *rows, size_t nb, const SlicedConstants &c) {
+    const SlicedTable *shift = c.shift[Inverse][SlicedNbIndex(nb)];
+    for (size_t r = 0; r < 8; ++r) {
+      rows[r] = Ops::Shuffle(rows[r], Ops::Table(shift[r]));
+    }
+  }
+
+  /* Row j times entry k of the first matrix row goes to output row j - k, two nibble lookups per product. */
+  template<size_t Inverse>
+  static void MixColumns(Vec *rows, const SlicedConstants &c) {
+    const Vec low_nibble = Ops::Set1(0x0f);
+    Vec out[8];
+    for (size_t i = 0; i < 8; ++i) {
+      out[i] = Ops::Zero();
+    }
+    for (size_t j = 0; j < 8; ++j) {
+      const Vec low = Ops::And(rows[j], low_nibble);
+      const Vec high = Ops::And(Ops::ShiftRight4(rows[j]), low_nibble);
+      for (size_t k = 0; k < 8; ++k) {
+        const size_t i = (j - k) & 7u;
+        if (SlicedMdsIdentity(Inverse, k)) {
+          out[i] = Ops::Xor(out[i], rows[j]);
+        } else {
+          out[i] = Ops::Xor(out[i], Ops::Xor(Ops::Shuffle(Ops::Table(c.mul_low[Inverse][k]), low),
+                                             Ops::Shuffle(Ops::Table(c.mul_high[Inverse][k]), high)));
+        }
+      }
+    }
+    for (size_t i = 0; i < 8; ++i) {
+      rows[i] = out[i];
+    }
+  }
+
+  /* The round key is spread over the rows from its 16-byte chunks. */
+  static void XorRoundKey(Vec *rows, const uint64_t *round_key, size_t nb, const SlicedConstants &c) {
+    const size_t n = SlicedNbIndex(nb);
+    Vec chunks[4];
+    for (size_t q = 0; q < nb / 2; ++q) {
+      chunks[q] = Ops::LoadKey(round_key + 2 * q);
+    }
+    for (size_t r = 0; r < 8; ++r) {
+      Vec key = Ops::Shuffle(chunks[0], Ops::Table(c.key_row[n][r][0]));
+      for (size_t q = 1; q < nb / 2; ++q) {
+        key = Ops::Xor(key, Ops::Shuffle(chunks[q], Ops::Table(c.key_row[n][r][q])));
+      }
+      rows[r] = Ops::Xor(rows[r], key);
+    }
+  }
+
+  static void EncipherBatch(const uint8_t *in, uint8_t *out, size_t nb, size_t nr, const uint64_t *round_keys,
+                            const SlicedConstants &c) {
+    Vec v[8];
+    for (size_t i = 0; i < 8; ++i) {
+      v[i] = Ops::Add64(Ops::Load(in, i), KeyWords(round_keys, i, nb));
+    }
+    ToRows(v, c);
+    for (size_t round = 1; round < nr; ++round) {
+      SubBytes<0>(v, c);
+      ShiftRows<0>(v, nb, c);
+      MixColumns<0>(v, c);
+      XorRoundKey(v, round_keys + round * nb, nb, c);
+    }
+    SubBytes<0>(v, c);
+    ShiftRows<0>(v, nb, c);
+    MixColumns<0>(v, c);
+    ToWords(v, c);
+    for (size_t i = 0; i < 8; ++i) {
+      Ops::Store(out, i, Ops::Add64(v[i], KeyWords(round_keys + nr * nb, i, nb)));
+    }
+  }
+
+  /* The direct inverse with the enciphering round keys, the XOR is not moved past InvMixColumns. */
+  static void DecipherBatch(const uint8_t *in, uint8_t *out, size_t nb, size_t nr, const uint64_t *round_keys,
+                            const SlicedConstants &c) {
+    Vec v[8];
+    for (size_t i = 0; i < 8; ++i) {
+      v[i] = Ops::Sub64(Ops::Load(in, i), KeyWords(round_keys + nr * nb, i, nb));
+    }
+    ToRows(v, c);
+    MixColumns<1>(v, c);
+    ShiftRows<1>(v, nb, c);
+    SubBytes<1>(v, c);
+    for (size_t round = nr - 1; round > 0; --round) {
+      XorRoundKey(v, round_keys + round * nb, nb, c);
+      MixColumns<1>(v, c);
+      ShiftRows<1>(v, nb, c);
+      SubBytes<1>(v, c);
+    }
+    ToWords(v, c);
+    for (size_t i = 0; i < 8; ++i) {
+      Ops::Store(out, i, Ops::Sub64(v[i], KeyWords(round_keys, i, nb)));
+    }
+  }
+
+  /* Whole batches only, returns the number of blocks done. */
+  static size_t EncipherBlocks(const uint8_t *in, uint8_t *out, size_t blocks, size_t nb, size_t nr,
+                               const uint64_t *round_keys) {
+    const SlicedConstants &c = GetSlicedConstants();
+    const size_t batch = BatchBlocks(nb);
+    size_t done = 0;
+    for (; done + batch <= blocks; done += batch) {
+      EncipherBatch(in + done * nb * 8, out + done * nb * 8, nb, nr, round_keys, c);
+    }
+    return done;
+  }
+
+  static size_t DecipherBlocks(const uint8_t *in, uint8_t *out, size_t blocks, size_t nb, size_t nr,
+                               const uint64_t *round_keys) {
+    const SlicedConstants &c = GetSlicedConstants();
+    const size_t batch = BatchBlocks(nb);
+    size_t done = 0;
+    for (; done + batch <= blocks; done += batch) {
+      DecipherBatch(in + done * nb * 8, out + done * nb * 8, nb, nr, round_keys, c);
+    }
+    return done;
+  }
+};
+
+#endif //AES_KALYNA_LIBRARY_KALYNA_HELPERS_SLICED_H_
@@ -0,0 +1,111 @@
+#include "sliced_avx2.h"
+#include "sliced.h"
+
+#ifdef AES_KALYNA_AESNI
+
+#if defined(__x86_64__) || defined(__i386__)
+#include <cpuid.h>
+#elif defined(_M_X64) || defined(_M_IX86)
+#include <intrin.h>
+#endif
+
+#include <immintrin.h>
+
+/* AVX2 in CPUID leaf 7, and the OS saves the YMM registers (OSXSAVE, XCR0 bits 1 and 2). */
+static bool DetectAvx2() {
+#if defined(__x86_64__) || defined(__i386__)
+  unsigned int eax, ebx, ecx, edx;
+  if (!__get_cpuid(1, &eax, &ebx, &ecx, &edx) || !((ecx >> 27u) & 1u)) {
+    return false;
+  }
+  unsigned int xcr0, xcr0_high;
+  __asm__("xgetbv" : "=a"(xcr0), "=d"(xcr0_high) : "c"(0));
+  if ((xcr0 & 6u) != 6u) {
+    return false;
+  }
+  return __get_cpuid_count(7, 0, &eax, &ebx, &ecx, &edx) && ((ebx >> 5u) & 1u);
+#else
+  int info[4];
+  __cpuid(info, 1);
+  if (!((info[2] >> 27) & 1) || (_xgetbv(0) & 6) != 6) {
+    return false;
+  }
+  __cpuidex(info, 7, 0);
+  return (info[1] >> 5) & 1;
+#endif
+}
+
+bool SlicedAvx2Available() {
+  static const bool supported = DetectAvx2();
+  return supported;
+}
+
+/* Two independent 128-bit lanes, the second one holds the next 128 bytes of the batch. */
+struct Avx2Ops {
+  using Vec = __m256i;
+  static constexpr size_t kLanes = 2;
+  static constexpr bool kPermuteBytes = false;
+
+  static Vec Load(const uint8_t *in, size_t i) {
+    return _mm256_inserti128_si256(_mm256_castsi128_si256(_mm_loadu_si128((const __m128i *) (in + 16 * i))),
+                                   _mm_loadu_si128((const __m128i *) (in + 128 + 16 * i)), 1);
+  }
+
+  static void Store(uint8_t *out, size_t i, Vec v) {
+    _mm_storeu_si128((__m128i *) (out + 16 * i), _mm256_castsi256_si128(v));
+    _mm_storeu_si128((__m128i *) (out + 128 + 16 * i), _mm256_extracti128_si256(v, 1));
+  }
+
+  static Vec LoadKey(const uint64_t *words) {
+    return _mm256_broadcastsi128_si256(_mm_loadu_si128((const __m128i *) words));
+  }
+
+  static Vec Table(const SlicedTable &table) {
+    return _mm256_load_si256((const __m256i *) table.bytes);
+  }
+
+  static Vec Zero() { return _mm256_setzero_si256(); }
+  static Vec Set1(uint8_t byte) { return _mm256_set1_epi8((char) byte); }
+  static Vec Xor(Vec a, Vec b) { return _mm256_xor_si256(a, b); }
+  static Vec And(Vec a, Vec b) { return _mm256_and_si256(a, b); }
+  static Vec Shuffle(Vec a, Vec index) { return _mm256_shuffle_epi8(a, index); }
+  static Vec AddSaturate(Vec a, Vec b) { return _mm256_adds_epu8(a, b); }
+  static Vec Sub8(Vec a, Vec b) { return _mm256_sub_epi8(a, b); }
+  static Vec ShiftRight4(Vec a) { return _mm256_srli_epi16(a, 4); }
+  static Vec Add64(Vec a, Vec b) { return _mm256_add_epi64(a, b); }
+  static Vec Sub64(Vec a, Vec b) { return _mm256_sub_epi64(a, b); }
+  static Vec UnpackLow16(Vec a, Vec b) { return _mm256_unpacklo_epi16(a, b); }
+  static Vec UnpackHigh16(Vec a, Vec b) { return _mm256_unpackhi_epi16(a, b); }
+  static Vec UnpackLow32(Vec a, Vec b) { return _mm256_unpacklo_epi32(a, b); }
+  static Vec UnpackHigh32(Vec a, Vec b) { return _mm256_unpackhi_epi32(a, b); }
+  static Vec UnpackLow64(Vec a, Vec b) { return _mm256_unpacklo_epi64(a, b); }
+  static Vec UnpackHigh64(Vec a, Vec b) { return _mm256_unpackhi_epi64(a, b); }
+};
+
+size_t SlicedAvx2EncipherBlocks(const uint8_t *in, uint8_t *out, size_t blocks, size_t nb, size_t nr,
+                                const uint64_t *round_keys) {
+  return Sliced<Avx2Ops>::EncipherBlocks(in, out, blocks, nb, nr, round_keys);
+}
+
+size_t SlicedAvx2DecipherBlocks(const uint8_t *in, uint8_t *out, size_t blocks, size_t nb, size_t nr,
+                                const uint64_t *round_keys) {
+  return Sliced<Avx2Ops>::DecipherBlocks(in, out, blocks, nb, nr, round_keys);
+}
+
+#else
+
+#include <stdexcept>
+
+bool SlicedAvx2Available() {
+  return false;
+}
+
+size_t SlicedAvx2EncipherBlocks(const uint8_t *, uint8_t *, size_t, size_t, size_t, const uint64_t *) {
+  throw std::logic_error("AVX2 support is not compiled in");
+}
+
+size_t SlicedAvx2DecipherBlocks(const uint8_t *, uint8_t *, size_t, size_t, size_t, const uint64_t *) {
+  throw std::logic_error("AVX2 support is not compiled in");
+}
+
+#endif
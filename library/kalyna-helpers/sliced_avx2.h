@@ -0,0 +1,25 @@
+#ifndef AES_KALYNA_LIBRARY_KALYNA_HELPERS_SLICED_AVX2_H_
+#define AES_KALYNA_LIBRARY_KALYNA_HELPERS_SLICED_AVX2_H_
+
+#include <cstddef>
+#include <cstdint>
+
+/*!
+ * @return true if the library was built with AVX2 support and the CPU has it.
+ */
+bool SlicedAvx2Available();
+
+/*
+ * Only call these after SlicedAvx2Available() returned true. Blocks of nb words
+ * are processed in batches of 32 / nb, round_keys holds the nr + 1 enciphering
+ * round keys one after another. Returns the number of blocks done, the rest of
+ * the blocks is left to the caller.
+ */
+
+size_t SlicedAvx2EncipherBlocks(const uint8_t *in, uint8_t *out, size_t blocks, size_t nb, size_t nr,
+                                const uint64_t *round_keys);
+
+size_t SlicedAvx2DecipherBlocks(const uint8_t *in, uint8_t *out, size_t blocks, size_t nb, size_t nr,
+                                const uint64_t *round_keys);
+
+#endif //AES_KALYNA_LIBRARY_KALYNA_HELPERS_SLICED_AVX2_H_
@@ -0,0 +1,141 @@
+#include "sliced_avx512.h"
+#include "sliced.h"
+
+#ifdef AES_KALYNA_AESNI
+
+#if defined(__x86_64__) || defined(__i386__)
+#include <cpuid.h>
+#elif defined(_M_X64) || defined(_M_IX86)
+#include <intrin.h>
+#endif
+
+#include <immintrin.h>
+
+/*
+ * AVX512F, AVX512BW and AVX512_VBMI in CPUID leaf 7, and the OS saves the opmask
+ * and all ZMM registers (OSXSAVE, XCR0 bits 1, 2 and 5 .. 7).
+ */
+static bool DetectAvx512() {
+#if defined(__x86_64__) || defined(__i386__)
+  unsigned int eax, ebx, ecx, edx;
+  if (!__get_cpuid(1, &eax, &ebx, &ecx, &edx) || !((ecx >> 27u) & 1u)) {
+    return false;
+  }
+  unsigned int xcr0, xcr0_high;
+  __asm__("xgetbv" : "=a"(xcr0), "=d"(xcr0_high) : "c"(0));
+  if ((xcr0 & 0xe6u) != 0xe6u) {
+    return false;
+  }
+  return __get_cpuid_count(7, 0, &eax, &ebx, &ecx, &edx) && ((ebx >> 16u) & 1u) && ((ebx >> 30u) & 1u)
+      && ((ecx >> 1u) & 1u);
+#else
+  int info[4];
+  __cpuid(info, 1);
+  if (!((info[2] >> 27) & 1) || (_xgetbv(0) & 0xe6) != 0xe6) {
+    return false;
+  }
+  __cpuidex(info, 7, 0);
+  return ((info[1] >> 16) & 1) && ((info[1] >> 30) & 1) && ((info[2] >> 1) & 1);
+#endif
+}
+
+bool SlicedAvx512Available() {
+  static const bool supported = DetectAvx512();
+  return supported;
+}
+
+/*
+ * Four independent 128-bit lanes, lane l holds bytes 128 * l .. 128 * l + 127 of the batch.
+ * Broadcasts and unpacks use the zero-masked forms with every element selected: the
+ * plain GCC intrinsics merge into _mm512_undefined_*, whose self-initialised __Y trips
+ * -Wuninitialized, and compile to the same instructions.
+ */
+struct Avx512Ops {
+  using Vec = __m512i;
+  static constexpr size_t kLanes = 4;
+  static constexpr bool kPermuteBytes = true;
+
+  static Vec Load(const uint8_t *in, size_t i) {
+    Vec v = _mm512_zextsi128_si512(_mm_loadu_si128((const __m128i *) (in + 16 * i)));
+    v = _mm512_inserti32x4(v, _mm_loadu_si128((const __m128i *) (in + 128 + 16 * i)), 1);
+    v = _mm512_inserti32x4(v, _mm_loadu_si128((const __m128i *) (in + 256 + 16 * i)), 2);
+    return _mm512_inserti32x4(v, _mm_loadu_si128((const __m128i *) (in + 384 + 16 * i)), 3);
+  }
+
+#if defined(__GNUC__) && !defined(__clang__)
+#pragma GCC diagnostic push
+/* GCC folds even the zero-masked extract back into the one merging into _mm_undefined_si128 */
+#pragma GCC diagnostic ignored "-Wuninitialized"
+#endif
+  static void Store(uint8_t *out, size_t i, Vec v) {
+    _mm_storeu_si128((__m128i *) (out + 16 * i), _mm512_castsi512_si128(v));
+    _mm_storeu_si128((__m128i *) (out + 128 + 16 * i), _mm512_extracti32x4_epi32(v, 1));
+    _mm_storeu_si128((__m128i *) (out + 256 + 16 * i), _mm512_extracti32x4_epi32(v, 2));
+    _mm_storeu_si128((__m128i *) (out + 384 + 16 * i), _mm512_extracti32x4_epi32(v, 3));
+  }
+#if defined(__GNUC__) && !defined(__clang__)
+#pragma GCC diagnostic pop
+#endif
+
+  static Vec Broadcast(__m128i x) { return _mm512_maskz_broadcast_i32x4(0xffff, x); }
+
+  static Vec LoadKey(const uint64_t *words) {
+    return Broadcast(_mm_loadu_si128((const __m128i *) words));
+  }
+
+  static Vec Table(const SlicedTable &table) {
+    return Broadcast(_mm_load_si128((const __m128i *) table.bytes));
+  }
+
+  /* Whole S-box: VPERMI2B looks up the lower 7 bits in each half, bit 7 picks the half. */
+  static Vec Permute(Vec x, const uint8_t *sbox) {
+    const Vec low = _mm512_permutex2var_epi8(_mm512_loadu_si512(sbox), x, _mm512_loadu_si512(sbox + 64));
+    const Vec high = _mm512_permutex2var_epi8(_mm512_loadu_si512(sbox + 128), x, _mm512_loadu_si512(sbox + 192));
+    return _mm512_mask_blend_epi8(_mm512_movepi8_mask(x), low, high);
+  }
+
+  static Vec Zero() { return _mm512_setzero_si512(); }
+  static Vec Set1(uint8_t byte) { return _mm512_set1_epi8((char) byte); }
+  static Vec Xor(Vec a, Vec b) { return _mm512_xor_si512(a, b); }
+  static Vec And(Vec a, Vec b) { return _mm512_and_si512(a, b); }
+  static Vec Shuffle(Vec a, Vec index) { return _mm512_shuffle_epi8(a, index); }
+  static Vec AddSaturate(Vec a, Vec b) { return _mm512_adds_epu8(a, b); }
+  static Vec Sub8(Vec a, Vec b) { return _mm512_sub_epi8(a, b); }
+  static Vec ShiftRight4(Vec a) { return _mm512_srli_epi16(a, 4); }
+  static Vec Add64(Vec a, Vec b) { return _mm512_add_epi64(a, b); }
+  static Vec Sub64(Vec a, Vec b) { return _mm512_sub_epi64(a, b); }
+  static Vec UnpackLow16(Vec a, Vec b) { return _mm512_unpacklo_epi16(a, b); }
+  static Vec UnpackHigh16(Vec a, Vec b) { return _mm512_unpackhi_epi16(a, b); }
+  static Vec UnpackLow32(Vec a, Vec b) { return _mm512_maskz_unpacklo_epi32(0xffff, a, b); }
+  static Vec UnpackHigh32(Vec a, Vec b) { return _mm512_maskz_unpackhi_epi32(0xffff, a, b); }
+  static Vec UnpackLow64(Vec a, Vec b) { return _mm512_maskz_unpacklo_epi64(0xff, a, b); }
+  static Vec UnpackHigh64(Vec a, Vec b) { return _mm512_maskz_unpackhi_epi64(0xff, a, b); }
+};
+
+size_t SlicedAvx512EncipherBlocks(const uint8_t *in, uint8_t *out, size_t blocks, size_t nb, size_t nr,
+                                  const uint64_t *round_keys) {
+  return Sliced<Avx512Ops>::EncipherBlocks(in, out, blocks, nb, nr, round_keys);
+}
+
+size_t SlicedAvx512DecipherBlocks(const uint8_t *in, uint8_t *out, size_t blocks, size_t nb, size_t nr,
+                                  const uint64_t *round_keys) {
+  return Sliced<Avx512Ops>::DecipherBlocks(in, out, blocks, nb, nr, round_keys);
+}
+
+#else
+
+#include <stdexcept>
+
+bool SlicedAvx512Available() {
+  return false;
+}
+
+size_t SlicedAvx512EncipherBlocks(const uint8_t *, uint8_t *, size_t, size_t, size_t, const uint64_t *) {
+  throw std::logic_error("AVX-512 support is not compiled in");
+}
+
+size_t SlicedAvx512DecipherBlocks(const uint8_t *, uint8_t *, size_t, size_t, size_t, const uint64_t *) {
+  throw std::logic_error("AVX-512 support is not compiled in");
+}
+
+#endif
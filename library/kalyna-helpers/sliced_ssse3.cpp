@@ -0,0 +1,92 @@
+#include "sliced_ssse3.h"
+#include "sliced.h"
+
+#ifdef AES_KALYNA_AESNI
+
+#if defined(__x86_64__) || defined(__i386__)
+#include <cpuid.h>
+#elif defined(_M_X64) || defined(_M_IX86)
+#include <intrin.h>
+#endif
+
+#include <tmmintrin.h>
+
+bool SlicedSsse3Available() {
+#if defined(__x86_64__) || defined(__i386__)
+  unsigned int eax, ebx, ecx, edx;
+  static const bool supported = __get_cpuid(1, &eax, &ebx, &ecx, &edx) && ((ecx >> 9u) & 1u);
+#else
+  int info[4];
+  __cpuid(info, 1);
+  static const bool supported = (info[2] >> 9) & 1;
+#endif
+  return supported;
+}
+
+/* One 128-bit lane, register i of a batch is bytes 16 * i .. 16 * i + 15. */
+struct Ssse3Ops {
+  using Vec = __m128i;
+  static constexpr size_t kLanes = 1;
+  static constexpr bool kPermuteBytes = false;
+
+  static Vec Load(const uint8_t *in, size_t i) {
+    return _mm_loadu_si128((const __m128i *) (in + 16 * i));
+  }
+
+  static void Store(uint8_t *out, size_t i, Vec v) {
+    _mm_storeu_si128((__m128i *) (out + 16 * i), v);
+  }
+
+  static Vec LoadKey(const uint64_t *words) {
+    return _mm_loadu_si128((const __m128i *) words);
+  }
+
+  static Vec Table(const SlicedTable &table) {
+    return _mm_load_si128((const __m128i *) table.bytes);
+  }
+
+  static Vec Zero() { return _mm_setzero_si128(); }
+  static Vec Set1(uint8_t byte) { return _mm_set1_epi8((char) byte); }
+  static Vec Xor(Vec a, Vec b) { return _mm_xor_si128(a, b); }
+  static Vec And(Vec a, Vec b) { return _mm_and_si128(a, b); }
+  static Vec Shuffle(Vec a, Vec index) { return _mm_shuffle_epi8(a, index); }
+  static Vec AddSaturate(Vec a, Vec b) { return _mm_adds_epu8(a, b); }
+  static Vec Sub8(Vec a, Vec b) { return _mm_sub_epi8(a, b); }
+  static Vec ShiftRight4(Vec a) { return _mm_srli_epi16(a, 4); }
+  static Vec Add64(Vec a, Vec b) { return _mm_add_epi64(a, b); }
+  static Vec Sub64(Vec a, Vec b) { return _mm_sub_epi64(a, b); }
+  static Vec UnpackLow16(Vec a, Vec b) { return _mm_unpacklo_epi16(a, b); }
+  static Vec UnpackHigh16(Vec a, Vec b) { return _mm_unpackhi_epi16(a, b); }
+  static Vec UnpackLow32(Vec a, Vec b) { return _mm_unpacklo_epi32(a, b); }
+  static Vec UnpackHigh32(Vec a, Vec b) { return _mm_unpackhi_epi32(a, b); }
+  static Vec UnpackLow64(Vec a, Vec b) { return _mm_unpacklo_epi64(a, b); }
+  static Vec UnpackHigh64(Vec a, Vec b) { return _mm_unpackhi_epi64(a, b); }
+};
+
+size_t SlicedSsse3EncipherBlocks(const uint8_t *in, uint8_t *out, size_t blocks, size_t nb, size_t nr,
+                                 const uint64_t *round_keys) {
+  return Sliced<Ssse3Ops>::EncipherBlocks(in, out, blocks, nb, nr, round_keys);
+}
+
+size_t SlicedSsse3DecipherBlocks(const uint8_t *in, uint8_t *out, size_t blocks, size_t nb, size_t nr,
+                                 const uint64_t *round_keys) {
+  return Sliced<Ssse3Ops>::DecipherBlocks(in, out, blocks, nb, nr, round_keys);
+}
+
+#else
+
+#include <stdexcept>
+
+bool SlicedSsse3Available() {
+  return false;
+}
+
+size_t SlicedSsse3EncipherBlocks(const uint8_t *, uint8_t *, size_t, size_t, size_t, const uint64_t *) {
+  throw std::logic_error("SSSE3 support is not compiled in");
+}
+
+size_t SlicedSsse3DecipherBlocks(const uint8_t *, uint8_t *, size_t, size_t, size_t, const uint64_t *) {
+  throw std::logic_error("SSSE3 support is not compiled in");
+}
+
+#endif
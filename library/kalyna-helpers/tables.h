@@ -9,4 +9,10 @@ extern const uint8_t mds_inv_matrix[8][8];
 extern const uint8_t sboxes_enc[4][256];
 extern const uint8_t sboxes_dec[4][256];
 
+/* Column of the MDS matrix multiplied by the S-box output, one table per byte of the state word. */
+extern const uint64_t mds_sbox_enc[8][256];
+
+/* Column of the inverse MDS matrix multiplied by the inverse S-box output. */
+extern const uint64_t mds_sbox_dec[8][256];
+
 #endif //AES_KALYNA_LIBRARY_KALYNA_HELPERS_TABLES_H_
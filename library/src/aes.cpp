@@ -1,12 +1,17 @@
 #include <cstring>
 #include <stdexcept>
 
-#include <iostream>
-
 #include "aes.h"
+#include "aes_modes.h"
+#include "aesni.h"
+#include "perf_counters.h"
 #include "transformations.h"
+#include "ttable.h"
+#include "workers.h"
 
-AES::AES(int keyLen) {
+AES::AES(int keyLen, AESBackend backend)
+    : backend(backend), threads(std::thread::hardware_concurrency() ? std::thread::hardware_concurrency() : 1),
+      parallelBytes(kDefaultParallelBytes), pool(nullptr) {
   switch (keyLen) {
     case 128: {
       Nk = 4;
@@ -27,43 +32,58 @@ AES::AES(int keyLen) {
       throw std::invalid_argument("Incorrect key length");
     }
   }
-}
 
-uint8_t *AES::EncryptECB(uint8_t in[], uint32_t inLen, uint8_t key[], uint32_t &outLen) {
-  outLen = GetPaddingLength(inLen, blockBytesLen);
-  uint8_t *alignIn = PaddingNulls(in, inLen, outLen);
-  auto *out = new uint8_t[outLen];
-  auto *roundKeys = new uint8_t[4 * Nb * (Nr + 1)];
-  KeyExpansion(key, roundKeys);
-  for (uint32_t i = 0; i < outLen; i += blockBytesLen) {
-    EncryptBlock(alignIn + i, out + i, roundKeys);
+  if (backend == AESBackend::kAuto) {
+    this->backend = AesNiAvailable() ? AESBackend::kAesNi : AESBackend::kTTable;
+  } else if (backend == AESBackend::kAesNi && !AesNiAvailable()) {
+    throw std::invalid_argument("AES-NI is not supported on this CPU");
   }
+}
 
-  delete[] alignIn;
-  delete[] roundKeys;
-
-  return out;
+AESBackend AES::Backend() const {
+  return backend;
 }
 
-uint8_t *AES::DecryptECB(uint8_t in[], uint32_t inLen, uint8_t key[]) {
-  auto *out = new uint8_t[inLen];
-  auto *roundKeys = new uint8_t[4 * Nb * (Nr + 1)];
-  KeyExpansion(key, roundKeys);
-  for (uint32_t i = 0; i < inLen; i += blockBytesLen) {
-    DecryptBlock(in + i, out + i, roundKeys);
-  }
+AesKey::AesKey(size_t rounds) : rounds(rounds) {}
 
-  delete[] roundKeys;
+size_t AesKey::Rounds() const {
+  return rounds;
+}
 
-  return out;
+AesKey AES::ExpandKey(const uint8_t key[]) const {
+  const PerfKeyScope perf(PerfCipher::kAes, 1);
+  AesKey expanded(Nr);
+  KeyExpansion(key, expanded.encKeys);
+  InvKeyExpansion(expanded.encKeys, expanded.decKeys);
+  return expanded;
+}
+
+void AES::CheckKey(const AesKey &key) const {
+  if (key.rounds != Nr) {
+    throw std::invalid_argument("Key was expanded for another key length");
+  }
 }
 
 void AES::EncryptBlock(const uint8_t in[], uint8_t out[], const uint8_t *roundKeys) const {
-  auto **state = new uint8_t *[4];
-  state[0] = new uint8_t[4 * Nb];
+  switch (backend) {
+    case AESBackend::kAesNi: {
+      AesNiEncryptBlock(in, out, roundKeys, Nr);
+      return;
+    }
+    case AESBackend::kTTable: {
+      TTableEncryptBlock(in, out, roundKeys, Nr);
+      return;
+    }
+    default: {
+      break;
+    }
+  }
+
+  uint8_t storage[4 * 4];
+  uint8_t *state[4];
   int i, j, round;
   for (i = 0; i < 4; i++) {
-    state[i] = state[0] + Nb * i;
+    state[i] = storage + Nb * i;
   }
 
   for (i = 0; i < 4; i++) {
@@ -90,16 +110,27 @@ void AES::EncryptBlock(const uint8_t in[], uint8_t out[], const uint8_t *roundKe
       out[i + 4 * j] = state[i][j];
     }
   }
-
-  delete[] state[0];
-  delete[] state;
 }
 
 void AES::DecryptBlock(const uint8_t in[], uint8_t out[], const uint8_t *roundKeys) const {
-  auto **state = new uint8_t *[4];
-  state[0] = new uint8_t[4 * Nb];
+  switch (backend) {
+    case AESBackend::kAesNi: {
+      AesNiDecryptBlock(in, out, roundKeys, Nr);
+      return;
+    }
+    case AESBackend::kTTable: {
+      TTableDecryptBlock(in, out, roundKeys, Nr);
+      return;
+    }
+    default: {
+      break;
+    }
+  }
+
+  uint8_t storage[4 * 4];
+  uint8_t *state[4];
   for (size_t i = 0; i < 4; i++) {
-    state[i] = state[0] + Nb * i;
+    state[i] = storage + Nb * i;
   }
 
   for (size_t i = 0; i < 4; i++) {
@@ -108,32 +139,72 @@ void AES::DecryptBlock(const uint8_t in[], uint8_t out[], const uint8_t *roundKe
     }
   }
 
-  AddRoundKey(state, roundKeys + Nr * 4 * Nb, Nb);
+  AddRoundKey(state, roundKeys, Nb);
 
-  for (size_t round = Nr - 1; round >= 1; round--) {
+  for (size_t round = 1; round <= Nr - 1; round++) {
     InvSubBytes(state, Nb);
     InvShiftRows(state, Nb);
-    AddRoundKey(state, roundKeys + round * 4 * Nb, Nb);
     InvMixColumns(state, Nb);
+    AddRoundKey(state, roundKeys + round * 4 * Nb, Nb);
   }
 
   InvSubBytes(state, Nb);
   InvShiftRows(state, Nb);
-  AddRoundKey(state, roundKeys, Nb);
+  AddRoundKey(state, roundKeys + Nr * 4 * Nb, Nb);
 
   for (size_t i = 0; i < 4; i++) {
     for (size_t j = 0; j < Nb; j++) {
       out[i + 4 * j] = state[i][j];
     }
   }
+}
 
-  delete[] state[0];
-  delete[] state;
+void AES::EncryptBlocks(const uint8_t in[], uint8_t out[], size_t blocks, const uint8_t *roundKeys) const {
+  switch (backend) {
+    case AESBackend::kAesNi: {
+      AesNiEncryptBlocks(in, out, blocks, roundKeys, Nr);
+      return;
+    }
+    case AESBackend::kTTable: {
+      TTableEncryptBlocks(in, out, blocks, roundKeys, Nr);
+      return;
+    }
+    default: {
+      for (size_t i = 0; i < blocks; i++) {
+        EncryptBlock(in + i * blockBytesLen, out + i * blockBytesLen, roundKeys);
+      }
+      return;
+    }
+  }
+}
+
+void AES::DecryptBlocks(const uint8_t in[], uint8_t out[], size_t blocks, const uint8_t *roundKeys) const {
+  switch (backend) {
+    case AESBackend::kAesNi: {
+      AesNiDecryptBlocks(in, out, blocks, roundKeys, Nr);
+      return;
+    }
+    case AESBackend::kTTable: {
+      TTableDecryptBlocks(in, out, blocks, roundKeys, Nr);
+      return;
+    }
+    default: {
+      for (size_t i = 0; i < blocks; i++) {
+        DecryptBlock(in + i * blockBytesLen, out + i * blockBytesLen, roundKeys);
+      }
+      return;
+    }
+  }
 }
 
 void AES::KeyExpansion(const uint8_t key[], uint8_t w[]) const {
-  auto *temp = new uint8_t[4];
-  auto *rcon = new uint8_t[4];
+  if (backend == AESBackend::kAesNi) {
+    AesNiKeyExpansion(key, w, Nk, Nr);
+    return;
+  }
+
+  uint8_t temp[4];
+  uint8_t rcon[4];
 
   for (size_t i = 0; i < 4 * Nk; i++) {
     w[i] = key[i];
@@ -159,183 +230,231 @@ void AES::KeyExpansion(const uint8_t key[], uint8_t w[]) const {
     w[i + 2] = w[i + 2 - 4 * Nk] ^ temp[2];
     w[i + 3] = w[i + 3 - 4 * Nk] ^ temp[3];
   }
-
-  delete[] rcon;
-  delete[] temp;
 }
 
-uint8_t *AES::EncryptCBC(uint8_t in[], uint32_t inLen, uint8_t key[], uint8_t *iv, uint32_t &outLen) {
-  outLen = GetPaddingLength(inLen, blockBytesLen);
-  uint8_t *alignIn = PaddingNulls(in, inLen, outLen);
-  auto *out = new uint8_t[outLen];
-  auto *block = new uint8_t[blockBytesLen];
-  auto *roundKeys = new uint8_t[4 * Nb * (Nr + 1)];
-  KeyExpansion(key, roundKeys);
-  memcpy(block, iv, blockBytesLen);
-  for (uint32_t i = 0; i < outLen; i += blockBytesLen) {
-    XorBlocks(block, alignIn + i, block, blockBytesLen);
-    EncryptBlock(block, out + i, roundKeys);
-    memcpy(block, out + i, blockBytesLen);
+void AES::InvKeyExpansion(const uint8_t w[], uint8_t dw[]) const {
+  if (backend == AESBackend::kAesNi) {
+    AesNiInvKeyExpansion(w, dw, Nr);
+    return;
   }
 
-  delete[] block;
-  delete[] alignIn;
-  delete[] roundKeys;
+  const size_t roundBytes = 4 * Nb;
+  for (size_t round = 0; round <= Nr; round++) {
+    memcpy(dw + round * roundBytes, w + (Nr - round) * roundBytes, roundBytes);
+  }
 
-  return out;
+  // InvMixColumns is linear, so it can be moved from the state to the inner round keys
+  for (size_t round = 1; round < Nr; round++) {
+    for (size_t j = 0; j < Nb; j++) {
+      InvMixSingleColumn(dw + round * roundBytes + 4 * j);
+    }
+  }
 }
 
-uint8_t *AES::DecryptCBC(uint8_t in[], uint32_t inLen, uint8_t key[], uint8_t *iv) {
-  auto *out = new uint8_t[inLen];
-  auto *block = new uint8_t[blockBytesLen];
-  auto *roundKeys = new uint8_t[4 * Nb * (Nr + 1)];
-  KeyExpansion(key, roundKeys);
-  memcpy(block, iv, blockBytesLen);
-  for (uint32_t i = 0; i < inLen; i += blockBytesLen) {
-    DecryptBlock(in + i, out + i, roundKeys);
-    XorBlocks(block, out + i, out + i, blockBytesLen);
-    memcpy(block, in + i, blockBytesLen);
-  }
+void AES::SetParallelism(size_t threads, size_t minBytes) {
+  this->threads = threads ? threads : 1;
+  parallelBytes = minBytes;
+}
 
-  delete[] block;
-  delete[] roundKeys;
+size_t AES::Threads() const {
+  return threads;
+}
 
-  return out;
+void AES::SetWorkerPool(WorkerPool *pool) {
+  this->pool = pool;
 }
 
-uint8_t *AES::EncryptCFB(uint8_t in[], uint32_t s, uint32_t inLen, uint8_t key[], uint8_t *iv, uint32_t &outLen) {
-  outLen = GetPaddingLength(inLen, blockBytesLen);
-  uint8_t *alignIn = PaddingNulls(in, inLen, outLen);
-  auto *out = new uint8_t[outLen];
-  auto *block = new uint8_t[blockBytesLen];
-  auto *encryptedBlock = new uint8_t[blockBytesLen];
-  auto *roundKeys = new uint8_t[4 * Nb * (Nr + 1)];
-  KeyExpansion(key, roundKeys);
-  memcpy(block, iv, blockBytesLen);
-  for (uint32_t i = 0; i < outLen; i += blockBytesLen) {
-    EncryptBlock(block, encryptedBlock, roundKeys);
-    XorBlocks(alignIn + i, encryptedBlock, out + i, blockBytesLen);
-    memcpy(block, block + s, blockBytesLen - s);
-    memcpy(block + blockBytesLen - s, out + i, s);
+WorkerPool &AES::Pool() const {
+  return pool ? *pool : WorkerPool::Shared();
+}
+
+size_t AES::Parts(size_t blocks) const {
+  if (threads <= 1 || blocks * blockBytesLen < parallelBytes) {
+    return 1;
   }
+  size_t parts = threads < AesModes::kMaxParts ? threads : AesModes::kMaxParts;
+  return parts < blocks ? parts : blocks;
+}
+
+void AES::EncryptECB(const uint8_t in[], uint8_t out[], size_t len, const AesKey &key) const {
+  CheckKey(key);
+  const PerfModeScope perf(PerfCipher::kAes, (size_t) backend, PerfMode::kECB, true, len, blockBytesLen);
+  AesModes(*this, key).EncryptECB(in, out, len);
+}
 
-  delete[] block;
-  delete[] encryptedBlock;
-  delete[] alignIn;
-  delete[] roundKeys;
+void AES::DecryptECB(const uint8_t in[], uint8_t out[], size_t len, const AesKey &key) const {
+  CheckKey(key);
+  const PerfModeScope perf(PerfCipher::kAes, (size_t) backend, PerfMode::kECB, false, len, blockBytesLen);
+  AesModes(*this, key).DecryptECB(in, out, len);
+}
+
+void AES::EncryptCBC(const uint8_t in[], uint8_t out[], size_t len, const AesKey &key, const uint8_t iv[]) const {
+  CheckKey(key);
+  const PerfModeScope perf(PerfCipher::kAes, (size_t) backend, PerfMode::kCBC, true, len, blockBytesLen);
+  AesModes(*this, key).EncryptCBC(in, out, len, iv);
+}
+
+void AES::DecryptCBC(const uint8_t in[], uint8_t out[], size_t len, const AesKey &key, const uint8_t iv[]) const {
+  CheckKey(key);
+  const PerfModeScope perf(PerfCipher::kAes, (size_t) backend, PerfMode::kCBC, false, len, blockBytesLen);
+  AesModes(*this, key).DecryptCBC(in, out, len, iv);
+}
+
+void AES::EncryptCFB(const uint8_t in[], uint8_t out[], size_t len, uint32_t s, const AesKey &key,
+                     const uint8_t iv[]) const {
+  CheckKey(key);
+  const PerfModeScope perf(PerfCipher::kAes, (size_t) backend, PerfMode::kCFB, true, len, blockBytesLen);
+  AesModes(*this, key).EncryptCFB(in, out, len, s, iv);
+}
+
+void AES::DecryptCFB(const uint8_t in[], uint8_t out[], size_t len, uint32_t s, const AesKey &key,
+                     const uint8_t iv[]) const {
+  CheckKey(key);
+  const PerfModeScope perf(PerfCipher::kAes, (size_t) backend, PerfMode::kCFB, false, len, blockBytesLen);
+  AesModes(*this, key).DecryptCFB(in, out, len, s, iv);
+}
+
+void AES::EncryptOFB(const uint8_t in[], uint8_t out[], size_t len, const AesKey &key, const uint8_t iv[]) const {
+  CheckKey(key);
+  const PerfModeScope perf(PerfCipher::kAes, (size_t) backend, PerfMode::kOFB, true, len, blockBytesLen);
+  AesModes(*this, key).EncryptOFB(in, out, len, iv);
+}
+
+void AES::DecryptOFB(const uint8_t in[], uint8_t out[], size_t len, const AesKey &key, const uint8_t iv[]) const {
+  CheckKey(key);
+  const PerfModeScope perf(PerfCipher::kAes, (size_t) backend, PerfMode::kOFB, false, len, blockBytesLen);
+  AesModes(*this, key).EncryptOFB(in, out, len, iv);
+}
+
+void AES::EncryptCTR(const uint8_t in[], uint8_t out[], size_t len, const AesKey &key,
+                     const uint8_t counter[], uint64_t offset) const {
+  CheckKey(key);
+  const PerfModeScope perf(PerfCipher::kAes, (size_t) backend, PerfMode::kCTR, true, len, blockBytesLen);
+  AesModes(*this, key).EncryptCTR(in, out, len, counter, offset);
+}
+
+void AES::DecryptCTR(const uint8_t in[], uint8_t out[], size_t len, const AesKey &key,
+                     const uint8_t counter[], uint64_t offset) const {
+  CheckKey(key);
+  const PerfModeScope perf(PerfCipher::kAes, (size_t) backend, PerfMode::kCTR, false, len, blockBytesLen);
+  AesModes(*this, key).EncryptCTR(in, out, len, counter, offset);
+}
+
+// nonce and initial counter used by the CTR functions that don't take them
+static const uint8_t kDefaultCounter[] =
+    {0x00, 0x01, 0x02, 0x03, 0x04, 0x05, 0x06, 0x07, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00};
 
+uint8_t *AES::EncryptECB(uint8_t in[], uint32_t inLen, const AesKey &key, uint32_t &outLen) {
+  outLen = GetPaddingLength(inLen, blockBytesLen);
+  uint8_t *out = PaddingNulls(in, inLen, outLen);
+  PerfCountAllocation(outLen);
+  EncryptECB(out, out, outLen, key);
   return out;
 }
 
-uint8_t *AES::DecryptCFB(uint8_t in[], uint32_t s, uint32_t inLen, uint8_t key[], uint8_t *iv) {
+uint8_t *AES::DecryptECB(uint8_t in[], uint32_t inLen, const AesKey &key) {
   auto *out = new uint8_t[inLen];
-  auto *block = new uint8_t[blockBytesLen];
-  auto *encryptedBlock = new uint8_t[blockBytesLen];
-  auto *roundKeys = new uint8_t[4 * Nb * (Nr + 1)];
-  KeyExpansion(key, roundKeys);
-  memcpy(block, iv, blockBytesLen);
-  for (uint32_t i = 0; i < inLen; i += blockBytesLen) {
-    EncryptBlock(block, encryptedBlock, roundKeys);
-    XorBlocks(in + i, encryptedBlock, out + i, blockBytesLen);
-    memcpy(block, block + s, blockBytesLen - s);
-    memcpy(block + blockBytesLen - s, in + i, s);
-  }
+  PerfCountAllocation(inLen);
+  DecryptECB(in, out, inLen, key);
+  return out;
+}
 
-  delete[] block;
-  delete[] encryptedBlock;
-  delete[] roundKeys;
+uint8_t *AES::EncryptCBC(uint8_t in[], uint32_t inLen, const AesKey &key, uint8_t *iv, uint32_t &outLen) {
+  outLen = GetPaddingLength(inLen, blockBytesLen);
+  uint8_t *out = PaddingNulls(in, inLen, outLen);
+  PerfCountAllocation(outLen);
+  EncryptCBC(out, out, outLen, key, iv);
+  return out;
+}
 
+uint8_t *AES::DecryptCBC(uint8_t in[], uint32_t inLen, const AesKey &key, uint8_t *iv) {
+  auto *out = new uint8_t[inLen];
+  PerfCountAllocation(inLen);
+  DecryptCBC(in, out, inLen, key, iv);
   return out;
 }
 
-uint8_t *AES::EncryptOFB(uint8_t in[], uint32_t inLen, uint8_t key[], uint8_t *iv, uint32_t &outLen) {
+uint8_t *AES::EncryptCFB(uint8_t in[], uint32_t s, uint32_t inLen, const AesKey &key, uint8_t *iv, uint32_t &outLen) {
   outLen = GetPaddingLength(inLen, blockBytesLen);
-  uint8_t *alignIn = PaddingNulls(in, inLen, outLen);
-  auto *out = new uint8_t[outLen];
-  auto *block = new uint8_t[blockBytesLen];
-  auto *encryptedBlock = new uint8_t[blockBytesLen];
-  auto *roundKeys = new uint8_t[4 * Nb * (Nr + 1)];
-  KeyExpansion(key, roundKeys);
-  memcpy(block, iv, blockBytesLen);
-  for (uint32_t i = 0; i < outLen; i += blockBytesLen) {
-    EncryptBlock(block, encryptedBlock, roundKeys);
-    memcpy(block, encryptedBlock, blockBytesLen);
-    XorBlocks(alignIn + i, encryptedBlock, out + i, blockBytesLen);
-  }
+  uint8_t *out = PaddingNulls(in, inLen, outLen);
+  PerfCountAllocation(outLen);
+  EncryptCFB(out, out, outLen, s, key, iv);
+  return out;
+}
 
-  delete[] block;
-  delete[] encryptedBlock;
-  delete[] alignIn;
-  delete[] roundKeys;
+uint8_t *AES::DecryptCFB(uint8_t in[], uint32_t s, uint32_t inLen, const AesKey &key, uint8_t *iv) {
+  auto *out = new uint8_t[inLen];
+  PerfCountAllocation(inLen);
+  DecryptCFB(in, out, inLen, s, key, iv);
+  return out;
+}
 
+uint8_t *AES::EncryptOFB(uint8_t in[], uint32_t inLen, const AesKey &key, uint8_t *iv, uint32_t &outLen) {
+  outLen = GetPaddingLength(inLen, blockBytesLen);
+  uint8_t *out = PaddingNulls(in, inLen, outLen);
+  PerfCountAllocation(outLen);
+  EncryptOFB(out, out, outLen, key, iv);
   return out;
 }
 
-uint8_t *AES::DecryptOFB(uint8_t in[], uint32_t inLen, uint8_t key[], uint8_t *iv) {
+uint8_t *AES::DecryptOFB(uint8_t in[], uint32_t inLen, const AesKey &key, uint8_t *iv) {
   auto *out = new uint8_t[inLen];
-  auto *block = new uint8_t[blockBytesLen];
-  auto *encryptedBlock = new uint8_t[blockBytesLen];
-  auto *roundKeys = new uint8_t[4 * Nb * (Nr + 1)];
-  KeyExpansion(key, roundKeys);
-  memcpy(block, iv, blockBytesLen);
-  for (uint32_t i = 0; i < inLen; i += blockBytesLen) {
-    EncryptBlock(block, encryptedBlock, roundKeys);
-    memcpy(block, encryptedBlock, blockBytesLen);
-    XorBlocks(in + i, encryptedBlock, out + i, blockBytesLen);
-  }
+  PerfCountAllocation(inLen);
+  DecryptOFB(in, out, inLen, key, iv);
+  return out;
+}
 
-  delete[] block;
-  delete[] encryptedBlock;
-  delete[] roundKeys;
+uint8_t *AES::EncryptCTR(uint8_t in[], uint32_t inLen, const AesKey &key, uint32_t &outLen) {
+  outLen = GetPaddingLength(inLen, blockBytesLen);
+  uint8_t *out = PaddingNulls(in, inLen, outLen);
+  PerfCountAllocation(outLen);
+  EncryptCTR(out, out, outLen, key, kDefaultCounter);
+  return out;
+}
 
+uint8_t *AES::DecryptCTR(uint8_t in[], uint32_t inLen, const AesKey &key) {
+  auto *out = new uint8_t[inLen];
+  PerfCountAllocation(inLen);
+  DecryptCTR(in, out, inLen, key, kDefaultCounter);
   return out;
 }
 
-uint8_t *AES::EncryptCTR(uint8_t in[], uint32_t inLen, uint8_t key[], uint32_t &outLen) {
-  unsigned char nonce[] = {0x00, 0x01, 0x02, 0x03, 0x04, 0x05, 0x06, 0x07};
-  unsigned char ctr[] = {0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00};
-  unsigned char nc[sizeof(nonce) + sizeof(ctr)];
-  memcpy(nc, nonce, sizeof(nonce));
+uint8_t *AES::EncryptECB(uint8_t in[], uint32_t inLen, uint8_t key[], uint32_t &outLen) {
+  return EncryptECB(in, inLen, ExpandKey(key), outLen);
+}
 
-  outLen = GetPaddingLength(inLen, blockBytesLen);
-  uint8_t *alignIn = PaddingNulls(in, inLen, outLen);
-  auto *out = new uint8_t[outLen];
-  auto *encryptedBlock = new uint8_t[blockBytesLen];
-  auto *roundKeys = new uint8_t[4 * Nb * (Nr + 1)];
-  KeyExpansion(key, roundKeys);
-
-  for (uint32_t i = 0; i < outLen; i += blockBytesLen) {
-    memcpy(nc + sizeof(nonce), ctr, sizeof(ctr));
-    EncryptBlock(nc, encryptedBlock, roundKeys);
-    XorBlocks(alignIn + i, encryptedBlock, out + i, blockBytesLen);
-    memcpy(ctr, IncrementCtr(ctr, sizeof(ctr)), sizeof(ctr));
-  }
+uint8_t *AES::DecryptECB(uint8_t in[], uint32_t inLen, uint8_t key[]) {
+  return DecryptECB(in, inLen, ExpandKey(key));
+}
 
-  delete[] encryptedBlock;
-  delete[] alignIn;
-  delete[] roundKeys;
+uint8_t *AES::EncryptCBC(uint8_t in[], uint32_t inLen, uint8_t key[], uint8_t *iv, uint32_t &outLen) {
+  return EncryptCBC(in, inLen, ExpandKey(key), iv, outLen);
+}
 
-  return out;
+uint8_t *AES::DecryptCBC(uint8_t in[], uint32_t inLen, uint8_t key[], uint8_t *iv) {
+  return DecryptCBC(in, inLen, ExpandKey(key), iv);
 }
 
-uint8_t *AES::DecryptCTR(uint8_t in[], uint32_t inLen, uint8_t key[]) {
-  unsigned char nonce[] = {0x00, 0x01, 0x02, 0x03, 0x04, 0x05, 0x06, 0x07};
-  unsigned char ctr[] = {0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00};
-  unsigned char nc[sizeof(nonce) + sizeof(ctr)];
-  memcpy(nc, nonce, sizeof(nonce));
-  auto *out = new uint8_t[inLen];
-  auto *encryptedBlock = new uint8_t[blockBytesLen];
-  auto *roundKeys = new uint8_t[4 * Nb * (Nr + 1)];
-  KeyExpansion(key, roundKeys);
-  for (uint32_t i = 0; i < inLen; i += blockBytesLen) {
-    memcpy(nc + sizeof(nonce), ctr, sizeof(ctr));
-    EncryptBlock(nc, encryptedBlock, roundKeys);
-    XorBlocks(in + i, encryptedBlock, out + i, blockBytesLen);
-    memcpy(ctr, IncrementCtr(ctr, sizeof(ctr)), sizeof(ctr));
-  }
+uint8_t *AES::EncryptCFB(uint8_t in[], uint32_t s, uint32_t inLen, uint8_t key[], uint8_t *iv, uint32_t &outLen) {
+  return EncryptCFB(in, s, inLen, ExpandKey(key), iv, outLen);
+}
 
-  delete[] encryptedBlock;
-  delete[] roundKeys;
+uint8_t *AES::DecryptCFB(uint8_t in[], uint32_t s, uint32_t inLen, uint8_t key[], uint8_t *iv) {
+  return DecryptCFB(in, s, inLen, ExpandKey(key), iv);
+}
 
-  return out;
+uint8_t *AES::EncryptOFB(uint8_t in[], uint32_t inLen, uint8_t key[], uint8_t *iv, uint32_t &outLen) {
+  return EncryptOFB(in, inLen, ExpandKey(key), iv, outLen);
+}
+
+uint8_t *AES::DecryptOFB(uint8_t in[], uint32_t inLen, uint8_t key[], uint8_t *iv) {
+  return DecryptOFB(in, inLen, ExpandKey(key), iv);
+}
+
+uint8_t *AES::EncryptCTR(uint8_t in[], uint32_t inLen, uint8_t key[], uint32_t &outLen) {
+  return EncryptCTR(in, inLen, ExpandKey(key), outLen);
+}
+
+uint8_t *AES::DecryptCTR(uint8_t in[], uint32_t inLen, uint8_t key[]) {
+  return DecryptCTR(in, inLen, ExpandKey(key));
 }
@@ -0,0 +1,244 @@
+#include <cstring>
+#include <stdexcept>
+
+#include "aes_gcm.h"
+#include "clmul.h"
+#include "ghash.h"
+#include "perf_counters.h"
+#include "transformations.h"
+
+// 2^39 - 256 bits of plaintext per invocation
+static const uint64_t kMaxLength = (1ULL << 36u) - 32;
+
+// the last 4 bytes are the counter, the rest of the block never changes
+static void Inc32(uint8_t block[]) {
+  for (int i = 15; i >= 12; i--) {
+    if (++block[i]) {
+      break;
+    }
+  }
+}
+
+static void StoreBigEndian64(uint64_t v, uint8_t *p) {
+  for (int i = 7; i >= 0; i--, v >>= 8u) {
+    p[i] = (uint8_t) v;
+  }
+}
+
+AesGcm::AesGcm(const AES &aes, const AesKey &key, bool encrypt, GhashBackend ghash)
+    : aes(aes), key(key), encrypt(encrypt), ghash(ghash), stitched(false), tableHi(), tableLo(), powers(),
+      tagMask(), x(), counter(), keystream(), pending(), used(0), aadLength(0), length(0), started(false),
+      dataStarted(false) {
+  aes.CheckKey(key);
+  if (ghash == GhashBackend::kAuto) {
+    this->ghash = ClmulAvailable() ? GhashBackend::kClmul : GhashBackend::kTable;
+  } else if (ghash == GhashBackend::kClmul && !ClmulAvailable()) {
+    throw std::invalid_argument("PCLMULQDQ is not supported on this CPU");
+  }
+  stitched = this->ghash == GhashBackend::kClmul && aes.Backend() == AESBackend::kAesNi;
+
+  uint8_t h[16] = {};
+  aes.EncryptBlock(h, h, this->key.encKeys);
+  if (this->ghash == GhashBackend::kClmul) {
+    ClmulGhashInit(h, powers);
+  } else {
+    GhashInit(h, tableHi, tableLo);
+  }
+}
+
+GhashBackend AesGcm::Backend() const {
+  return ghash;
+}
+
+void AesGcm::Hash(const uint8_t data[], size_t blocks) {
+  if (ghash == GhashBackend::kClmul) {
+    ClmulGhashBlocks(x, data, blocks, powers);
+  } else {
+    GhashBlocks(x, data, blocks, tableHi, tableLo);
+  }
+}
+
+void AesGcm::Init(const uint8_t iv[], size_t ivLen) {
+  if (ivLen == 0) {
+    throw std::invalid_argument("GCM IV must not be empty");
+  }
+
+  memset(x, 0, sizeof(x));
+  if (ivLen == 12) {
+    memcpy(counter, iv, ivLen);
+    memset(counter + 12, 0, 3);
+    counter[15] = 1;
+  } else {
+    // J0 = GHASH(IV || zero padding || 64-bit IV length in bits)
+    const size_t blocks = ivLen / aes.blockBytesLen;
+    Hash(iv, blocks);
+    uint8_t block[16] = {};
+    if (ivLen % aes.blockBytesLen) {
+      memcpy(block, iv + blocks * aes.blockBytesLen, ivLen % aes.blockBytesLen);
+      Hash(block, 1);
+    }
+    memset(block, 0, sizeof(block));
+    StoreBigEndian64((uint64_t) ivLen * 8, block + 8);
+    Hash(block, 1);
+    memcpy(counter, x, sizeof(counter));
+    memset(x, 0, sizeof(x));
+  }
+
+  aes.EncryptBlock(counter, tagMask, key.encKeys);
+  Inc32(counter);
+  used = 0;
+  aadLength = 0;
+  length = 0;
+  started = true;
+  dataStarted = false;
+}
+
+void AesGcm::UpdateAad(const uint8_t aad[], size_t len) {
+  if (!started) {
+    throw std::logic_error("AesGcm::Init was not called");
+  }
+  if (dataStarted) {
+    throw std::logic_error("AAD has to come before the data");
+  }
+  aadLength += len;
+
+  if (used > 0) {
+    const size_t chunk = aes.blockBytesLen - used < len ? aes.blockBytesLen - used : len;
+    memcpy(pending + used, aad, chunk);
+    used += chunk;
+    aad += chunk;
+    len -= chunk;
+    if (used < aes.blockBytesLen) {
+      return;
+    }
+    Hash(pending, 1);
+    used = 0;
+  }
+
+  const size_t blocks = len / aes.blockBytesLen;
+  Hash(aad, blocks);
+  used = len - blocks * aes.blockBytesLen;
+  memcpy(pending, aad + blocks * aes.blockBytesLen, used);
+}
+
+void AesGcm::FinishAad() {
+  if (dataStarted) {
+    return;
+  }
+  if (used > 0) {
+    memset(pending + used, 0, aes.blockBytesLen - used);
+    Hash(pending, 1);
+    used = 0;
+  }
+  dataStarted = true;
+}
+
+size_t AesGcm::XorKeystream(const uint8_t in[], uint8_t out[], size_t len) {
+  const size_t chunk = aes.blockBytesLen - used < len ? aes.blockBytesLen - used : len;
+  if (!encrypt) {
+    // the ciphertext is saved before out overwrites it
+    memcpy(pending + used, in, chunk);
+  }
+  XorBlocks(in, keystream + used, out, chunk);
+  if (encrypt) {
+    memcpy(pending + used, out, chunk);
+  }
+
+  used += chunk;
+  if (used == aes.blockBytesLen) {
+    Hash(pending, 1);
+    used = 0;
+  }
+  return chunk;
+}
+
+void AesGcm::Update(const uint8_t in[], uint8_t out[], size_t len) {
+  if (!started) {
+    throw std::logic_error("AesGcm::Init was not called");
+  }
+  if (len > kMaxLength - length) {
+    throw std::invalid_argument("GCM message is too long");
+  }
+  const PerfModeScope perf(PerfCipher::kAes, (size_t) aes.backend, PerfMode::kGCM, encrypt, len, aes.blockBytesLen);
+  FinishAad();
+  length += len;
+
+  size_t done = 0;
+  if (used > 0) {
+    done = XorKeystream(in, out, len);
+  }
+
+  const size_t blocks = (len - done) / aes.blockBytesLen;
+  if (stitched) {
+    if (encrypt) {
+      ClmulGcmEncryptBlocks(in + done, out + done, blocks, key.encKeys, key.rounds, counter, x, powers);
+    } else {
+      ClmulGcmDecryptBlocks(in + done, out + done, blocks, key.encKeys, key.rounds, counter, x, powers);
+    }
+    done += blocks * aes.blockBytesLen;
+  } else {
+    // counter blocks go through the multi-block kernels, GHASH follows the batch
+    const size_t kBatch = 8;
+    uint8_t counters[kBatch * 16];
+    uint8_t encryptedBlocks[kBatch * 16];
+    for (size_t first = 0; first < blocks; first += kBatch) {
+      const size_t count = blocks - first < kBatch ? blocks - first : kBatch;
+      for (size_t j = 0; j < count; j++) {
+        memcpy(counters + j * aes.blockBytesLen, counter, aes.blockBytesLen);
+        Inc32(counter);
+      }
+      aes.EncryptBlocks(counters, encryptedBlocks, count, key.encKeys);
+
+      if (!encrypt) {
+        Hash(in + done, count);
+      }
+      XorBlocks(in + done, encryptedBlocks, out + done, count * aes.blockBytesLen);
+      if (encrypt) {
+        Hash(out + done, count);
+      }
+      done += count * aes.blockBytesLen;
+    }
+  }
+
+  if (done < len) {
+    aes.EncryptBlock(counter, keystream, key.encKeys);
+    Inc32(counter);
+    XorKeystream(in + done, out + done, len - done);
+  }
+}
+
+void AesGcm::Final(uint8_t tag[], size_t tagLen) {
+  if (!started) {
+    throw std::logic_error("AesGcm::Init was not called");
+  }
+  if (tagLen < 4 || tagLen > aes.blockBytesLen) {
+    throw std::invalid_argument("Incorrect GCM tag length");
+  }
+  FinishAad();
+  if (used > 0) {
+    memset(pending + used, 0, aes.blockBytesLen - used);
+    Hash(pending, 1);
+    used = 0;
+  }
+
+  uint8_t block[16];
+  StoreBigEndian64(aadLength * 8, block);
+  StoreBigEndian64(length * 8, block + 8);
+  Hash(block, 1);
+
+  XorBlocks(x, tagMask, block, aes.blockBytesLen);
+  memcpy(tag, block, tagLen);
+  started = false;
+}
+
+bool AesGcm::Verify(const uint8_t tag[], size_t tagLen) {
+  uint8_t expected[16];
+  Final(expected, tagLen);
+
+  // no early exit, the time taken doesn't depend on where the tags differ
+  uint8_t difference = 0;
+  for (size_t i = 0; i < tagLen; i++) {
+    difference |= (uint8_t) (expected[i] ^ tag[i]);
+  }
+  return difference == 0;
+}
@@ -0,0 +1,182 @@
+#include <cstring>
+#include <stdexcept>
+
+#include "aes_modes.h"
+#include "aes_stream.h"
+#include "perf_counters.h"
+#include "transformations.h"
+
+AesStream::AesStream(const AES &aes, const AesKey &key, AesStreamMode mode, bool encrypt, uint32_t s)
+    : aes(aes), key(key), mode(mode), encrypt(encrypt), s(s), iv(), state(), buffer(), feedback(), used(0), length(0),
+      started(false) {
+  aes.CheckKey(key);
+  if (mode == AesStreamMode::kCFB) {
+    AesModes::CheckSegment(s);
+  }
+}
+
+void AesStream::Init(const uint8_t iv[]) {
+  memcpy(this->iv, iv, aes.blockBytesLen);
+  memcpy(state, iv, aes.blockBytesLen);
+  used = 0;
+  length = 0;
+  started = true;
+}
+
+size_t AesStream::XorKeystream(const uint8_t in[], uint8_t out[], size_t len) {
+  const size_t chunk = aes.blockBytesLen - used < len ? aes.blockBytesLen - used : len;
+  if (mode == AesStreamMode::kCFB && !encrypt) {
+    // the ciphertext is saved before out overwrites it
+    memcpy(feedback + used, in, chunk);
+  }
+  XorBlocks(in, buffer + used, out, chunk);
+  if (mode == AesStreamMode::kCFB && encrypt) {
+    memcpy(feedback + used, out, chunk);
+  }
+
+  used += chunk;
+  if (used == aes.blockBytesLen) {
+    if (mode == AesStreamMode::kCFB) {
+      memmove(state, state + s, aes.blockBytesLen - s);
+      memcpy(state + aes.blockBytesLen - s, feedback, s);
+    }
+    used = 0;
+  }
+  return chunk;
+}
+
+void AesStream::NextKeystream() {
+  switch (mode) {
+    case AesStreamMode::kCFB: {
+      aes.EncryptBlock(state, buffer, key.encKeys);
+      break;
+    }
+    case AesStreamMode::kOFB: {
+      aes.EncryptBlock(state, state, key.encKeys);
+      memcpy(buffer, state, aes.blockBytesLen);
+      break;
+    }
+    case AesStreamMode::kCTR: {
+      aes.EncryptBlock(state, buffer, key.encKeys);
+      AddCtr(state + aes.blockBytesLen / 2, 1);
+      break;
+    }
+    default: {
+      break;
+    }
+  }
+}
+
+size_t AesStream::Update(const uint8_t in[], uint8_t out[], size_t len) {
+  if (!started) {
+    throw std::logic_error("AesStream::Init was not called");
+  }
+  const PerfModeScope perf(PerfCipher::kAes, (size_t) aes.backend, (PerfMode) ((size_t) mode + 1), encrypt, len,
+                           aes.blockBytesLen);
+  length += len;
+
+  if (mode == AesStreamMode::kCBC) {
+    size_t written = 0;
+    if (used > 0) {
+      const size_t chunk = aes.blockBytesLen - used < len ? aes.blockBytesLen - used : len;
+      memcpy(buffer + used, in, chunk);
+      used += chunk;
+      in += chunk;
+      len -= chunk;
+      if (used < aes.blockBytesLen) {
+        return 0;
+      }
+      if (encrypt) {
+        AesModes(aes, key).CbcEncrypt(buffer, out, 1, state);
+      } else {
+        AesModes(aes, key).CbcDecrypt(buffer, out, 1, state);
+      }
+      written = aes.blockBytesLen;
+      used = 0;
+    }
+
+    const size_t blocks = len / aes.blockBytesLen;
+    if (encrypt) {
+      AesModes(aes, key).CbcEncrypt(in, out + written, blocks, state);
+    } else {
+      AesModes(aes, key).CbcDecrypt(in, out + written, blocks, state);
+    }
+    written += blocks * aes.blockBytesLen;
+
+    used = len - blocks * aes.blockBytesLen;
+    memcpy(buffer, in + blocks * aes.blockBytesLen, used);
+    return written;
+  }
+
+  size_t done = 0;
+  if (used > 0) {
+    done = XorKeystream(in, out, len);
+  }
+
+  // whole blocks go straight to the multi-block kernels
+  const size_t whole = (len - done) / aes.blockBytesLen * aes.blockBytesLen;
+  switch (mode) {
+    case AesStreamMode::kCFB: {
+      if (encrypt) {
+        AesModes(aes, key).CfbEncrypt(in + done, out + done, whole, s, state);
+      } else {
+        AesModes(aes, key).CfbDecrypt(in + done, out + done, whole, s, state);
+      }
+      break;
+    }
+    case AesStreamMode::kOFB: {
+      AesModes(aes, key).OfbXor(in + done, out + done, whole, state);
+      break;
+    }
+    default: {
+      AesModes(aes, key).CtrXor(in + done, out + done, whole, state);
+      break;
+    }
+  }
+  done += whole;
+
+  if (done < len) {
+    NextKeystream();
+    done += XorKeystream(in + done, out + done, len - done);
+  }
+  return done;
+}
+
+size_t AesStream::Final(uint8_t out[]) {
+  if (!started) {
+    throw std::logic_error("AesStream::Init was not called");
+  }
+  started = false;
+  if (mode != AesStreamMode::kCBC || used == 0) {
+    return 0;
+  }
+  if (!encrypt) {
+    throw std::invalid_argument("Ciphertext is not a whole number of blocks");
+  }
+
+  memset(buffer + used, 0, aes.blockBytesLen - used);
+  AesModes(aes, key).CbcEncrypt(buffer, out, 1, state);
+  used = 0;
+  return aes.blockBytesLen;
+}
+
+void AesStream::Seek(uint64_t offset) {
+  if (mode != AesStreamMode::kCTR) {
+    throw std::logic_error("Only CTR streams can seek");
+  }
+  if (!started) {
+    throw std::logic_error("AesStream::Init was not called");
+  }
+  memcpy(state, iv, aes.blockBytesLen);
+  AddCtr(state + aes.blockBytesLen / 2, offset / aes.blockBytesLen);
+  used = 0;
+  if (offset % aes.blockBytesLen > 0) {
+    NextKeystream();
+    used = offset % aes.blockBytesLen;
+  }
+  length = offset;
+}
+
+uint64_t AesStream::Length() const {
+  return length;
+}
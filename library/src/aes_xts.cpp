@@ -0,0 +1,175 @@
+#include <cstring>
+#include <stdexcept>
+
+#include "aes_xts.h"
+#include "perf_counters.h"
+#include "transformations.h"
+#include "workers.h"
+
+// blocks whose tweaks are computed and encrypted together
+static const size_t kBatchBlocks = 8;
+
+static uint64_t LoadLittleEndian64(const uint8_t *p) {
+  uint64_t v = 0;
+  for (int i = 7; i >= 0; i--) {
+    v = (v << 8u) | p[i];
+  }
+  return v;
+}
+
+static void StoreLittleEndian64(uint64_t v, uint8_t *p) {
+  for (int i = 0; i < 8; i++, v >>= 8u) {
+    p[i] = (uint8_t) v;
+  }
+}
+
+// tweak of sector firstSector + i as a 128-bit little endian number, carrying past 2^64
+static void StoreSectorTweak(uint64_t firstSector, size_t i, uint8_t tweak[]) {
+  const uint64_t sector = firstSector + i;
+  StoreLittleEndian64(sector, tweak);
+  StoreLittleEndian64(sector < firstSector ? 1 : 0, tweak + 8);
+}
+
+// multiply the tweak by the primitive element, x^128 = x^7 + x^2 + x + 1
+static inline void MultiplyByAlpha(uint64_t &lo, uint64_t &hi) {
+  const uint64_t carry = hi >> 63u;
+  hi = (hi << 1u) | (lo >> 63u);
+  lo = (lo << 1u) ^ (carry * 0x87u);
+}
+
+AesXts::AesXts(const AES &aes, const uint8_t key[])
+    : aes(aes), dataKey(aes.ExpandKey(key)), tweakKey(aes.ExpandKey(key + 4 * aes.Nk)) {}
+
+AesXts::AesXts(const AES &aes, const AesKey &dataKey, const AesKey &tweakKey)
+    : aes(aes), dataKey(dataKey), tweakKey(tweakKey) {
+  aes.CheckKey(dataKey);
+  aes.CheckKey(tweakKey);
+}
+
+void AesXts::Unit(const uint8_t in[], uint8_t out[], size_t len, const uint8_t tweak[], bool encrypt) const {
+  if (len < aes.blockBytesLen) {
+    throw std::invalid_argument("XTS data unit is shorter than a block");
+  }
+  const uint8_t *keys = encrypt ? dataKey.encKeys : dataKey.decKeys;
+
+  uint8_t t[16];
+  aes.EncryptBlock(tweak, t, tweakKey.encKeys);
+  uint64_t lo = LoadLittleEndian64(t);
+  uint64_t hi = LoadLittleEndian64(t + 8);
+
+  // the last whole block takes part in ciphertext stealing when there is a partial one
+  const size_t tail = len % aes.blockBytesLen;
+  const size_t blocks = len / aes.blockBytesLen - (tail ? 1 : 0);
+
+  // a batch of tweaks is two 64-bit shifts per block, then the blocks go through the multi-block kernels
+  uint8_t tweaks[kBatchBlocks * 16];
+  uint8_t buffer[kBatchBlocks * 16];
+  for (size_t first = 0; first < blocks; first += kBatchBlocks) {
+    const size_t count = blocks - first < kBatchBlocks ? blocks - first : kBatchBlocks;
+    for (size_t j = 0; j < count; j++) {
+      StoreLittleEndian64(lo, tweaks + j * aes.blockBytesLen);
+      StoreLittleEndian64(hi, tweaks + j * aes.blockBytesLen + 8);
+      MultiplyByAlpha(lo, hi);
+    }
+
+    const size_t offset = first * aes.blockBytesLen;
+    XorBlocks(in + offset, tweaks, buffer, count * aes.blockBytesLen);
+    if (encrypt) {
+      aes.EncryptBlocks(buffer, buffer, count, keys);
+    } else {
+      aes.DecryptBlocks(buffer, buffer, count, keys);
+    }
+    XorBlocks(buffer, tweaks, out + offset, count * aes.blockBytesLen);
+  }
+  if (!tail) {
+    return;
+  }
+
+  // ciphertext stealing: the last whole block is processed with the next tweak when decrypting
+  uint8_t current[16], next[16];
+  StoreLittleEndian64(lo, current);
+  StoreLittleEndian64(hi, current + 8);
+  MultiplyByAlpha(lo, hi);
+  StoreLittleEndian64(lo, next);
+  StoreLittleEndian64(hi, next + 8);
+  const uint8_t *first = encrypt ? current : next;
+  const uint8_t *second = encrypt ? next : current;
+
+  const size_t offset = blocks * aes.blockBytesLen;
+  uint8_t block[16], stolen[16];
+  XorBlocks(in + offset, first, block, aes.blockBytesLen);
+  if (encrypt) {
+    aes.EncryptBlock(block, block, keys);
+  } else {
+    aes.DecryptBlock(block, block, keys);
+  }
+  XorBlocks(block, first, block, aes.blockBytesLen);
+
+  // the partial block borrows the end of the processed one, which moves to the end of the output
+  memcpy(stolen, in + offset + aes.blockBytesLen, tail);
+  memcpy(stolen + tail, block + tail, aes.blockBytesLen - tail);
+  memcpy(out + offset + aes.blockBytesLen, block, tail);
+
+  XorBlocks(stolen, second, stolen, aes.blockBytesLen);
+  if (encrypt) {
+    aes.EncryptBlock(stolen, stolen, keys);
+  } else {
+    aes.DecryptBlock(stolen, stolen, keys);
+  }
+  XorBlocks(stolen, second, out + offset, aes.blockBytesLen);
+}
+
+template<typename TweakOf>
+void AesXts::Sectors(const uint8_t in[], uint8_t out[], size_t sectorLen, size_t sectors, const TweakOf &tweakOf,
+                     bool encrypt) const {
+  if (sectorLen < aes.blockBytesLen) {
+    throw std::invalid_argument("XTS data unit is shorter than a block");
+  }
+  size_t parts = aes.Parts(sectors * (sectorLen / aes.blockBytesLen));
+  parts = parts < sectors ? parts : sectors;
+  ForEachRange(aes.Pool(), sectors, parts, [&](size_t first, size_t count, size_t) {
+    uint8_t tweak[16];
+    for (size_t i = first; i < first + count; i++) {
+      tweakOf(i, tweak);
+      Unit(in + i * sectorLen, out + i * sectorLen, sectorLen, tweak, encrypt);
+    }
+  });
+}
+
+void AesXts::Encrypt(const uint8_t in[], uint8_t out[], size_t len, const uint8_t tweak[]) const {
+  const PerfModeScope perf(PerfCipher::kAes, (size_t) aes.backend, PerfMode::kXTS, true, len, aes.blockBytesLen);
+  Unit(in, out, len, tweak, true);
+}
+
+void AesXts::Decrypt(const uint8_t in[], uint8_t out[], size_t len, const uint8_t tweak[]) const {
+  const PerfModeScope perf(PerfCipher::kAes, (size_t) aes.backend, PerfMode::kXTS, false, len, aes.blockBytesLen);
+  Unit(in, out, len, tweak, false);
+}
+
+void AesXts::EncryptSectors(const uint8_t in[], uint8_t out[], size_t sectorLen, size_t sectors,
+                            uint64_t firstSector) const {
+  Sectors(in, out, sectorLen, sectors, [&](size_t i, uint8_t tweak[]) {
+    StoreSectorTweak(firstSector, i, tweak);
+  }, true);
+}
+
+void AesXts::DecryptSectors(const uint8_t in[], uint8_t out[], size_t sectorLen, size_t sectors,
+                            uint64_t firstSector) const {
+  Sectors(in, out, sectorLen, sectors, [&](size_t i, uint8_t tweak[]) {
+    StoreSectorTweak(firstSector, i, tweak);
+  }, false);
+}
+
+void AesXts::EncryptSectors(const uint8_t in[], uint8_t out[], size_t sectorLen, size_t sectors,
+                            const uint8_t tweaks[]) const {
+  Sectors(in, out, sectorLen, sectors, [&](size_t i, uint8_t tweak[]) {
+    memcpy(tweak, tweaks + i * aes.blockBytesLen, aes.blockBytesLen);
+  }, true);
+}
+
+void AesXts::DecryptSectors(const uint8_t in[], uint8_t out[], size_t sectorLen, size_t sectors,
+                            const uint8_t tweaks[]) const {
+  Sectors(in, out, sectorLen, sectors, [&](size_t i, uint8_t tweak[]) {
+    memcpy(tweak, tweaks + i * aes.blockBytesLen, aes.blockBytesLen);
+  }, false);
+}
@@ -1,196 +1,265 @@
+#include <algorithm>
 #include <stdexcept>
+#include <type_traits>
 #include "kalyna.h"
+#include "kalyna_modes.h"
+#include "perf_counters.h"
+#include "sliced_avx2.h"
+#include "sliced_avx512.h"
+#include "sliced_ssse3.h"
 #include "transformations.h"
-#include "tables.h"
 
-Kalyna::Kalyna(size_t block_size, size_t key_size) {
+// row-sliced kernels from the widest to the narrowest, the last one takes batches of kSlicedTailBytes
+using SlicedKernel = size_t (*)(const uint8_t *, uint8_t *, size_t, size_t, size_t, const uint64_t *);
+static const SlicedKernel kSlicedEncipher[] =
+    {SlicedAvx512EncipherBlocks, SlicedAvx2EncipherBlocks, SlicedSsse3EncipherBlocks};
+static const SlicedKernel kSlicedDecipher[] =
+    {SlicedAvx512DecipherBlocks, SlicedAvx2DecipherBlocks, SlicedSsse3DecipherBlocks};
+static const size_t kSlicedKernels = 3;
+static const size_t kSlicedTailBytes = 128;
+
+KalynaKey::KalynaKey(size_t block_size, size_t key_size) {
   if (block_size == kBLOCK_128) {
-    nb = kBLOCK_128 / kBITS_IN_WORD;
     if (key_size == kKEY_128) {
-      nk = kKEY_128 / kBITS_IN_WORD;
-      nr = kNR_128;
+      cipher.emplace<KalynaCipher<128, 128>>();
     } else if (key_size == kKEY_256) {
-      nk = kKEY_256 / kBITS_IN_WORD;
-      nr = kNR_256;
+      cipher.emplace<KalynaCipher<128, 256>>();
     } else {
       throw std::invalid_argument("Error: unsupported key size");
     }
-  } else if (block_size == 256) {
-    nb = kBLOCK_256 / kBITS_IN_WORD;
+  } else if (block_size == kBLOCK_256) {
     if (key_size == kKEY_256) {
-      nk = kKEY_256 / kBITS_IN_WORD;
-      nr = kNR_256;
+      cipher.emplace<KalynaCipher<256, 256>>();
     } else if (key_size == kKEY_512) {
-      nk = kKEY_512 / kBITS_IN_WORD;
-      nr = kNR_512;
+      cipher.emplace<KalynaCipher<256, 512>>();
     } else {
       throw std::invalid_argument("Error: unsupported key size");
     }
   } else if (block_size == kBLOCK_512) {
-    nb = kBLOCK_512 / kBITS_IN_WORD;
     if (key_size == kKEY_512) {
-      nk = kKEY_512 / kBITS_IN_WORD;
-      nr = kNR_512;
+      cipher.emplace<KalynaCipher<512, 512>>();
     } else {
       throw std::invalid_argument("Error: unsupported key size");
     }
   } else {
     throw std::invalid_argument("Error: unsupported key size");
   }
+}
 
-  state = (uint64_t *) calloc(nb, sizeof(uint64_t));
-  if (!state) {
-    throw std::runtime_error("Could not allocate memory for cipher state.");
-  }
+size_t KalynaKey::BlockSize() const {
+  return std::visit([](const auto &c) { return c.kNb * kBITS_IN_WORD; }, cipher);
+}
 
-  round_keys = (uint64_t **) calloc(nr + 1, sizeof(uint64_t **));
-  if (!round_keys) {
-    throw std::runtime_error("Could not allocate memory for cipher round keys.");
-  }
+size_t KalynaKey::KeySize() const {
+  return std::visit([](const auto &c) { return c.kNk * kBITS_IN_WORD; }, cipher);
+}
 
-  for (size_t i = 0; i < nr + 1; ++i) {
-    round_keys[i] = (uint64_t *) calloc(nb, sizeof(uint64_t));
-    if (!round_keys[i]) {
-      throw std::runtime_error("Could not allocate memory for cipher round keys.");
-    }
+Kalyna::Kalyna(size_t block_size, size_t key_size, KalynaBackend backend)
+    : key(block_size, key_size), block_bytes(block_size / kBITS_IN_BYTE), backend(backend) {
+  if (backend == KalynaBackend::kAuto) {
+    this->backend = SlicedAvx512Available() ? KalynaBackend::kAvx512 : KalynaBackend::kTable;
+  } else if (backend == KalynaBackend::kAvx512 && !SlicedAvx512Available()) {
+    throw std::invalid_argument("AVX-512 VBMI is not supported on this CPU");
+  } else if (backend == KalynaBackend::kAvx2 && !SlicedAvx2Available()) {
+    throw std::invalid_argument("AVX2 is not supported on this CPU");
+  } else if (backend == KalynaBackend::kSsse3 && !SlicedSsse3Available()) {
+    throw std::invalid_argument("SSSE3 is not supported on this CPU");
   }
 }
 
-Kalyna::~Kalyna() {
-  free(state);
-  for (size_t i = 0; i < nr + 1; ++i) {
-    free(round_keys[i]);
-  }
-  free(round_keys);
+KalynaBackend Kalyna::Backend() const {
+  return backend;
 }
 
-void Kalyna::KeyExpand(uint64_t *key) {
-  auto *kt = (uint64_t *) malloc(nb * sizeof(uint64_t));
-  KeyExpandKt(key, kt);
-  KeyExpandEven(key, kt);
-  KeyExpandOdd();
-  free(kt);
+size_t Kalyna::BlockBytes() const {
+  return block_bytes;
 }
 
-void Kalyna::KeyExpandKt(uint64_t *key, uint64_t *kt) {
-  auto *k0 = (uint64_t *) malloc(nb * sizeof(uint64_t));
-  auto *k1 = (uint64_t *) malloc(nb * sizeof(uint64_t));
+KalynaKey Kalyna::ExpandKey(const uint64_t *key) const {
+  const PerfKeyScope perf(PerfCipher::kKalyna, 1);
+  KalynaKey expanded = this->key;
+  std::visit([key](auto &c) { c.KeyExpand(key); }, expanded.cipher);
+  return expanded;
+}
 
-  memset(state, 0, nb * sizeof(uint64_t));
-  state[0] += nb + nk + 1;
+void Kalyna::ExpandKeys(const uint64_t *keys, size_t count, KalynaKey expanded[]) const {
+  const PerfKeyScope perf(PerfCipher::kKalyna, count);
+  std::visit([keys, count, expanded](const auto &empty) {
+    using Cipher = std::decay_t<decltype(empty)>;
+    Cipher *lanes[Cipher::kKeyBatchWidth];
+    for (size_t i = 0; i < count; i += Cipher::kKeyBatchWidth) {
+      const size_t width = std::min(Cipher::kKeyBatchWidth, count - i);
+      for (size_t l = 0; l < width; ++l) {
+        if (!std::holds_alternative<Cipher>(expanded[i + l].cipher)) {
+          expanded[i + l].cipher.template emplace<Cipher>();
+        }
+        lanes[l] = &std::get<Cipher>(expanded[i + l].cipher);
+      }
+      Cipher::KeyExpandBatch(keys + i * Cipher::kNk, lanes, width);
+    }
+  }, key.cipher);
+}
 
-  if (nb == nk) {
-    memcpy(k0, key, nb * sizeof(uint64_t));
-    memcpy(k1, key, nb * sizeof(uint64_t));
-  } else {
-    memcpy(k0, key, nb * sizeof(uint64_t));
-    memcpy(k1, key + nb, nb * sizeof(uint64_t));
+void Kalyna::CheckKey(const KalynaKey &key) const {
+  if (key.cipher.index() != this->key.cipher.index()) {
+    throw std::invalid_argument("Key was expanded for another block or key size");
   }
+}
 
-  AddRoundKeyExpand(k0, state, nb);
-  EncipherRound(state, nb);
-  XorRoundKeyExpand(k1, state, nb);
-  EncipherRound(state, nb);
-  AddRoundKeyExpand(k0, state, nb);
-  EncipherRound(state, nb);
-  memcpy(kt, state, nb * sizeof(uint64_t));
+void Kalyna::CheckSegment(uint32_t s) const {
+  if (s == 0 || s > block_bytes) {
+    throw std::invalid_argument("Incorrect CFB segment size");
+  }
+}
 
-  free(k0);
-  free(k1);
+void Kalyna::Encipher(const uint64_t *plaintext, uint64_t *ciphertext, const KalynaKey &key) const {
+  CheckKey(key);
+  std::visit([=](const auto &c) { c.Encipher(plaintext, ciphertext); }, key.cipher);
 }
 
-void Kalyna::KeyExpandEven(uint64_t *key, uint64_t *kt) {
-  auto *initial_data = (uint64_t *) malloc(nk * sizeof(uint64_t));
-  auto *kt_round = (uint64_t *) malloc(nb * sizeof(uint64_t));
-  auto *tmv = (uint64_t *) malloc(nb * sizeof(uint64_t));
-  size_t round = 0;
+void Kalyna::Decipher(const uint64_t *ciphertext, uint64_t *plaintext, const KalynaKey &key) const {
+  CheckKey(key);
+  std::visit([=](const auto &c) { c.Decipher(ciphertext, plaintext); }, key.cipher);
+}
 
-  memcpy(initial_data, key, nk * sizeof(uint64_t));
-  for (size_t i = 0; i < nb; ++i) {
-    tmv[i] = 0x0001000100010001;
+KalynaKey Kalyna::ExpandKey(const uint8_t key[]) const {
+  // the schedule reads the key words several times, so they are loaded once
+  uint64_t words[kNK_512];
+  const size_t nk = this->key.KeySize() / kBITS_IN_WORD;
+  for (size_t i = 0; i < nk; ++i) {
+    words[i] = LoadWordLE(key + i * sizeof(uint64_t));
   }
+  return ExpandKey(words);
+}
+
+void Kalyna::Encipher(const uint8_t plaintext[], uint8_t ciphertext[], const KalynaKey &key) const {
+  CheckKey(key);
+  std::visit([=](const auto &c) { c.EncipherBlocks(plaintext, ciphertext, 1, 1); }, key.cipher);
+}
+
+void Kalyna::Decipher(const uint8_t ciphertext[], uint8_t plaintext[], const KalynaKey &key) const {
+  CheckKey(key);
+  std::visit([=](const auto &c) { c.DecipherBlocks(ciphertext, plaintext, 1, 1); }, key.cipher);
+}
 
-  while (true) {
-    memcpy(state, kt, nb * sizeof(uint64_t));
-    AddRoundKeyExpand(tmv, state, nb);
-    memcpy(kt_round, state, nb * sizeof(uint64_t));
+void Kalyna::KeyExpand(uint64_t *key) {
+  this->key = ExpandKey(key);
+}
 
-    memcpy(state, initial_data, nb * sizeof(uint64_t));
+void Kalyna::Encipher(uint64_t *plaintext, uint64_t *ciphertext) {
+  Encipher(plaintext, ciphertext, key);
+}
 
-    AddRoundKeyExpand(kt_round, state, nb);
-    EncipherRound(state, nb);
-    XorRoundKeyExpand(kt_round, state, nb);
-    EncipherRound(state, nb);
-    AddRoundKeyExpand(kt_round, state, nb);
+void Kalyna::Decipher(uint64_t *ciphertext, uint64_t *plaintext) {
+  Decipher(ciphertext, plaintext, key);
+}
 
-    memcpy(round_keys[round], state, nb * sizeof(uint64_t));
+/*
+ * The row-sliced kernels only take whole batches. Every CPU with AVX-512 VBMI has
+ * AVX2 and every CPU with AVX2 has SSSE3, so the narrower kernels take what is
+ * left, and the last blocks are zero-padded to an SSSE3 batch.
+ */
+static void SlicedBlocks(const SlicedKernel *kernels, size_t count, const uint8_t in[], uint8_t out[], size_t blocks,
+                         size_t nb, size_t nr, const uint64_t *round_keys) {
+  const size_t block_bytes = nb * sizeof(uint64_t);
+  size_t done = 0;
+  for (size_t i = 0; i < count && done < blocks; ++i) {
+    done += kernels[i](in + done * block_bytes, out + done * block_bytes, blocks - done, nb, nr, round_keys);
+  }
+  if (done == blocks) {
+    return;
+  }
+  uint8_t batch[kSlicedTailBytes] = {};
+  memcpy(batch, in + done * block_bytes, (blocks - done) * block_bytes);
+  kernels[count - 1](batch, batch, kSlicedTailBytes / block_bytes, nb, nr, round_keys);
+  memcpy(out + done * block_bytes, batch, (blocks - done) * block_bytes);
+}
 
-    if (nr == round)
-      break;
+/*!
+ * @return Index of the first kernel of the backend in kSlicedEncipher and kSlicedDecipher.
+ */
+static size_t SlicedFirst(KalynaBackend backend) {
+  return backend == KalynaBackend::kAvx512 ? 0 : backend == KalynaBackend::kAvx2 ? 1 : 2;
+}
 
-    if (nk != nb) {
-      round += 2;
+void SlicedEncipherBlocks(KalynaBackend backend, const uint8_t in[], uint8_t out[], size_t blocks, size_t nb,
+                          size_t nr, const uint64_t *round_keys) {
+  const size_t first = SlicedFirst(backend);
+  SlicedBlocks(kSlicedEncipher + first, kSlicedKernels - first, in, out, blocks, nb, nr, round_keys);
+}
 
-      ShiftLeft(nb, tmv);
+void SlicedDecipherBlocks(KalynaBackend backend, const uint8_t in[], uint8_t out[], size_t blocks, size_t nb,
+                          size_t nr, const uint64_t *round_keys) {
+  const size_t first = SlicedFirst(backend);
+  SlicedBlocks(kSlicedDecipher + first, kSlicedKernels - first, in, out, blocks, nb, nr, round_keys);
+}
 
-      memcpy(state, kt, nb * sizeof(uint64_t));
-      AddRoundKeyExpand(tmv, state, nb);
-      memcpy(kt_round, state, nb * sizeof(uint64_t));
+void Kalyna::EncipherBlocks(const uint8_t in[], uint8_t out[], size_t blocks, const KalynaKey &key) const {
+  WithModes(key, [=](const auto &modes) { modes.EncryptBlocks(in, out, blocks); });
+}
 
-      memcpy(state, initial_data + nb, nb * sizeof(uint64_t));
+void Kalyna::DecipherBlocks(const uint8_t in[], uint8_t out[], size_t blocks, const KalynaKey &key) const {
+  WithModes(key, [=](const auto &modes) { modes.DecryptBlocks(in, out, blocks); });
+}
 
-      AddRoundKeyExpand(kt_round, state, nb);
-      EncipherRound(state, nb);
-      XorRoundKeyExpand(kt_round, state, nb);
-      EncipherRound(state, nb);
-      AddRoundKeyExpand(kt_round, state, nb);
+void Kalyna::CtrStart(const uint8_t iv[], uint64_t block, const KalynaKey &key, uint8_t counter[]) const {
+  WithModes(key, [=](const auto &modes) { modes.CounterStart(iv, block, counter); });
+}
 
-      memcpy(round_keys[round], state, nb * sizeof(uint64_t));
+void Kalyna::EncryptECB(const uint8_t in[], uint8_t out[], size_t len, const KalynaKey &key) const {
+  const PerfModeScope perf(PerfCipher::kKalyna, (size_t) backend, PerfMode::kECB, true, len, block_bytes);
+  WithModes(key, [=](const auto &modes) { modes.EncryptECB(in, out, len); });
+}
 
-      if (nr == round)
-        break;
-    }
-    round += 2;
-    ShiftLeft(nb, tmv);
-    Rotate(nk, initial_data);
-  }
+void Kalyna::DecryptECB(const uint8_t in[], uint8_t out[], size_t len, const KalynaKey &key) const {
+  const PerfModeScope perf(PerfCipher::kKalyna, (size_t) backend, PerfMode::kECB, false, len, block_bytes);
+  WithModes(key, [=](const auto &modes) { modes.DecryptECB(in, out, len); });
+}
 
-  free(initial_data);
-  free(kt_round);
-  free(tmv);
+void Kalyna::EncryptCBC(const uint8_t in[], uint8_t out[], size_t len, const KalynaKey &key,
+                        const uint8_t iv[]) const {
+  const PerfModeScope perf(PerfCipher::kKalyna, (size_t) backend, PerfMode::kCBC, true, len, block_bytes);
+  WithModes(key, [=](const auto &modes) { modes.EncryptCBC(in, out, len, iv); });
 }
 
-void Kalyna::KeyExpandOdd() {
-  for (size_t i = 1; i < nr; i += 2) {
-    memcpy(round_keys[i], round_keys[i - 1], nb * sizeof(uint64_t));
-    RotateLeft(nb, round_keys[i]);
-  }
+void Kalyna::DecryptCBC(const uint8_t in[], uint8_t out[], size_t len, const KalynaKey &key,
+                        const uint8_t iv[]) const {
+  const PerfModeScope perf(PerfCipher::kKalyna, (size_t) backend, PerfMode::kCBC, false, len, block_bytes);
+  WithModes(key, [=](const auto &modes) { modes.DecryptCBC(in, out, len, iv); });
 }
 
-void Kalyna::Encipher(uint64_t *plaintext, uint64_t *ciphertext) {
-  memcpy(state, plaintext, nb * sizeof(uint64_t));
+void Kalyna::EncryptCFB(const uint8_t in[], uint8_t out[], size_t len, uint32_t s, const KalynaKey &key,
+                        const uint8_t iv[]) const {
+  const PerfModeScope perf(PerfCipher::kKalyna, (size_t) backend, PerfMode::kCFB, true, len, block_bytes);
+  WithModes(key, [=](const auto &modes) { modes.EncryptCFB(in, out, len, s, iv); });
+}
 
-  AddRoundKey(0, state, round_keys, nb);
-  for (size_t round = 1; round < nr; ++round) {
-    EncipherRound(state, nb);
-    XorRoundKey(round, state, round_keys, nb);
-  }
-  EncipherRound(state, nb);
-  AddRoundKey(nr, state, round_keys, nb);
+void Kalyna::DecryptCFB(const uint8_t in[], uint8_t out[], size_t len, uint32_t s, const KalynaKey &key,
+                        const uint8_t iv[]) const {
+  const PerfModeScope perf(PerfCipher::kKalyna, (size_t) backend, PerfMode::kCFB, false, len, block_bytes);
+  WithModes(key, [=](const auto &modes) { modes.DecryptCFB(in, out, len, s, iv); });
+}
 
-  memcpy(ciphertext, state, nb * sizeof(uint64_t));
+void Kalyna::EncryptOFB(const uint8_t in[], uint8_t out[], size_t len, const KalynaKey &key,
+                        const uint8_t iv[]) const {
+  const PerfModeScope perf(PerfCipher::kKalyna, (size_t) backend, PerfMode::kOFB, true, len, block_bytes);
+  WithModes(key, [=](const auto &modes) { modes.EncryptOFB(in, out, len, iv); });
 }
 
-void Kalyna::Decipher(uint64_t *ciphertext, uint64_t *plaintext) {
-  memcpy(state, ciphertext, nb * sizeof(uint64_t));
+void Kalyna::DecryptOFB(const uint8_t in[], uint8_t out[], size_t len, const KalynaKey &key,
+                        const uint8_t iv[]) const {
+  const PerfModeScope perf(PerfCipher::kKalyna, (size_t) backend, PerfMode::kOFB, false, len, block_bytes);
+  WithModes(key, [=](const auto &modes) { modes.EncryptOFB(in, out, len, iv); });
+}
 
-  SubRoundKey(nr, state, round_keys, nb);
-  for (size_t round = nr - 1; round > 0; --round) {
-    DecipherRound(state, nb);
-    XorRoundKey(round, state, round_keys, nb);
-  }
-  DecipherRound(state, nb);
-  SubRoundKey(0, state, round_keys, nb);
+void Kalyna::EncryptCTR(const uint8_t in[], uint8_t out[], size_t len, const KalynaKey &key, const uint8_t iv[],
+                        uint64_t offset) const {
+  const PerfModeScope perf(PerfCipher::kKalyna, (size_t) backend, PerfMode::kCTR, true, len, block_bytes);
+  WithModes(key, [=](const auto &modes) { modes.EncryptCTR(in, out, len, iv, offset); });
+}
 
-  memcpy(plaintext, state, nb * sizeof(uint64_t));
+void Kalyna::DecryptCTR(const uint8_t in[], uint8_t out[], size_t len, const KalynaKey &key, const uint8_t iv[],
+                        uint64_t offset) const {
+  const PerfModeScope perf(PerfCipher::kKalyna, (size_t) backend, PerfMode::kCTR, false, len, block_bytes);
+  WithModes(key, [=](const auto &modes) { modes.EncryptCTR(in, out, len, iv, offset); });
 }
@@ -0,0 +1,318 @@
+#include <cstring>
+
+#include "kalyna_cipher.h"
+#include "rounds.h"
+#include "transformations.h"
+
+template<size_t Nb>
+using Columns = std::make_index_sequence<Nb>;
+
+/* Rounds between the first key addition and the last round. */
+template<size_t Nr>
+using InnerRounds = std::make_index_sequence<Nr - 1>;
+
+template<size_t Nb>
+static void AddWords(State<Nb> &state, const State<Nb> &value) {
+  for (size_t i = 0; i < Nb; ++i) {
+    state[i] += value[i];
+  }
+}
+
+template<size_t Nb>
+static void XorWords(State<Nb> &state, const State<Nb> &value) {
+  for (size_t i = 0; i < Nb; ++i) {
+    state[i] ^= value[i];
+  }
+}
+
+/* An enciphering round without the round key: the key schedule adds and XORs keys itself. */
+template<size_t Nb>
+static void MixState(State<Nb> &state) {
+  state = UnrolledEncipherRound<Nb>(state, State<Nb>{}, Columns<Nb>());
+}
+
+/* Little endian words, whatever the byte order of the host. */
+template<size_t Nb>
+static State<Nb> LoadBytes(const uint8_t *bytes) {
+  State<Nb> state;
+  for (size_t i = 0; i < Nb; ++i) {
+    state[i] = LoadWordLE(bytes + i * 8);
+  }
+  return state;
+}
+
+template<size_t Nb>
+static void StoreBytes(const State<Nb> &state, uint8_t *bytes) {
+  for (size_t i = 0; i < Nb; ++i) {
+    StoreWordLE(state[i], bytes + i * 8);
+  }
+}
+
+/* Rotate the state (2 * Nb + 3) bytes to the left, reading words as little endian byte strings. */
+template<size_t Nb>
+static void RotateBytesLeft(State<Nb> &state) {
+  // whole words and the bits left over, 2 * Nb + 3 is never a multiple of 8
+  constexpr size_t kWords = (2 * Nb + 3) / 8;
+  constexpr unsigned kBits = (2 * Nb + 3) % 8 * 8;
+  const State<Nb> words = state;
+  for (size_t i = 0; i < Nb; ++i) {
+    state[i] = (words[(i + kWords) % Nb] >> kBits) | (words[(i + kWords + 1) % Nb] << (64 - kBits));
+  }
+}
+
+template<size_t Nb>
+static State<Nb> LoadState(const uint64_t *words) {
+  State<Nb> state;
+  memcpy(state.data(), words, sizeof(state));
+  return state;
+}
+
+/* One enciphering round of Width blocks with the same round key. */
+template<size_t Nb, size_t Width>
+static void EncipherRoundOfBatch(State<Nb> *state, const State<Nb> &key) {
+  for (size_t b = 0; b < Width; ++b) {
+    state[b] = UnrolledEncipherRound<Nb>(state[b], key, Columns<Nb>());
+  }
+}
+
+template<size_t Nb, size_t Width>
+static void DecipherRoundOfBatch(State<Nb> *state, const State<Nb> &key) {
+  for (size_t b = 0; b < Width; ++b) {
+    state[b] = UnrolledDecipherRound<Nb>(state[b], key, Columns<Nb>());
+  }
+}
+
+/*
+ * Rounds 1 .. Nr - 1, folding over the round numbers unrolls them so the round
+ * keys are read at constant offsets and there is no loop counter.
+ */
+template<size_t Nb, size_t Width, size_t... Round>
+static void EncipherRounds(State<Nb> *state, const State<Nb> *round_keys, std::index_sequence<Round...>) {
+  (EncipherRoundOfBatch<Nb, Width>(state, round_keys[Round + 1]), ...);
+}
+
+/* Rounds Nr - 1 down to 1 of the equivalent inverse cipher. */
+template<size_t Nb, size_t Width, size_t... Round>
+static void DecipherRounds(State<Nb> *state, const State<Nb> *dec_round_keys, std::index_sequence<Round...>) {
+  (DecipherRoundOfBatch<Nb, Width>(state, dec_round_keys[sizeof...(Round) - Round]), ...);
+}
+
+template<size_t BlockBits, size_t KeyBits>
+template<size_t Width>
+void KalynaCipher<BlockBits, KeyBits>::KeyExpandLanes(const uint64_t *keys, KalynaCipher *const ciphers[]) {
+  /* Intermediate keys kt, the three rounds of one key depend on each other. */
+  std::array<Block, Width> kt{};
+  for (size_t l = 0; l < Width; ++l) {
+    kt[l][0] = kNb + kNk + 1;
+    AddWords(kt[l], LoadState<kNb>(keys + l * kNk));
+    MixState(kt[l]);
+  }
+  for (size_t l = 0; l < Width; ++l) {
+    XorWords(kt[l], LoadState<kNb>(keys + l * kNk + (kNk == kNb ? 0 : kNb)));
+    MixState(kt[l]);
+  }
+  for (size_t l = 0; l < Width; ++l) {
+    AddWords(kt[l], LoadState<kNb>(keys + l * kNk));
+    MixState(kt[l]);
+  }
+
+  /* Even round keys, independent of each other once kt is known. */
+  constexpr size_t kEvenKeys = kNr / 2 + 1;
+  std::array<std::array<Block, kEvenKeys>, Width> kt_round;
+  std::array<std::array<Block, kEvenKeys>, Width> state;
+  for (size_t l = 0; l < Width; ++l) {
+    for (size_t e = 0; e < kEvenKeys; ++e) {
+      for (size_t i = 0; i < kNb; ++i) {
+        kt_round[l][e][i] = kt[l][i] + (0x0001000100010001u << e);
+      }
+
+      // the key is rotated by a word per round key; with a key twice the block its halves
+      // take turns and the key is rotated after both were used
+      const size_t offset = kNk == kNb ? e : e / 2 + e % 2 * kNb;
+      for (size_t i = 0; i < kNb; ++i) {
+        state[l][e][i] = keys[l * kNk + (offset + i) % kNk];
+      }
+      AddWords(state[l][e], kt_round[l][e]);
+    }
+  }
+  for (size_t l = 0; l < Width; ++l) {
+    for (size_t e = 0; e < kEvenKeys; ++e) {
+      MixState(state[l][e]);
+      XorWords(state[l][e], kt_round[l][e]);
+    }
+  }
+  for (size_t l = 0; l < Width; ++l) {
+    for (size_t e = 0; e < kEvenKeys; ++e) {
+      MixState(state[l][e]);
+      AddWords(state[l][e], kt_round[l][e]);
+      ciphers[l]->round_keys[2 * e] = state[l][e];
+    }
+  }
+
+  for (size_t l = 0; l < Width; ++l) {
+    KalynaCipher &cipher = *ciphers[l];
+
+    /* Odd round keys. */
+    for (size_t round = 1; round < kNr; round += 2) {
+      cipher.round_keys[round] = cipher.round_keys[round - 1];
+      RotateBytesLeft(cipher.round_keys[round]);
+    }
+
+    /* Round keys of the equivalent inverse cipher. */
+    for (size_t round = 1; round < kNr; ++round) {
+      cipher.dec_round_keys[round] = UnrolledInvMixColumns<kNb>(cipher.round_keys[round], Columns<kNb>());
+    }
+  }
+}
+
+template<size_t BlockBits, size_t KeyBits>
+void KalynaCipher<BlockBits, KeyBits>::KeyExpand(const uint64_t *key) {
+  KalynaCipher *const self = this;
+  KeyExpandLanes<1>(key, &self);
+}
+
+template<size_t BlockBits, size_t KeyBits>
+void KalynaCipher<BlockBits, KeyBits>::KeyExpandBatch(const uint64_t *keys, KalynaCipher *const ciphers[],
+                                                      size_t count) {
+  size_t i = 0;
+  for (; i + kKeyBatchWidth <= count; i += kKeyBatchWidth) {
+    KeyExpandLanes<kKeyBatchWidth>(keys + i * kNk, ciphers + i);
+  }
+  for (; i < count; ++i) {
+    KeyExpandLanes<1>(keys + i * kNk, ciphers + i);
+  }
+}
+
+template<size_t BlockBits, size_t KeyBits>
+void KalynaCipher<BlockBits, KeyBits>::Encipher(const uint64_t *plaintext, uint64_t *ciphertext) const {
+  Block state = LoadState<kNb>(plaintext);
+
+  AddWords(state, round_keys[0]);
+  EncipherRounds<kNb, 1>(&state, round_keys.data(), InnerRounds<kNr>());
+  state = UnrolledEncipherLastRound<kNb>(state, round_keys[kNr], Columns<kNb>());
+
+  memcpy(ciphertext, state.data(), sizeof(state));
+}
+
+template<size_t BlockBits, size_t KeyBits>
+void KalynaCipher<BlockBits, KeyBits>::Decipher(const uint64_t *ciphertext, uint64_t *plaintext) const {
+  Block state = LoadState<kNb>(ciphertext);
+
+  for (size_t i = 0; i < kNb; ++i) {
+    state[i] -= round_keys[kNr][i];
+  }
+  state = UnrolledInvMixColumns<kNb>(state, Columns<kNb>());
+  DecipherRounds<kNb, 1>(&state, dec_round_keys.data(), InnerRounds<kNr>());
+  state = UnrolledDecipherLastRound<kNb>(state, round_keys[0], Columns<kNb>());
+
+  memcpy(plaintext, state.data(), sizeof(state));
+}
+
+template<size_t BlockBits, size_t KeyBits>
+template<size_t Width>
+void KalynaCipher<BlockBits, KeyBits>::EncipherBatch(const uint8_t *in, uint8_t *out) const {
+  std::array<Block, Width> state;
+  for (size_t b = 0; b < Width; ++b) {
+    state[b] = LoadBytes<kNb>(in + b * kNb * 8);
+    AddWords(state[b], round_keys[0]);
+  }
+  EncipherRounds<kNb, Width>(state.data(), round_keys.data(), InnerRounds<kNr>());
+  for (size_t b = 0; b < Width; ++b) {
+    state[b] = UnrolledEncipherLastRound<kNb>(state[b], round_keys[kNr], Columns<kNb>());
+    StoreBytes<kNb>(state[b], out + b * kNb * 8);
+  }
+}
+
+template<size_t BlockBits, size_t KeyBits>
+template<size_t Width>
+void KalynaCipher<BlockBits, KeyBits>::DecipherBatch(const uint8_t *in, uint8_t *out) const {
+  std::array<Block, Width> state;
+  for (size_t b = 0; b < Width; ++b) {
+    state[b] = LoadBytes<kNb>(in + b * kNb * 8);
+    for (size_t i = 0; i < kNb; ++i) {
+      state[b][i] -= round_keys[kNr][i];
+    }
+    state[b] = UnrolledInvMixColumns<kNb>(state[b], Columns<kNb>());
+  }
+  DecipherRounds<kNb, Width>(state.data(), dec_round_keys.data(), InnerRounds<kNr>());
+  for (size_t b = 0; b < Width; ++b) {
+    state[b] = UnrolledDecipherLastRound<kNb>(state[b], round_keys[0], Columns<kNb>());
+    StoreBytes<kNb>(state[b], out + b * kNb * 8);
+  }
+}
+
+template<size_t BlockBits, size_t KeyBits>
+template<size_t Width>
+void KalynaCipher<BlockBits, KeyBits>::EncipherBatches(const uint8_t *in, uint8_t *out, size_t blocks) const {
+  size_t i = 0;
+  for (; i + Width <= blocks; i += Width) {
+    EncipherBatch<Width>(in + i * kNb * 8, out + i * kNb * 8);
+  }
+  for (; i < blocks; ++i) {
+    EncipherBatch<1>(in + i * kNb * 8, out + i * kNb * 8);
+  }
+}
+
+template<size_t BlockBits, size_t KeyBits>
+template<size_t Width>
+void KalynaCipher<BlockBits, KeyBits>::DecipherBatches(const uint8_t *in, uint8_t *out, size_t blocks) const {
+  size_t i = 0;
+  for (; i + Width <= blocks; i += Width) {
+    DecipherBatch<Width>(in + i * kNb * 8, out + i * kNb * 8);
+  }
+  for (; i < blocks; ++i) {
+    DecipherBatch<1>(in + i * kNb * 8, out + i * kNb * 8);
+  }
+}
+
+template<size_t BlockBits, size_t KeyBits>
+void KalynaCipher<BlockBits, KeyBits>::EncipherBlocks(const uint8_t *in, uint8_t *out, size_t blocks,
+                                                      size_t width) const {
+  switch (width) {
+    case 8: {
+      EncipherBatches<8>(in, out, blocks);
+      break;
+    }
+    case 4: {
+      EncipherBatches<4>(in, out, blocks);
+      break;
+    }
+    case 2: {
+      EncipherBatches<2>(in, out, blocks);
+      break;
+    }
+    default: {
+      EncipherBatches<1>(in, out, blocks);
+      break;
+    }
+  }
+}
+
+template<size_t BlockBits, size_t KeyBits>
+void KalynaCipher<BlockBits, KeyBits>::DecipherBlocks(const uint8_t *in, uint8_t *out, size_t blocks,
+                                                      size_t width) const {
+  switch (width) {
+    case 8: {
+      DecipherBatches<8>(in, out, blocks);
+      break;
+    }
+    case 4: {
+      DecipherBatches<4>(in, out, blocks);
+      break;
+    }
+    case 2: {
+      DecipherBatches<2>(in, out, blocks);
+      break;
+    }
+    default: {
+      DecipherBatches<1>(in, out, blocks);
+      break;
+    }
+  }
+}
+
+template class KalynaCipher<128, 128>;
+template class KalynaCipher<128, 256>;
+template class KalynaCipher<256, 256>;
+template class KalynaCipher<256, 512>;
+template class KalynaCipher<512, 512>;
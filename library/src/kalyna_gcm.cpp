@@ -0,0 +1,219 @@
+#include <cstring>
+#include <stdexcept>
+
+#include "kalyna_gcm.h"
+#include "gmac.h"
+#include "gmac_clmul.h"
+#include "kalyna_modes.h"
+#include "perf_counters.h"
+#include "transformations.h"
+
+// lengths are hashed in bits, as 64-bit words
+static const uint64_t kMaxLength = (1ULL << 61u) - 1;
+
+static const size_t kMinTagBytes = 8;
+
+KalynaGcm::KalynaGcm(const Kalyna &kalyna, const KalynaKey &key, bool encrypt, KalynaGmacBackend gmac)
+    : kalyna(kalyna), key(key), encrypt(encrypt), gmac(gmac), block_bytes(kalyna.BlockBytes()),
+      nb(kalyna.BlockBytes() / sizeof(uint64_t)), table(), x(), counter(), gamma(), pending(), used(0),
+      aad_length(0), length(0), started(false), data_started(false) {
+  kalyna.CheckKey(key);
+  if (gmac == KalynaGmacBackend::kAuto) {
+    this->gmac = GmacClmulAvailable() ? KalynaGmacBackend::kClmul : KalynaGmacBackend::kTable;
+  } else if (gmac == KalynaGmacBackend::kClmul && !GmacClmulAvailable()) {
+    throw std::invalid_argument("PCLMULQDQ is not supported on this CPU");
+  }
+
+  uint8_t zero[Kalyna::kMaxBlockBytes] = {};
+  uint8_t h_bytes[Kalyna::kMaxBlockBytes];
+  kalyna.EncipherBlocks(zero, h_bytes, 1, key);
+  uint64_t h[8];
+  for (size_t i = 0; i < nb; ++i) {
+    h[i] = 0;
+    for (size_t j = 0; j < sizeof(uint64_t); ++j) {
+      h[i] |= (uint64_t) h_bytes[i * 8 + j] << (j * kBITS_IN_BYTE);
+    }
+  }
+  if (this->gmac == KalynaGmacBackend::kClmul) {
+    GmacClmulInit(h, nb, table);
+  } else {
+    GmacTableInit(h, nb, table);
+  }
+}
+
+KalynaGmacBackend KalynaGcm::Backend() const {
+  return gmac;
+}
+
+void KalynaGcm::Hash(const uint8_t data[], size_t blocks) {
+  if (gmac == KalynaGmacBackend::kClmul) {
+    GmacClmulBlocks(x, data, blocks, nb, table);
+  } else {
+    GmacTableBlocks(x, data, blocks, nb, table);
+  }
+}
+
+void KalynaGcm::Init(const uint8_t iv[], size_t ivLen) {
+  if (ivLen == 0 || ivLen > block_bytes) {
+    throw std::invalid_argument("Incorrect GCM IV length");
+  }
+
+  uint8_t block[Kalyna::kMaxBlockBytes] = {};
+  memcpy(block + block_bytes - ivLen, iv, ivLen);
+  kalyna.CtrStart(block, 0, key, counter);
+
+  memset(x, 0, sizeof(x));
+  used = 0;
+  aad_length = 0;
+  length = 0;
+  started = true;
+  data_started = false;
+}
+
+void KalynaGcm::UpdateAad(const uint8_t aad[], size_t len) {
+  if (!started) {
+    throw std::logic_error("KalynaGcm::Init was not called");
+  }
+  if (data_started) {
+    throw std::logic_error("AAD has to come before the data");
+  }
+  if (len > kMaxLength - aad_length) {
+    throw std::invalid_argument("GCM AAD is too long");
+  }
+  aad_length += len;
+
+  if (used > 0) {
+    const size_t chunk = block_bytes - used < len ? block_bytes - used : len;
+    memcpy(pending + used, aad, chunk);
+    used += chunk;
+    aad += chunk;
+    len -= chunk;
+    if (used < block_bytes) {
+      return;
+    }
+    Hash(pending, 1);
+    used = 0;
+  }
+
+  const size_t blocks = len / block_bytes;
+  Hash(aad, blocks);
+  used = len - blocks * block_bytes;
+  memcpy(pending, aad + blocks * block_bytes, used);
+}
+
+void KalynaGcm::FinishAad() {
+  if (data_started) {
+    return;
+  }
+  if (used > 0) {
+    memset(pending + used, 0, block_bytes - used);
+    Hash(pending, 1);
+    used = 0;
+  }
+  data_started = true;
+}
+
+size_t KalynaGcm::XorGamma(const uint8_t in[], uint8_t out[], size_t len) {
+  const size_t chunk = block_bytes - used < len ? block_bytes - used : len;
+  if (!encrypt) {
+    // the ciphertext is saved before out overwrites it
+    memcpy(pending + used, in, chunk);
+  }
+  XorBytes(in, gamma + used, out, chunk);
+  if (encrypt) {
+    memcpy(pending + used, out, chunk);
+  }
+
+  used += chunk;
+  if (used == block_bytes) {
+    Hash(pending, 1);
+    used = 0;
+  }
+  return chunk;
+}
+
+void KalynaGcm::Update(const uint8_t in[], uint8_t out[], size_t len) {
+  if (!started) {
+    throw std::logic_error("KalynaGcm::Init was not called");
+  }
+  if (len > kMaxLength - length) {
+    throw std::invalid_argument("GCM message is too long");
+  }
+  const PerfModeScope perf(PerfCipher::kKalyna, (size_t) kalyna.backend, PerfMode::kGCM, encrypt, len, block_bytes);
+  FinishAad();
+  length += len;
+
+  size_t done = 0;
+  if (used > 0) {
+    done = XorGamma(in, out, len);
+  }
+
+  // whole blocks go through the multi-block CTR kernel, the hash follows each batch of
+  // 512 bytes, one batch of the widest row-sliced backend
+  const size_t batch_bytes = 512 / block_bytes * block_bytes;
+  const size_t whole = (len - done) / block_bytes * block_bytes;
+  for (size_t first = 0; first < whole; first += batch_bytes) {
+    const size_t chunk = whole - first < batch_bytes ? whole - first : batch_bytes;
+    if (!encrypt) {
+      Hash(in + done, chunk / block_bytes);
+    }
+    kalyna.WithModes(key, [&](const auto &modes) { modes.CtrXor(in + done, out + done, chunk, counter); });
+    if (encrypt) {
+      Hash(out + done, chunk / block_bytes);
+    }
+    done += chunk;
+  }
+
+  if (done < len) {
+    kalyna.EncipherBlocks(counter, gamma, 1, key);
+    AddCounter(counter, block_bytes, 1);
+    XorGamma(in + done, out + done, len - done);
+  }
+}
+
+void KalynaGcm::Final(uint8_t tag[], size_t tagLen) {
+  if (!started) {
+    throw std::logic_error("KalynaGcm::Init was not called");
+  }
+  if (tagLen == 0) {
+    tagLen = block_bytes;
+  }
+  if (tagLen < kMinTagBytes || tagLen > block_bytes) {
+    throw std::invalid_argument("Incorrect GCM tag length");
+  }
+  FinishAad();
+  if (used > 0) {
+    memset(pending + used, 0, block_bytes - used);
+    Hash(pending, 1);
+    used = 0;
+  }
+
+  // lengths block: AAD bits in the first half, data bits in the second, folded in with
+  // one more multiplication by H
+  uint8_t block[Kalyna::kMaxBlockBytes] = {};
+  StoreWordLE(aad_length * kBITS_IN_BYTE, block);
+  StoreWordLE(length * kBITS_IN_BYTE, block + block_bytes / 2);
+  Hash(block, 1);
+
+  for (size_t i = 0; i < block_bytes; ++i) {
+    block[i] = (uint8_t) (x[i / 8] >> (i % 8 * kBITS_IN_BYTE));
+  }
+  kalyna.EncipherBlocks(block, block, 1, key);
+  memcpy(tag, block, tagLen);
+  started = false;
+}
+
+bool KalynaGcm::Verify(const uint8_t tag[], size_t tagLen) {
+  uint8_t expected[Kalyna::kMaxBlockBytes];
+  if (tagLen == 0) {
+    tagLen = block_bytes;
+  }
+  Final(expected, tagLen);
+
+  // no early exit, the time taken doesn't depend on where the tags differ
+  uint8_t difference = 0;
+  for (size_t i = 0; i < tagLen; ++i) {
+    difference |= (uint8_t) (expected[i] ^ tag[i]);
+  }
+  return difference == 0;
+}
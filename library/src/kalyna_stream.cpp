@@ -0,0 +1,188 @@
+#include <cstring>
+#include <stdexcept>
+
+#include "kalyna_modes.h"
+#include "kalyna_stream.h"
+#include "perf_counters.h"
+#include "transformations.h"
+
+KalynaStream::KalynaStream(const Kalyna &kalyna, const KalynaKey &key, KalynaStreamMode mode, bool encrypt,
+                           uint32_t s)
+    : kalyna(kalyna), key(key), mode(mode), encrypt(encrypt), s(s ? s : kalyna.BlockBytes()),
+      block_bytes(kalyna.BlockBytes()), iv(), state(), buffer(), feedback(), used(0), length(0), started(false) {
+  kalyna.CheckKey(key);
+  if (mode == KalynaStreamMode::kCFB) {
+    kalyna.CheckSegment(this->s);
+  }
+}
+
+void KalynaStream::Init(const uint8_t iv[]) {
+  memcpy(this->iv, iv, block_bytes);
+  if (mode == KalynaStreamMode::kCTR) {
+    kalyna.CtrStart(iv, 0, key, state);
+  } else {
+    memcpy(state, iv, block_bytes);
+  }
+  used = 0;
+  length = 0;
+  started = true;
+}
+
+size_t KalynaStream::XorGamma(const uint8_t in[], uint8_t out[], size_t len) {
+  const size_t chunk = block_bytes - used < len ? block_bytes - used : len;
+  if (mode == KalynaStreamMode::kCFB && !encrypt) {
+    // the ciphertext is saved before out overwrites it
+    memcpy(feedback + used, in, chunk);
+  }
+  XorBytes(in, buffer + used, out, chunk);
+  if (mode == KalynaStreamMode::kCFB && encrypt) {
+    memcpy(feedback + used, out, chunk);
+  }
+
+  used += chunk;
+  if (used == block_bytes) {
+    if (mode == KalynaStreamMode::kCFB) {
+      memmove(state, state + s, block_bytes - s);
+      memcpy(state + block_bytes - s, feedback, s);
+    }
+    used = 0;
+  }
+  return chunk;
+}
+
+void KalynaStream::NextGamma() {
+  switch (mode) {
+    case KalynaStreamMode::kCFB: {
+      kalyna.EncipherBlocks(state, buffer, 1, key);
+      break;
+    }
+    case KalynaStreamMode::kOFB: {
+      kalyna.EncipherBlocks(state, state, 1, key);
+      memcpy(buffer, state, block_bytes);
+      break;
+    }
+    case KalynaStreamMode::kCTR: {
+      kalyna.EncipherBlocks(state, buffer, 1, key);
+      AddCounter(state, block_bytes, 1);
+      break;
+    }
+    default: {
+      break;
+    }
+  }
+}
+
+size_t KalynaStream::Update(const uint8_t in[], uint8_t out[], size_t len) {
+  if (!started) {
+    throw std::logic_error("KalynaStream::Init was not called");
+  }
+  const PerfModeScope perf(PerfCipher::kKalyna, (size_t) kalyna.backend, (PerfMode) ((size_t) mode + 1), encrypt,
+                           len, block_bytes);
+  length += len;
+
+  if (mode == KalynaStreamMode::kCBC) {
+    size_t written = 0;
+    if (used > 0) {
+      const size_t chunk = block_bytes - used < len ? block_bytes - used : len;
+      memcpy(buffer + used, in, chunk);
+      used += chunk;
+      in += chunk;
+      len -= chunk;
+      if (used < block_bytes) {
+        return 0;
+      }
+      if (encrypt) {
+        kalyna.WithModes(key, [&](const auto &modes) { modes.CbcEncrypt(buffer, out, 1, state); });
+      } else {
+        kalyna.WithModes(key, [&](const auto &modes) { modes.CbcDecrypt(buffer, out, 1, state); });
+      }
+      written = block_bytes;
+      used = 0;
+    }
+
+    const size_t blocks = len / block_bytes;
+    if (encrypt) {
+      kalyna.WithModes(key, [&](const auto &modes) { modes.CbcEncrypt(in, out + written, blocks, state); });
+    } else {
+      kalyna.WithModes(key, [&](const auto &modes) { modes.CbcDecrypt(in, out + written, blocks, state); });
+    }
+    written += blocks * block_bytes;
+
+    used = len - blocks * block_bytes;
+    memcpy(buffer, in + blocks * block_bytes, used);
+    return written;
+  }
+
+  size_t done = 0;
+  if (used > 0) {
+    done = XorGamma(in, out, len);
+  }
+
+  // whole blocks go straight to the multi-block kernels
+  const size_t whole = (len - done) / block_bytes * block_bytes;
+  kalyna.WithModes(key, [&](const auto &modes) {
+    switch (mode) {
+      case KalynaStreamMode::kCFB: {
+        if (encrypt) {
+          modes.CfbEncrypt(in + done, out + done, whole, s, state);
+        } else {
+          modes.CfbDecrypt(in + done, out + done, whole, s, state);
+        }
+        break;
+      }
+      case KalynaStreamMode::kOFB: {
+        modes.OfbXor(in + done, out + done, whole, state);
+        break;
+      }
+      default: {
+        modes.CtrXor(in + done, out + done, whole, state);
+        break;
+      }
+    }
+  });
+  done += whole;
+
+  if (done < len) {
+    NextGamma();
+    done += XorGamma(in + done, out + done, len - done);
+  }
+  return done;
+}
+
+size_t KalynaStream::Final(uint8_t out[]) {
+  if (!started) {
+    throw std::logic_error("KalynaStream::Init was not called");
+  }
+  started = false;
+  if (mode != KalynaStreamMode::kCBC || used == 0) {
+    return 0;
+  }
+  if (!encrypt) {
+    throw std::invalid_argument("Ciphertext is not a whole number of blocks");
+  }
+
+  memset(buffer + used, 0, block_bytes - used);
+  kalyna.WithModes(key, [&](const auto &modes) { modes.CbcEncrypt(buffer, out, 1, state); });
+  used = 0;
+  return block_bytes;
+}
+
+void KalynaStream::Seek(uint64_t offset) {
+  if (mode != KalynaStreamMode::kCTR) {
+    throw std::logic_error("Only CTR streams can seek");
+  }
+  if (!started) {
+    throw std::logic_error("KalynaStream::Init was not called");
+  }
+  kalyna.CtrStart(iv, offset / block_bytes, key, state);
+  used = 0;
+  if (offset % block_bytes > 0) {
+    NextGamma();
+    used = offset % block_bytes;
+  }
+  length = offset;
+}
+
+uint64_t KalynaStream::Length() const {
+  return length;
+}
@@ -0,0 +1,80 @@
+#include <atomic>
+#include <cstdlib>
+#include <new>
+
+#include "aes.h"
+#include "gtest/gtest.h"
+
+// every operator new of the test binary goes through here
+static std::atomic<size_t> allocations{0};
+
+void *operator new(size_t size) {
+  allocations++;
+  void *p = malloc(size ? size : 1);
+  if (!p) {
+    throw std::bad_alloc();
+  }
+  return p;
+}
+
+void *operator new[](size_t size) {
+  return operator new(size);
+}
+
+void operator delete(void *p) noexcept {
+  free(p);
+}
+
+void operator delete[](void *p) noexcept {
+  free(p);
+}
+
+void operator delete(void *p, size_t) noexcept {
+  free(p);
+}
+
+void operator delete[](void *p, size_t) noexcept {
+  free(p);
+}
+
+TEST(Allocations, CallerBufferModesDoNotAllocate) {
+  const size_t length = 64 * 16;
+  static uint8_t plain[length], buffer[length];
+  uint8_t key[32], iv[16], counter[16];
+  for (size_t i = 0; i < length; i++) {
+    plain[i] = (uint8_t) (i * 3);
+  }
+  for (size_t i = 0; i < sizeof(key); i++) {
+    key[i] = (uint8_t) i;
+  }
+  memset(iv, 0xa5, sizeof(iv));
+  memset(counter, 0x3c, sizeof(counter));
+
+  for (AESBackend backend : {AESBackend::kReference, AESBackend::kTTable, AESBackend::kAuto}) {
+    AES aes(256, backend);
+    const AesKey expanded = aes.ExpandKey(key);
+    memcpy(buffer, plain, length);
+
+    const size_t before = allocations;
+    aes.EncryptECB(buffer, buffer, length, expanded);
+    aes.DecryptECB(buffer, buffer, length, expanded);
+    aes.EncryptCBC(buffer, buffer, length, expanded, iv);
+    aes.DecryptCBC(buffer, buffer, length, expanded, iv);
+    aes.EncryptCFB(buffer, buffer, length - 3, 16, expanded, iv);
+    aes.DecryptCFB(buffer, buffer, length - 3, 16, expanded, iv);
+    aes.EncryptOFB(buffer, buffer, length - 5, expanded, iv);
+    aes.DecryptOFB(buffer, buffer, length - 5, expanded, iv);
+    aes.EncryptCTR(buffer, buffer, length - 7, expanded, counter);
+    aes.DecryptCTR(buffer, buffer, length - 7, expanded, counter);
+    aes.ExpandKey(key);
+    const size_t after = allocations;
+
+    EXPECT_EQ(before, after);
+    EXPECT_FALSE(memcmp(plain, buffer, length));
+
+    // the allocating API is still counted, so the hook is active
+    uint32_t len = 0;
+    delete[] aes.EncryptECB(plain, length, expanded, len);
+    EXPECT_LT(after, (size_t) allocations);
+  }
+}
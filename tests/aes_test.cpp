@@ -1,5 +1,16 @@
 #include "aes.h"
+#include "aes_gcm.h"
+#include "aes_stream.h"
+#include "aes_xts.h"
 #include "gtest/gtest.h"
+#include "workers.h"
+
+#include <atomic>
+#include <chrono>
+#include <set>
+#include <string>
+#include <thread>
+#include <vector>
 
 const unsigned int BLOCK_BYTES_LENGTH = 16 * sizeof(unsigned char);
 
@@ -411,3 +422,666 @@ TEST(CTR, EncryptDecrypt) {
   delete[] out;
   delete[] innew;
 }
+
+
+TEST(Backends, ReferenceKnownAnswer) {
+  AES aes(128, AESBackend::kReference);
+  unsigned char plain[] =
+      {0x00, 0x11, 0x22, 0x33, 0x44, 0x55, 0x66, 0x77, 0x88, 0x99, 0xaa, 0xbb, 0xcc, 0xdd, 0xee,
+       0xff};
+  unsigned char key[] =
+      {0x00, 0x01, 0x02, 0x03, 0x04, 0x05, 0x06, 0x07, 0x08, 0x09, 0x0a, 0x0b, 0x0c, 0x0d, 0x0e,
+       0x0f};
+  unsigned char expected[] =
+      {0x69, 0xc4, 0xe0, 0xd8, 0x6a, 0x7b, 0x04, 0x30, 0xd8, 0xcd, 0xb7, 0x80, 0x70, 0xb4, 0xc5,
+       0x5a};
+  unsigned int len = 0;
+
+  unsigned char *out = aes.EncryptECB(plain, BLOCK_BYTES_LENGTH, key, len);
+  unsigned char *innew = aes.DecryptECB(out, BLOCK_BYTES_LENGTH, key);
+  EXPECT_FALSE(memcmp(expected, out, BLOCK_BYTES_LENGTH));
+  EXPECT_FALSE(memcmp(plain, innew, BLOCK_BYTES_LENGTH));
+  delete[] out;
+  delete[] innew;
+}
+
+TEST(Backends, TTableMatchesReference) {
+  const unsigned int length = 37 * BLOCK_BYTES_LENGTH;
+  unsigned char plain[length];
+  unsigned char key[32];
+  unsigned char iv[BLOCK_BYTES_LENGTH];
+  for (unsigned int i = 0; i < length; i++) {
+    plain[i] = (unsigned char) (i * 7 + 3);
+  }
+  for (unsigned int i = 0; i < sizeof(key); i++) {
+    key[i] = (unsigned char) (i * 13 + 1);
+  }
+  for (unsigned int i = 0; i < sizeof(iv); i++) {
+    iv[i] = (unsigned char) (0xf0 - i);
+  }
+
+  for (int keyLen : {128, 192, 256}) {
+    AES reference(keyLen, AESBackend::kReference);
+    AES table(keyLen, AESBackend::kTTable);
+    unsigned int referenceLen = 0, tableLen = 0;
+
+    unsigned char *expected = reference.EncryptCBC(plain, length, key, iv, referenceLen);
+    unsigned char *out = table.EncryptCBC(plain, length, key, iv, tableLen);
+    EXPECT_EQ(referenceLen, tableLen);
+    EXPECT_FALSE(memcmp(expected, out, length));
+
+    unsigned char *innew = table.DecryptCBC(out, length, key, iv);
+    EXPECT_FALSE(memcmp(plain, innew, length));
+
+    delete[] expected;
+    delete[] out;
+    delete[] innew;
+  }
+}
+
+TEST(Backends, AesNiMatchesTTable) {
+  AES probe(128);
+  if (probe.Backend() != AESBackend::kAesNi) {
+    GTEST_SKIP() << "AES-NI is not available";
+  }
+
+  const unsigned int length = 21 * BLOCK_BYTES_LENGTH + 5;
+  unsigned char plain[length];
+  unsigned char key[32];
+  unsigned char iv[BLOCK_BYTES_LENGTH];
+  for (unsigned int i = 0; i < length; i++) {
+    plain[i] = (unsigned char) (i * 11 + 5);
+  }
+  for (unsigned int i = 0; i < sizeof(key); i++) {
+    key[i] = (unsigned char) (i * 29 + 7);
+  }
+  for (unsigned int i = 0; i < sizeof(iv); i++) {
+    iv[i] = (unsigned char) (i * 3);
+  }
+
+  for (int keyLen : {128, 192, 256}) {
+    AES table(keyLen, AESBackend::kTTable);
+    AES hardware(keyLen, AESBackend::kAesNi);
+    unsigned int tableLen = 0, hardwareLen = 0;
+
+    unsigned char *expected = table.EncryptECB(plain, length, key, tableLen);
+    unsigned char *out = hardware.EncryptECB(plain, length, key, hardwareLen);
+    ASSERT_EQ(tableLen, hardwareLen);
+    EXPECT_FALSE(memcmp(expected, out, tableLen));
+    unsigned char *innew = hardware.DecryptECB(out, hardwareLen, key);
+    EXPECT_FALSE(memcmp(plain, innew, length));
+    delete[] expected;
+    delete[] out;
+    delete[] innew;
+
+    expected = table.EncryptCBC(plain, length, key, iv, tableLen);
+    out = hardware.EncryptCBC(plain, length, key, iv, hardwareLen);
+    EXPECT_FALSE(memcmp(expected, out, tableLen));
+    innew = hardware.DecryptCBC(out, hardwareLen, key, iv);
+    EXPECT_FALSE(memcmp(plain, innew, length));
+    delete[] expected;
+    delete[] out;
+    delete[] innew;
+
+    expected = table.EncryptCFB(plain, 6, length, key, iv, tableLen);
+    out = hardware.EncryptCFB(plain, 6, length, key, iv, hardwareLen);
+    EXPECT_FALSE(memcmp(expected, out, tableLen));
+    delete[] expected;
+    delete[] out;
+
+    expected = table.EncryptOFB(plain, length, key, iv, tableLen);
+    out = hardware.EncryptOFB(plain, length, key, iv, hardwareLen);
+    EXPECT_FALSE(memcmp(expected, out, tableLen));
+    delete[] expected;
+    delete[] out;
+
+    expected = table.EncryptCTR(plain, length, key, tableLen);
+    out = hardware.EncryptCTR(plain, length, key, hardwareLen);
+    EXPECT_FALSE(memcmp(expected, out, tableLen));
+    delete[] expected;
+    delete[] out;
+  }
+}
+
+TEST(ExpandedKey, MatchesRawKey) {
+  AES aes(192);
+  unsigned char plain[3 * BLOCK_BYTES_LENGTH];
+  for (unsigned int i = 0; i < sizeof(plain); i++) {
+    plain[i] = (unsigned char) (i * 5 + 1);
+  }
+  unsigned char iv[] =
+      {0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff,
+       0xff};
+  unsigned char key[] =
+      {0x00, 0x01, 0x02, 0x03, 0x04, 0x05, 0x06, 0x07, 0x08, 0x09, 0x0a, 0x0b, 0x0c, 0x0d, 0x0e,
+       0x0f, 0x10, 0x11,
+       0x12, 0x13, 0x14, 0x15, 0x16, 0x17};
+  const AesKey expanded = aes.ExpandKey(key);
+  EXPECT_EQ(12u, expanded.Rounds());
+  unsigned int len = 0, expandedLen = 0;
+
+  unsigned char *expected = aes.EncryptCBC(plain, sizeof(plain), key, iv, len);
+  unsigned char *out = aes.EncryptCBC(plain, sizeof(plain), expanded, iv, expandedLen);
+  EXPECT_EQ(len, expandedLen);
+  EXPECT_FALSE(memcmp(expected, out, len));
+  unsigned char *innew = aes.DecryptCBC(out, expandedLen, expanded, iv);
+  EXPECT_FALSE(memcmp(plain, innew, sizeof(plain)));
+  delete[] expected;
+  delete[] out;
+  delete[] innew;
+
+  expected = aes.EncryptCTR(plain, sizeof(plain), key, len);
+  out = aes.EncryptCTR(plain, sizeof(plain), expanded, expandedLen);
+  EXPECT_FALSE(memcmp(expected, out, len));
+  delete[] expected;
+  delete[] out;
+}
+
+TEST(ExpandedKey, WrongKeyLength) {
+  AES aes128(128);
+  AES aes256(256);
+  unsigned char key[32] = {0};
+  unsigned char plain[BLOCK_BYTES_LENGTH] = {0};
+  unsigned int len = 0;
+
+  const AesKey expanded = aes128.ExpandKey(key);
+  EXPECT_THROW(aes256.EncryptECB(plain, sizeof(plain), expanded, len), std::invalid_argument);
+}
+
+TEST(CallerBuffer, InPlaceMatchesAllocating) {
+  AES aes(128);
+  const unsigned int length = 19 * BLOCK_BYTES_LENGTH;
+  unsigned char plain[length], buffer[length];
+  unsigned char key[16], iv[BLOCK_BYTES_LENGTH];
+  for (unsigned int i = 0; i < length; i++) {
+    plain[i] = (unsigned char) (i * 17 + 9);
+  }
+  for (unsigned int i = 0; i < sizeof(key); i++) {
+    key[i] = (unsigned char) (0x40 + i);
+  }
+  memset(iv, 0x5a, sizeof(iv));
+  const AesKey expanded = aes.ExpandKey(key);
+  unsigned int len = 0;
+
+  unsigned char *expected = aes.EncryptCBC(plain, length, key, iv, len);
+  memcpy(buffer, plain, length);
+  aes.EncryptCBC(buffer, buffer, length, expanded, iv);
+  EXPECT_FALSE(memcmp(expected, buffer, length));
+  aes.DecryptCBC(buffer, buffer, length, expanded, iv);
+  EXPECT_FALSE(memcmp(plain, buffer, length));
+  delete[] expected;
+
+  expected = aes.EncryptCFB(plain, 6, length, key, iv, len);
+  memcpy(buffer, plain, length);
+  aes.EncryptCFB(buffer, buffer, length, 6, expanded, iv);
+  EXPECT_FALSE(memcmp(expected, buffer, length));
+  aes.DecryptCFB(buffer, buffer, length, 6, expanded, iv);
+  EXPECT_FALSE(memcmp(plain, buffer, length));
+  delete[] expected;
+
+  EXPECT_THROW(aes.EncryptECB(plain, buffer, length - 1, expanded), std::invalid_argument);
+}
+
+TEST(CallerBuffer, StreamModesPartialBlock) {
+  AES aes(256);
+  const unsigned int length = 5 * BLOCK_BYTES_LENGTH + 7;
+  unsigned char plain[length], out[length], innew[length];
+  unsigned char key[32], iv[BLOCK_BYTES_LENGTH];
+  unsigned char counter[] =
+      {0x00, 0x01, 0x02, 0x03, 0x04, 0x05, 0x06, 0x07, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00};
+  for (unsigned int i = 0; i < length; i++) {
+    plain[i] = (unsigned char) (i * 31);
+  }
+  for (unsigned int i = 0; i < sizeof(key); i++) {
+    key[i] = (unsigned char) (0x80 + i);
+  }
+  memset(iv, 0x11, sizeof(iv));
+  const AesKey expanded = aes.ExpandKey(key);
+  unsigned int len = 0;
+
+  // the padded allocating API produces the same prefix
+  unsigned char *expected = aes.EncryptCTR(plain, length, key, len);
+  aes.EncryptCTR(plain, out, length, expanded, counter);
+  EXPECT_FALSE(memcmp(expected, out, length));
+  aes.DecryptCTR(out, innew, length, expanded, counter);
+  EXPECT_FALSE(memcmp(plain, innew, length));
+  delete[] expected;
+
+  expected = aes.EncryptOFB(plain, length, key, iv, len);
+  aes.EncryptOFB(plain, out, length, expanded, iv);
+  EXPECT_FALSE(memcmp(expected, out, length));
+  aes.DecryptOFB(out, innew, length, expanded, iv);
+  EXPECT_FALSE(memcmp(plain, innew, length));
+  delete[] expected;
+
+  expected = aes.EncryptCFB(plain, 16, length, key, iv, len);
+  aes.EncryptCFB(plain, out, length, 16, expanded, iv);
+  EXPECT_FALSE(memcmp(expected, out, length));
+  aes.DecryptCFB(out, innew, length, 16, expanded, iv);
+  EXPECT_FALSE(memcmp(plain, innew, length));
+  delete[] expected;
+}
+
+TEST(Stream, ChunkedMatchesOneShot) {
+  AES aes(192);
+  const unsigned int length = 37 * BLOCK_BYTES_LENGTH + 5;
+  const size_t chunks[] = {1, 15, 16, 17, 3, 64, 0, 129, 7};
+  unsigned char plain[length], expected[length], out[length + BLOCK_BYTES_LENGTH];
+  unsigned char key[24], iv[BLOCK_BYTES_LENGTH];
+  for (unsigned int i = 0; i < length; i++) {
+    plain[i] = (unsigned char) (i * 13 + 1);
+  }
+  for (unsigned int i = 0; i < sizeof(key); i++) {
+    key[i] = (unsigned char) i;
+  }
+  memset(iv, 0x3c, sizeof(iv));
+  const AesKey expanded = aes.ExpandKey(key);
+
+  const AesStreamMode modes[] = {AesStreamMode::kCFB, AesStreamMode::kOFB, AesStreamMode::kCTR};
+  for (AesStreamMode mode : modes) {
+    for (uint32_t s : {16u, 5u}) {
+      if (mode == AesStreamMode::kCFB) {
+        aes.EncryptCFB(plain, expected, length, s, expanded, iv);
+      } else if (mode == AesStreamMode::kOFB) {
+        aes.EncryptOFB(plain, expected, length, expanded, iv);
+      } else {
+        aes.EncryptCTR(plain, expected, length, expanded, iv);
+      }
+
+      AesStream encryptor(aes, expanded, mode, true, s);
+      AesStream decryptor(aes, expanded, mode, false, s);
+      encryptor.Init(iv);
+      decryptor.Init(iv);
+      size_t done = 0;
+      for (size_t i = 0; done < length; i++) {
+        const size_t chunk = chunks[i % 9] < length - done ? chunks[i % 9] : length - done;
+        EXPECT_EQ(chunk, encryptor.Update(plain + done, out + done, chunk));
+        done += chunk;
+      }
+      EXPECT_EQ(0u, encryptor.Final(out + done));
+      EXPECT_EQ(length, encryptor.Length());
+      EXPECT_FALSE(memcmp(expected, out, length));
+
+      // in place, in the opposite chunk order
+      done = 0;
+      for (size_t i = 0; done < length; i++) {
+        const size_t chunk = chunks[8 - i % 9] < length - done ? chunks[8 - i % 9] : length - done;
+        decryptor.Update(out + done, out + done, chunk);
+        done += chunk;
+      }
+      EXPECT_EQ(0u, decryptor.Final(out + done));
+      EXPECT_FALSE(memcmp(plain, out, length));
+    }
+  }
+}
+
+TEST(Stream, CbcBuffersPartialBlocks) {
+  AES aes(128);
+  const unsigned int length = 21 * BLOCK_BYTES_LENGTH + 9;
+  const unsigned int padded = 22 * BLOCK_BYTES_LENGTH;
+  unsigned char plain[padded], expected[padded], out[padded + BLOCK_BYTES_LENGTH], back[padded + BLOCK_BYTES_LENGTH];
+  unsigned char key[16], iv[BLOCK_BYTES_LENGTH];
+  for (unsigned int i = 0; i < padded; i++) {
+    plain[i] = i < length ? (unsigned char) (i * 7 + 3) : 0;
+  }
+  for (unsigned int i = 0; i < sizeof(key); i++) {
+    key[i] = (unsigned char) (0xf0 - i);
+  }
+  memset(iv, 0xa5, sizeof(iv));
+  const AesKey expanded = aes.ExpandKey(key);
+  aes.EncryptCBC(plain, expected, padded, expanded, iv);
+
+  AesStream encryptor(aes, expanded, AesStreamMode::kCBC, true);
+  encryptor.Init(iv);
+  size_t in = 0, written = 0;
+  for (size_t chunk = 1; in < length; chunk += 6) {
+    const size_t n = chunk < length - in ? chunk : length - in;
+    written += encryptor.Update(plain + in, out + written, n);
+    in += n;
+    EXPECT_EQ(in / BLOCK_BYTES_LENGTH * BLOCK_BYTES_LENGTH, written);
+  }
+  written += encryptor.Final(out + written);
+  EXPECT_EQ(padded, written);
+  EXPECT_FALSE(memcmp(expected, out, padded));
+
+  AesStream decryptor(aes, expanded, AesStreamMode::kCBC, false);
+  decryptor.Init(iv);
+  written = decryptor.Update(out, back, 40);
+  written += decryptor.Update(out + 40, back + written, padded - 40);
+  EXPECT_EQ(0u, decryptor.Final(back + written));
+  EXPECT_EQ(padded, written);
+  EXPECT_FALSE(memcmp(plain, back, padded));
+
+  decryptor.Init(iv);
+  decryptor.Update(out, back, 20);
+  EXPECT_THROW(decryptor.Final(back), std::invalid_argument);
+  EXPECT_THROW(decryptor.Update(out, back, 16), std::logic_error);
+}
+
+TEST(CTR, RandomAccessMatchesFullStream) {
+  AES aes(256);
+  const unsigned int length = 50 * BLOCK_BYTES_LENGTH + 3;
+  unsigned char plain[length], full[length], slice[length];
+  unsigned char key[32];
+  // the block counter wraps inside the message, the nonce half must stay untouched
+  unsigned char counter[] =
+      {0xca, 0xfe, 0xba, 0xbe, 0xfa, 0xce, 0xdb, 0xad, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xf0};
+  for (unsigned int i = 0; i < length; i++) {
+    plain[i] = (unsigned char) (i * 5 + 2);
+  }
+  for (unsigned int i = 0; i < sizeof(key); i++) {
+    key[i] = (unsigned char) (i * 3);
+  }
+  const AesKey expanded = aes.ExpandKey(key);
+  aes.EncryptCTR(plain, full, length, expanded, counter);
+
+  const size_t offsets[] = {0, 1, 15, 16, 17, 255, 256, 400, 800};
+  for (size_t offset : offsets) {
+    const size_t len = length - offset < 97 ? length - offset : 97;
+    aes.EncryptCTR(plain + offset, slice, len, expanded, counter, offset);
+    EXPECT_FALSE(memcmp(full + offset, slice, len)) << offset;
+    aes.DecryptCTR(slice, slice, len, expanded, counter, offset);
+    EXPECT_FALSE(memcmp(plain + offset, slice, len)) << offset;
+  }
+
+  AesStream stream(aes, expanded, AesStreamMode::kCTR, false);
+  stream.Init(counter);
+  for (size_t offset : offsets) {
+    stream.Seek(offset);
+    const size_t len = length - offset < 40 ? length - offset : 40;
+    EXPECT_EQ(len, stream.Update(full + offset, slice, len));
+    EXPECT_EQ(offset + len, stream.Length());
+    EXPECT_FALSE(memcmp(plain + offset, slice, len)) << offset;
+  }
+
+  AesStream cbc(aes, expanded, AesStreamMode::kCBC, true);
+  cbc.Init(counter);
+  EXPECT_THROW(cbc.Seek(16), std::logic_error);
+}
+
+// every task waits for the others, so they only finish if each thread of the pool took one
+TEST(Parallel, PoolRunsOnItsWorkers) {
+  WorkerPool pool(3);
+  ASSERT_EQ(pool.Workers(), 3u);
+  std::atomic<size_t> started(0);
+  std::thread::id ids[4];
+  pool.Run(4, [&](size_t task) {
+    ids[task] = std::this_thread::get_id();
+    started++;
+    const auto deadline = std::chrono::steady_clock::now() + std::chrono::seconds(10);
+    while (started < 4 && std::chrono::steady_clock::now() < deadline) {
+      std::this_thread::yield();
+    }
+  });
+  EXPECT_EQ(std::set<std::thread::id>(ids, ids + 4).size(), 4u);
+}
+
+TEST(Parallel, MatchesSerial) {
+  AES serial(128), parallel(128);
+  serial.SetParallelism(1);
+  parallel.SetParallelism(5, 16);
+  // real workers whatever the CPU count, the shared pool has none on a single CPU
+  WorkerPool pool(3);
+  parallel.SetWorkerPool(&pool);
+  const unsigned int length = 301 * BLOCK_BYTES_LENGTH;
+  static unsigned char plain[length], expected[length], out[length];
+  unsigned char key[16], iv[BLOCK_BYTES_LENGTH];
+  for (unsigned int i = 0; i < length; i++) {
+    plain[i] = (unsigned char) (i * 11 + (i >> 8));
+  }
+  for (unsigned int i = 0; i < sizeof(key); i++) {
+    key[i] = (unsigned char) (i + 100);
+  }
+  memset(iv, 0xfe, sizeof(iv));
+  const AesKey expanded = serial.ExpandKey(key);
+
+  serial.EncryptECB(plain, expected, length, expanded);
+  parallel.EncryptECB(plain, out, length, expanded);
+  EXPECT_FALSE(memcmp(expected, out, length));
+  parallel.DecryptECB(out, out, length, expanded);
+  EXPECT_FALSE(memcmp(plain, out, length));
+
+  // odd length and a counter that wraps inside the buffer
+  unsigned char counter[BLOCK_BYTES_LENGTH];
+  memset(counter, 0xff, sizeof(counter));
+  counter[15] = 0x00;
+  serial.EncryptCTR(plain, expected, length - 9, expanded, counter, 3);
+  parallel.EncryptCTR(plain, out, length - 9, expanded, counter, 3);
+  EXPECT_FALSE(memcmp(expected, out, length - 9));
+
+  serial.EncryptCBC(plain, expected, length, expanded, iv);
+  memcpy(out, expected, length);
+  parallel.DecryptCBC(out, out, length, expanded, iv);
+  EXPECT_FALSE(memcmp(plain, out, length));
+
+  for (uint32_t s : {16u, 3u}) {
+    serial.EncryptCFB(plain, expected, length - 5, s, expanded, iv);
+    memcpy(out, expected, length);
+    parallel.DecryptCFB(out, out, length - 5, s, expanded, iv);
+    EXPECT_FALSE(memcmp(plain, out, length - 5)) << s;
+  }
+
+  // the stream contexts carry the register across parallel calls
+  AesStream stream(parallel, expanded, AesStreamMode::kCFB, false, 3);
+  stream.Init(iv);
+  serial.EncryptCFB(plain, expected, length, 3, expanded, iv);
+  EXPECT_EQ(100u, stream.Update(expected, out, 100));
+  EXPECT_EQ(length - 100, stream.Update(expected + 100, out + 100, length - 100));
+  EXPECT_FALSE(memcmp(plain, out, length));
+}
+
+static std::vector<unsigned char> FromHex(const char *hex) {
+  std::vector<unsigned char> bytes;
+  for (size_t i = 0; hex[i] && hex[i + 1]; i += 2) {
+    bytes.push_back((unsigned char) std::stoi(std::string(hex + i, 2), nullptr, 16));
+  }
+  return bytes;
+}
+
+struct GcmVector {
+  const char *key, *iv, *aad, *plain, *cipher, *tag;
+};
+
+// test cases 2, 3, 4, 6 and 16 of the GCM specification
+static const GcmVector kGcmVectors[] = {
+    {"00000000000000000000000000000000", "000000000000000000000000", "", "00000000000000000000000000000000",
+     "0388dace60b6a392f328c2b971b2fe78", "ab6e47d42cec13bdf53a67b21257bddf"},
+    {"feffe9928665731c6d6a8f9467308308", "cafebabefacedbaddecaf888", "",
+     "d9313225f88406e5a55909c5aff5269a86a7a9531534f7da2e4c303d8a318a721c3c0c95956809532fcf0e2449a6b525"
+     "b16aedf5aa0de657ba637b391aafd255",
+     "42831ec2217774244b7221b784d0d49ce3aa212f2c02a4e035c17e2329aca12e21d514b25466931c7d8f6a5aac84aa05"
+     "1ba30b396a0aac973d58e091473f5985",
+     "4d5c2af327cd64a62cf35abd2ba6fab4"},
+    {"feffe9928665731c6d6a8f9467308308", "cafebabefacedbaddecaf888", "feedfacedeadbeeffeedfacedeadbeefabaddad2",
+     "d9313225f88406e5a55909c5aff5269a86a7a9531534f7da2e4c303d8a318a721c3c0c95956809532fcf0e2449a6b525"
+     "b16aedf5aa0de657ba637b39",
+     "42831ec2217774244b7221b784d0d49ce3aa212f2c02a4e035c17e2329aca12e21d514b25466931c7d8f6a5aac84aa05"
+     "1ba30b396a0aac973d58e091",
+     "5bc94fbc3221a5db94fae95ae7121a47"},
+    {"feffe9928665731c6d6a8f9467308308",
+     "9313225df88406e555909c5aff5269aa6a7a9538534f7da1e4c303d2a318a728c3c0c95156809539fcf0e2429a6b5254"
+     "16aedbf5a0de6a57a637b39b",
+     "feedfacedeadbeeffeedfacedeadbeefabaddad2",
+     "d9313225f88406e5a55909c5aff5269a86a7a9531534f7da2e4c303d8a318a721c3c0c95956809532fcf0e2449a6b525"
+     "b16aedf5aa0de657ba637b39",
+     "8ce24998625615b603a033aca13fb894be9112a5c3a211a8ba262a3cca7e2ca701e4a9a4fba43c90ccdcb281d48c7c6f"
+     "d62875d2aca417034c34aee5",
+     "619cc5aefffe0bfa462af43c1699d050"},
+    {"feffe9928665731c6d6a8f9467308308feffe9928665731c6d6a8f9467308308", "cafebabefacedbaddecaf888",
+     "feedfacedeadbeeffeedfacedeadbeefabaddad2",
+     "d9313225f88406e5a55909c5aff5269a86a7a9531534f7da2e4c303d8a318a721c3c0c95956809532fcf0e2449a6b525"
+     "b16aedf5aa0de657ba637b39",
+     "522dc1f099567d07f47f37a32a84427d643a8cdcbfe5c0c97598a2bd2555d1aa8cb08e48590dbb3da7b08b1056828838"
+     "c5f61e6393ba7a0abcc9f662",
+     "76fc6ece0f4e1768cddf8853bb2d551b"},
+};
+
+TEST(GCM, KnownAnswer) {
+  std::vector<std::pair<AESBackend, GhashBackend>> backends = {
+      {AESBackend::kTTable, GhashBackend::kTable}, {AESBackend::kReference, GhashBackend::kTable}};
+  AES probe;
+  unsigned char zeros[32] = {};
+  if (AesGcm(probe, probe.ExpandKey(zeros), true).Backend() == GhashBackend::kClmul) {
+    backends.emplace_back(AESBackend::kTTable, GhashBackend::kClmul);
+    if (probe.Backend() == AESBackend::kAesNi) {
+      backends.emplace_back(AESBackend::kAesNi, GhashBackend::kClmul);
+    }
+  }
+
+  for (const auto &backend : backends) {
+    for (const GcmVector &vector : kGcmVectors) {
+      const auto key = FromHex(vector.key), iv = FromHex(vector.iv), aad = FromHex(vector.aad);
+      const auto plain = FromHex(vector.plain), cipher = FromHex(vector.cipher), tag = FromHex(vector.tag);
+      AES aes((int) key.size() * 8, backend.first);
+      const AesKey expanded = aes.ExpandKey(key.data());
+      std::vector<unsigned char> out(plain.size());
+      unsigned char computed[16];
+
+      AesGcm encryptor(aes, expanded, true, backend.second);
+      encryptor.Init(iv.data(), iv.size());
+      encryptor.UpdateAad(aad.data(), aad.size());
+      encryptor.Update(plain.data(), out.data(), plain.size());
+      encryptor.Final(computed);
+      EXPECT_EQ(cipher, out);
+      EXPECT_FALSE(memcmp(tag.data(), computed, tag.size()));
+
+      AesGcm decryptor(aes, expanded, false, backend.second);
+      decryptor.Init(iv.data(), iv.size());
+      decryptor.UpdateAad(aad.data(), aad.size());
+      decryptor.Update(out.data(), out.data(), out.size());
+      EXPECT_TRUE(decryptor.Verify(tag.data(), tag.size()));
+      EXPECT_EQ(plain, out);
+    }
+  }
+}
+
+TEST(GCM, StreamingAndTampering) {
+  AES aes(256);
+  const unsigned int length = 70 * BLOCK_BYTES_LENGTH + 11;
+  static unsigned char plain[length], expected[length], out[length];
+  unsigned char key[32], iv[12], aad[45], tag[16], streamedTag[16];
+  for (unsigned int i = 0; i < length; i++) {
+    plain[i] = (unsigned char) (i * 29 + 4);
+  }
+  for (unsigned int i = 0; i < sizeof(key); i++) {
+    key[i] = (unsigned char) (i * 7);
+  }
+  memset(iv, 0x42, sizeof(iv));
+  memset(aad, 0x17, sizeof(aad));
+  const AesKey expanded = aes.ExpandKey(key);
+
+  AesGcm gcm(aes, expanded, true, GhashBackend::kTable);
+  gcm.Init(iv, sizeof(iv));
+  gcm.UpdateAad(aad, sizeof(aad));
+  gcm.Update(plain, expected, length);
+  gcm.Final(tag);
+
+  // other GHASH backend, odd chunks of AAD and data
+  AesGcm chunked(aes, expanded, true);
+  chunked.Init(iv, sizeof(iv));
+  chunked.UpdateAad(aad, 3);
+  chunked.UpdateAad(aad + 3, 20);
+  chunked.UpdateAad(aad + 23, sizeof(aad) - 23);
+  const size_t chunks[] = {1, 15, 100, 16, 0, 257, 5};
+  size_t done = 0;
+  for (size_t i = 0; done < length; i++) {
+    const size_t chunk = chunks[i % 7] < length - done ? chunks[i % 7] : length - done;
+    chunked.Update(plain + done, out + done, chunk);
+    done += chunk;
+  }
+  chunked.Final(streamedTag);
+  EXPECT_FALSE(memcmp(expected, out, length));
+  EXPECT_FALSE(memcmp(tag, streamedTag, sizeof(tag)));
+  EXPECT_THROW(chunked.Update(plain, out, 1), std::logic_error);
+
+  AesGcm decryptor(aes, expanded, false);
+  decryptor.Init(iv, sizeof(iv));
+  decryptor.UpdateAad(aad, sizeof(aad));
+  decryptor.Update(expected, out, 1000);
+  EXPECT_THROW(decryptor.UpdateAad(aad, 1), std::logic_error);
+  decryptor.Update(expected + 1000, out + 1000, length - 1000);
+  EXPECT_TRUE(decryptor.Verify(tag, 12));
+  EXPECT_FALSE(memcmp(plain, out, length));
+
+  expected[length / 2] ^= 0x01;
+  decryptor.Init(iv, sizeof(iv));
+  decryptor.UpdateAad(aad, sizeof(aad));
+  decryptor.Update(expected, out, length);
+  EXPECT_FALSE(decryptor.Verify(tag));
+}
+
+struct XtsVector {
+  const char *key, *tweak, *plain, *cipher;
+};
+
+// IEEE 1619 vectors 1, 2, 15 and 16, the last two need ciphertext stealing
+static const XtsVector kXtsVectors[] = {
+    {"0000000000000000000000000000000000000000000000000000000000000000", "00000000000000000000000000000000",
+     "0000000000000000000000000000000000000000000000000000000000000000",
+     "917cf69ebd68b2ec9b9fe9a3eadda692cd43d2f59598ed858c02c2652fbf922e"},
+    {"1111111111111111111111111111111122222222222222222222222222222222", "33333333330000000000000000000000",
+     "4444444444444444444444444444444444444444444444444444444444444444",
+     "c454185e6a16936e39334038acef838bfb186fff7480adc4289382ecd6d394f0"},
+    {"fffefdfcfbfaf9f8f7f6f5f4f3f2f1f0bfbebdbcbbbab9b8b7b6b5b4b3b2b1b0", "9a785634120000000000000000000000",
+     "000102030405060708090a0b0c0d0e0f10", "6c1625db4671522d3d7599601de7ca09ed"},
+    {"fffefdfcfbfaf9f8f7f6f5f4f3f2f1f0bfbebdbcbbbab9b8b7b6b5b4b3b2b1b0", "9a785634120000000000000000000000",
+     "000102030405060708090a0b0c0d0e0f1011", "d069444b7a7e0cab09e24447d24deb1fedbf"},
+};
+
+TEST(XTS, KnownAnswer) {
+  for (const XtsVector &vector : kXtsVectors) {
+    const auto key = FromHex(vector.key), tweak = FromHex(vector.tweak);
+    const auto plain = FromHex(vector.plain), cipher = FromHex(vector.cipher);
+    AES aes(128);
+    AesXts xts(aes, key.data());
+    std::vector<unsigned char> out(plain.size());
+
+    xts.Encrypt(plain.data(), out.data(), plain.size(), tweak.data());
+    EXPECT_EQ(cipher, out);
+    xts.Decrypt(out.data(), out.data(), out.size(), tweak.data());
+    EXPECT_EQ(plain, out);
+  }
+}
+
+TEST(XTS, SectorBatches) {
+  AES aes(256);
+  aes.SetParallelism(3, 16);
+  const size_t sectorLen = 520, sectors = 9;
+  static unsigned char plain[sectorLen * sectors], batch[sectorLen * sectors], single[sectorLen * sectors];
+  unsigned char key[64], tweaks[16 * sectors];
+  for (size_t i = 0; i < sizeof(plain); i++) {
+    plain[i] = (unsigned char) (i * 19 + 7);
+  }
+  for (size_t i = 0; i < sizeof(key); i++) {
+    key[i] = (unsigned char) (i * 5 + 1);
+  }
+  memset(tweaks, 0, sizeof(tweaks));
+  for (size_t i = 0; i < sectors; i++) {
+    tweaks[16 * i] = (unsigned char) (0xfe + i);
+    tweaks[16 * i + 1] = (unsigned char) ((0xfe + i) >> 8u);
+  }
+  const AesXts xts(aes, key);
+
+  for (size_t i = 0; i < sectors; i++) {
+    xts.Encrypt(plain + i * sectorLen, single + i * sectorLen, sectorLen, tweaks + 16 * i);
+  }
+  xts.EncryptSectors(plain, batch, sectorLen, sectors, 0xfe);
+  EXPECT_FALSE(memcmp(single, batch, sizeof(batch)));
+  xts.DecryptSectors(batch, batch, sectorLen, sectors, tweaks);
+  EXPECT_FALSE(memcmp(plain, batch, sizeof(batch)));
+
+  // sector numbers past 2^64 - 1 carry into the upper half of the tweak
+  memset(tweaks, 0, sizeof(tweaks));
+  memset(tweaks, 0xff, 8);
+  tweaks[16 + 8] = 1;
+  tweaks[32] = 1;
+  tweaks[32 + 8] = 1;
+  for (size_t i = 0; i < 3; i++) {
+    xts.Encrypt(plain + i * sectorLen, single + i * sectorLen, sectorLen, tweaks + 16 * i);
+  }
+  xts.EncryptSectors(plain, batch, sectorLen, 3, UINT64_MAX);
+  EXPECT_FALSE(memcmp(single, batch, 3 * sectorLen));
+
+  EXPECT_THROW(xts.Encrypt(plain, batch, 15, tweaks), std::invalid_argument);
+  EXPECT_THROW(xts.EncryptSectors(plain, batch, 8, 2, (uint64_t) 0), std::invalid_argument);
+}
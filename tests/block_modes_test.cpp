@@ -0,0 +1,82 @@
+#include <vector>
+
+#include "block_modes.h"
+#include "gtest/gtest.h"
+
+// 8-byte toy cipher: add the key and rotate the block by one byte, the modes don't care
+class ToyModes : public BlockModes<ToyModes, 8, 3 * 8> {
+ public:
+  explicit ToyModes(uint8_t key) : key(key) {}
+
+  void EncryptBlocks(const uint8_t in[], uint8_t out[], size_t blocks) const {
+    for (size_t b = 0; b < blocks; b++) {
+      uint8_t block[kBlockBytes];
+      for (size_t i = 0; i < kBlockBytes; i++) {
+        block[(i + 1) % kBlockBytes] = (uint8_t) (in[b * kBlockBytes + i] + key);
+      }
+      memcpy(out + b * kBlockBytes, block, kBlockBytes);
+    }
+  }
+
+  void DecryptBlocks(const uint8_t in[], uint8_t out[], size_t blocks) const {
+    for (size_t b = 0; b < blocks; b++) {
+      uint8_t block[kBlockBytes];
+      for (size_t i = 0; i < kBlockBytes; i++) {
+        block[i] = (uint8_t) (in[b * kBlockBytes + (i + 1) % kBlockBytes] - key);
+      }
+      memcpy(out + b * kBlockBytes, block, kBlockBytes);
+    }
+  }
+
+  void CounterStart(const uint8_t iv[], uint64_t block, uint8_t counter[]) const {
+    memcpy(counter, iv, kBlockBytes);
+    CounterAdd(counter, block);
+  }
+
+  static void CounterAdd(uint8_t counter[], uint64_t n) {
+    counter[0] = (uint8_t) (counter[0] + n);
+  }
+
+ private:
+  uint8_t key;
+};
+
+TEST(BlockModes, ThirdCipher) {
+  const ToyModes modes(0x5a);
+  const uint8_t iv[8] = {1, 2, 3, 4, 5, 6, 7, 8};
+  // 7 blocks: two batches of three and a single block
+  const size_t len = 7 * 8;
+  std::vector<uint8_t> plain(len), cipher(len), out(len);
+  for (size_t i = 0; i < len; i++) {
+    plain[i] = (uint8_t) (i * 11 + 3);
+  }
+
+  modes.EncryptECB(plain.data(), cipher.data(), len);
+  modes.DecryptECB(cipher.data(), out.data(), len);
+  ASSERT_EQ(plain, out);
+
+  // CBC by hand: the first block is the iv xored with the plaintext
+  modes.EncryptCBC(plain.data(), cipher.data(), len, iv);
+  uint8_t first[8];
+  ToyModes::Xor(plain.data(), iv, first, 8);
+  modes.EncryptBlocks(first, first, 1);
+  ASSERT_FALSE(memcmp(first, cipher.data(), 8));
+  modes.DecryptCBC(cipher.data(), cipher.data(), len, iv);
+  ASSERT_EQ(plain, cipher);
+
+  modes.EncryptCFB(plain.data(), cipher.data(), len - 3, 3, iv);
+  modes.DecryptCFB(cipher.data(), out.data(), len - 3, 3, iv);
+  ASSERT_FALSE(memcmp(plain.data(), out.data(), len - 3));
+
+  modes.EncryptOFB(plain.data(), cipher.data(), len - 1, iv);
+  modes.EncryptOFB(cipher.data(), out.data(), len - 1, iv);
+  ASSERT_FALSE(memcmp(plain.data(), out.data(), len - 1));
+
+  // a range from the middle of the stream matches the same bytes of the whole stream
+  modes.EncryptCTR(plain.data(), cipher.data(), len, iv, 0);
+  modes.EncryptCTR(plain.data() + 13, out.data(), len - 13, iv, 13);
+  ASSERT_FALSE(memcmp(cipher.data() + 13, out.data(), len - 13));
+
+  ASSERT_THROW(modes.EncryptECB(plain.data(), cipher.data(), len - 1), std::invalid_argument);
+  ASSERT_THROW(modes.EncryptCFB(plain.data(), cipher.data(), len, 9, iv), std::invalid_argument);
+}
@@ -0,0 +1,147 @@
+#include <fcntl.h>
+#include <unistd.h>
+
+#include <cstdlib>
+#include <functional>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "aes.h"
+#include "aes_stream.h"
+#include "file_pipeline.h"
+#include "kalyna.h"
+#include "kalyna_stream.h"
+#include "gtest/gtest.h"
+
+static const uint8_t kKey[64] = {0x00, 0x01, 0x02, 0x03, 0x04, 0x05, 0x06, 0x07, 0x08, 0x09, 0x0a, 0x0b, 0x0c,
+                                 0x0d, 0x0e, 0x0f, 0x10, 0x11, 0x12, 0x13, 0x14, 0x15, 0x16, 0x17, 0x18, 0x19};
+static const uint8_t kIv[64] = {0xf0, 0xf1, 0xf2, 0xf3, 0xf4, 0xf5, 0xf6, 0xf7, 0xf8, 0xf9, 0xfa, 0xfb};
+
+// file in TMPDIR, removed with the object
+struct TempFile {
+  explicit TempFile(const std::vector<uint8_t> &data) {
+    const char *dir = getenv("TMPDIR");
+    std::string name = std::string(dir ? dir : "/tmp") + "/file_pipeline_testXXXXXX";
+    fd = mkstemp(&name[0]);
+    path = name;
+    if (fd >= 0 && !data.empty()) {
+      WriteFull(fd, data.data(), data.size(), 0);
+    }
+  }
+
+  ~TempFile() {
+    if (fd >= 0) {
+      close(fd);
+      unlink(path.c_str());
+    }
+  }
+
+  std::vector<uint8_t> Read(size_t len) const {
+    std::vector<uint8_t> data(len);
+    ReadFull(fd, data.data(), len, 0);
+    return data;
+  }
+
+  int fd;
+  std::string path;
+};
+
+template<typename Context>
+static PipelineStream Wrap(const std::shared_ptr<Context> &context, size_t blockBytes) {
+  context->Init(kIv);
+  return {[context](const uint8_t in[], uint8_t out[], size_t len) { return context->Update(in, out, len); },
+          [context](uint8_t out[]) { return context->Final(out); }, blockBytes};
+}
+
+// Streams data through the backend with a buffer that is not a whole number of blocks, at
+// queue depth 1 and 8, and compares the file with a single Update and Final of a new context.
+static void ExpectMatchesOneShot(PipelineBackend backend, const std::function<PipelineStream()> &make,
+                                 const std::vector<uint8_t> &data) {
+  const PipelineStream oneShot = make();
+  std::vector<uint8_t> expected(data.size() + 2 * oneShot.blockBytes);
+  size_t expectedLen = oneShot.update(data.data(), expected.data(), data.size());
+  expectedLen += oneShot.final(expected.data() + expectedLen);
+  expected.resize(expectedLen);
+
+  const TempFile in(data);
+  ASSERT_GE(in.fd, 0);
+  for (size_t depth : {1, 8}) {
+    const TempFile out({});
+    ASSERT_GE(out.fd, 0);
+    PipelineOptions options;
+    options.backend = backend;
+    options.queueDepth = depth;
+    options.bufferBytes = 1000;
+    PipelineBackend used;
+    const uint64_t written = RunPipeline(in.fd, out.fd, data.size(), make(), options, used);
+    ASSERT_EQ(used, backend);
+    ASSERT_EQ(written, expected.size()) << "depth " << depth;
+    ASSERT_EQ(out.Read(expected.size()), expected) << "depth " << depth;
+  }
+}
+
+static void ExpectBackendMatches(PipelineBackend backend) {
+  std::vector<uint8_t> data(10240 + 7);
+  for (size_t i = 0; i < data.size(); i++) {
+    data[i] = (uint8_t) (i * 131 + 7);
+  }
+  // CBC decryption needs whole blocks, 10240 bytes are whole blocks of every size
+  const std::vector<uint8_t> blocks(data.begin(), data.begin() + 10240);
+
+  const AES aes(128);
+  const AesKey aesKey = aes.ExpandKey(kKey);
+  for (AesStreamMode mode : {AesStreamMode::kCBC, AesStreamMode::kCFB, AesStreamMode::kCTR}) {
+    for (bool encrypt : {true, false}) {
+      ExpectMatchesOneShot(backend, [&] {
+        return Wrap(std::make_shared<AesStream>(aes, aesKey, mode, encrypt), 16);
+      }, mode == AesStreamMode::kCBC && !encrypt ? blocks : data);
+    }
+  }
+
+  for (const auto &size : {std::make_pair(128, 256), std::make_pair(512, 512)}) {
+    const Kalyna kalyna(size.first, size.second);
+    const KalynaKey kalynaKey = kalyna.ExpandKey(kKey);
+    for (KalynaStreamMode mode : {KalynaStreamMode::kCBC, KalynaStreamMode::kOFB, KalynaStreamMode::kCTR}) {
+      for (bool encrypt : {true, false}) {
+        ExpectMatchesOneShot(backend, [&] {
+          return Wrap(std::make_shared<KalynaStream>(kalyna, kalynaKey, mode, encrypt), kalyna.BlockBytes());
+        }, mode == KalynaStreamMode::kCBC && !encrypt ? blocks : data);
+      }
+    }
+  }
+}
+
+TEST(FilePipeline, Sync) {
+  ExpectBackendMatches(PipelineBackend::kSync);
+}
+
+TEST(FilePipeline, Threads) {
+  ExpectBackendMatches(PipelineBackend::kThreads);
+}
+
+TEST(FilePipeline, Uring) {
+  if (!UringAvailable()) {
+    GTEST_SKIP() << "io_uring is not available";
+  }
+  ExpectBackendMatches(PipelineBackend::kUring);
+}
+
+TEST(FilePipeline, EmptyFileAndOptions) {
+  const TempFile in({}), out({});
+  ASSERT_GE(in.fd, 0);
+  ASSERT_GE(out.fd, 0);
+  const AES aes(128);
+  const AesKey key = aes.ExpandKey(kKey);
+  const PipelineStream stream = Wrap(std::make_shared<AesStream>(aes, key, AesStreamMode::kCBC, true), 16);
+  PipelineOptions options;
+  PipelineBackend used;
+  // an empty CBC message has no tail to pad
+  ASSERT_EQ(RunPipeline(in.fd, out.fd, 0, stream, options, used), 0u);
+
+  options.queueDepth = 0;
+  EXPECT_THROW(RunPipeline(in.fd, out.fd, 0, stream, options, used), std::invalid_argument);
+  options.queueDepth = 1;
+  options.bufferBytes = 0;
+  EXPECT_THROW(RunPipeline(in.fd, out.fd, 0, stream, options, used), std::invalid_argument);
+}
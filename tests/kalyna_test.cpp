@@ -1,5 +1,10 @@
 #include "gtest/gtest.h"
 #include "kalyna.h"
+#include "kalyna_gcm.h"
+#include "kalyna_stream.h"
+
+#include <thread>
+#include <vector>
 
 TEST(Kalyna, Kalyna_128_128) {
   Kalyna kalyna_encryption(128, 128);
@@ -167,4 +172,576 @@ TEST(Kalyna, Kalyna_512_512) {
   kalyna_decryption.Decipher(ct88_d, pt88_d);
 
   ASSERT_FALSE(memcmp(pt88_d, expect88_d, sizeof(pt88_d)));
-}
\ No newline at end of file
+}
+TEST(Kalyna, CompileTimeCipher) {
+  KalynaCipher<256, 512> cipher;
+
+  uint64_t block[4] =
+      {0x4746454443424140ULL, 0x4f4e4d4c4b4a4948ULL, 0x5756555453525150ULL, 0x5f5e5d5c5b5a5958ULL};
+  const uint64_t key[8] =
+      {0x0706050403020100ULL, 0x0f0e0d0c0b0a0908ULL, 0x1716151413121110ULL, 0x1f1e1d1c1b1a1918ULL,
+       0x2726252423222120ULL, 0x2f2e2d2c2b2a2928ULL, 0x3736353433323130ULL, 0x3f3e3d3c3b3a3938ULL};
+  const uint64_t plain[4] =
+      {0x4746454443424140ULL, 0x4f4e4d4c4b4a4948ULL, 0x5756555453525150ULL, 0x5f5e5d5c5b5a5958ULL};
+  const uint64_t expect[4] =
+      {0x7ab6b7e6e9906960ULL, 0xb76822d793d8d64bULL, 0x02e1d73c3cc8028eULL, 0xd95dfefda8742efdULL};
+
+  // in place, the state lives on the stack
+  cipher.KeyExpand(key);
+  cipher.Encipher(block, block);
+  ASSERT_FALSE(memcmp(block, expect, sizeof(block)));
+
+  cipher.Decipher(block, block);
+  ASSERT_FALSE(memcmp(block, plain, sizeof(block)));
+
+  ASSERT_THROW(Kalyna(512, 256), std::invalid_argument);
+}
+
+TEST(Kalyna, ByteInterface) {
+  // DSTU 7624 example 128/128 as bytes, one byte into the buffers so no word is aligned
+  const uint8_t key[17] = {0, 0x00, 0x01, 0x02, 0x03, 0x04, 0x05, 0x06, 0x07, 0x08, 0x09, 0x0a, 0x0b, 0x0c, 0x0d,
+                           0x0e, 0x0f};
+  const uint8_t plain[17] = {0, 0x10, 0x11, 0x12, 0x13, 0x14, 0x15, 0x16, 0x17, 0x18, 0x19, 0x1a, 0x1b, 0x1c, 0x1d,
+                             0x1e, 0x1f};
+  const uint8_t expect[16] = {0x81, 0xbf, 0x1c, 0x7d, 0x77, 0x9b, 0xac, 0x20, 0xe1, 0xc9, 0xea, 0x39, 0xb4, 0xd2,
+                              0xad, 0x06};
+  const Kalyna kalyna(128, 128);
+  const KalynaKey expanded = kalyna.ExpandKey(key + 1);
+
+  uint8_t block[17];
+  kalyna.Encipher(plain + 1, block + 1, expanded);
+  ASSERT_FALSE(memcmp(block + 1, expect, sizeof(expect)));
+  kalyna.Decipher(block + 1, block + 1, expanded);
+  ASSERT_FALSE(memcmp(block + 1, plain + 1, 16));
+
+  // bytes are read as little endian words, whatever the host
+  const Kalyna wide(512, 512);
+  uint8_t bytes[65], out[65];
+  uint64_t words[8], expected[8];
+  for (size_t i = 0; i < 64; ++i) {
+    bytes[i + 1] = (uint8_t) (i * 7 + 3);
+  }
+  for (size_t i = 0; i < 8; ++i) {
+    words[i] = 0;
+    for (size_t j = 0; j < 8; ++j) {
+      words[i] |= (uint64_t) bytes[1 + i * 8 + j] << (j * 8);
+    }
+  }
+  wide.Encipher(words, expected, wide.ExpandKey(words));
+  wide.Encipher(bytes + 1, out + 1, wide.ExpandKey(bytes + 1));
+  for (size_t i = 0; i < 64; ++i) {
+    ASSERT_EQ(out[i + 1], (uint8_t) (expected[i / 8] >> (i % 8 * 8))) << i;
+  }
+  ASSERT_THROW(kalyna.Encipher(bytes + 1, out + 1, wide.ExpandKey(bytes + 1)), std::invalid_argument);
+}
+
+TEST(Kalyna, SharedKeyAcrossThreads) {
+  const Kalyna kalyna(128, 256);
+  const uint64_t key[4] =
+      {0x0706050403020100ULL, 0x0f0e0d0c0b0a0908ULL, 0x1716151413121110ULL, 0x1f1e1d1c1b1a1918ULL};
+  const uint64_t plain[2] = {0x2726252423222120ULL, 0x2f2e2d2c2b2a2928ULL};
+  const uint64_t expect[2] = {0x8a150010093eec58ULL, 0x144f336f16f74811ULL};
+  const KalynaKey expanded = kalyna.ExpandKey(key);
+
+  ASSERT_EQ(expanded.BlockSize(), 128u);
+  ASSERT_EQ(expanded.KeySize(), 256u);
+
+  // every thread enciphers and deciphers with the same schedule, no per-thread key expansion
+  std::vector<int> failures(4);
+  std::vector<std::thread> threads;
+  for (size_t t = 0; t < failures.size(); ++t) {
+    threads.emplace_back([&, t] {
+      for (int i = 0; i < 1000; ++i) {
+        uint64_t block[2];
+        kalyna.Encipher(plain, block, expanded);
+        failures[t] += memcmp(block, expect, sizeof(block)) != 0;
+        kalyna.Decipher(block, block, expanded);
+        failures[t] += memcmp(block, plain, sizeof(block)) != 0;
+      }
+    });
+  }
+  for (auto &thread : threads) {
+    thread.join();
+  }
+  for (int failed : failures) {
+    ASSERT_EQ(failed, 0);
+  }
+
+  uint64_t block[2];
+  ASSERT_THROW(Kalyna(128, 128).Encipher(plain, block, expanded), std::invalid_argument);
+}
+
+TEST(KalynaModes, MatchBlockCipher) {
+  const size_t sizes[5][2] = {{128, 128}, {128, 256}, {256, 256}, {256, 512}, {512, 512}};
+  for (const auto &size : sizes) {
+    const Kalyna kalyna(size[0], size[1]);
+    const size_t block = kalyna.BlockBytes();
+    const size_t length = 19 * block;
+    uint64_t key[8];
+    for (size_t i = 0; i < 8; ++i) {
+      key[i] = 0x0706050403020100ULL + i * 0x0808080808080808ULL;
+    }
+    const KalynaKey expanded = kalyna.ExpandKey(key);
+
+    std::vector<uint8_t> plain(length), out(length), back(length);
+    uint8_t iv[Kalyna::kMaxBlockBytes];
+    for (size_t i = 0; i < length; ++i) {
+      plain[i] = (uint8_t) (i * 11 + 5);
+    }
+    for (size_t i = 0; i < block; ++i) {
+      iv[i] = (uint8_t) (0x40 + i);
+    }
+
+    // ECB of bytes is Encipher of little endian words
+    kalyna.EncryptECB(plain.data(), out.data(), length, expanded);
+    uint64_t words[8];
+    memcpy(words, plain.data() + block, block);
+    kalyna.Encipher(words, words, expanded);
+    ASSERT_FALSE(memcmp(words, out.data() + block, block));
+    kalyna.DecryptECB(out.data(), back.data(), length, expanded);
+    ASSERT_EQ(plain, back);
+
+    // CBC first block, in-place decryption
+    kalyna.EncryptCBC(plain.data(), out.data(), length, expanded, iv);
+    for (size_t i = 0; i < block; ++i) {
+      ((uint8_t *) words)[i] = plain[i] ^ iv[i];
+    }
+    kalyna.Encipher(words, words, expanded);
+    ASSERT_FALSE(memcmp(words, out.data(), block));
+    kalyna.DecryptCBC(out.data(), out.data(), length, expanded, iv);
+    ASSERT_EQ(plain, out);
+
+    // CTR gamma of block 0 is E(E(iv) + 1), the counter is a little endian integer
+    kalyna.EncryptCTR(plain.data(), out.data(), length - 3, expanded, iv);
+    memcpy(words, iv, block);
+    kalyna.Encipher(words, words, expanded);
+    words[0] += 1;
+    kalyna.Encipher(words, words, expanded);
+    for (size_t i = 0; i < block; ++i) {
+      ASSERT_EQ(out[i], plain[i] ^ ((uint8_t *) words)[i]);
+    }
+    // any range on its own
+    kalyna.DecryptCTR(out.data() + block + 7, back.data(), length - 3 - block - 7, expanded, iv, block + 7);
+    ASSERT_FALSE(memcmp(back.data(), plain.data() + block + 7, length - 3 - block - 7));
+
+    for (uint32_t s : {(uint32_t) block, 5u}) {
+      kalyna.EncryptCFB(plain.data(), out.data(), length - 1, s, expanded, iv);
+      kalyna.DecryptCFB(out.data(), out.data(), length - 1, s, expanded, iv);
+      ASSERT_FALSE(memcmp(out.data(), plain.data(), length - 1));
+    }
+
+    kalyna.EncryptOFB(plain.data(), out.data(), length - 1, expanded, iv);
+    kalyna.DecryptOFB(out.data(), out.data(), length - 1, expanded, iv);
+    ASSERT_FALSE(memcmp(out.data(), plain.data(), length - 1));
+
+    ASSERT_THROW(kalyna.EncryptECB(plain.data(), out.data(), length - 1, expanded), std::invalid_argument);
+    ASSERT_THROW(kalyna.EncryptCFB(plain.data(), out.data(), length, block + 1, expanded, iv), std::invalid_argument);
+  }
+}
+
+TEST(KalynaModes, StreamMatchesOneShot) {
+  const Kalyna kalyna(256, 512);
+  const size_t block = kalyna.BlockBytes();
+  const size_t length = 23 * block + 9;
+  const size_t chunks[] = {1, 31, 32, 33, 3, 128, 0, 257, 7};
+  uint64_t key[8] = {1, 2, 3, 4, 5, 6, 7, 8};
+  const KalynaKey expanded = kalyna.ExpandKey(key);
+  std::vector<uint8_t> plain(length), expected(length), out(length + block);
+  uint8_t iv[32];
+  for (size_t i = 0; i < length; ++i) {
+    plain[i] = (uint8_t) (i * 13 + 1);
+  }
+  memset(iv, 0x3c, sizeof(iv));
+
+  const KalynaStreamMode modes[] = {KalynaStreamMode::kCFB, KalynaStreamMode::kOFB, KalynaStreamMode::kCTR};
+  for (KalynaStreamMode mode : modes) {
+    if (mode == KalynaStreamMode::kCFB) {
+      kalyna.EncryptCFB(plain.data(), expected.data(), length, 32, expanded, iv);
+    } else if (mode == KalynaStreamMode::kOFB) {
+      kalyna.EncryptOFB(plain.data(), expected.data(), length, expanded, iv);
+    } else {
+      kalyna.EncryptCTR(plain.data(), expected.data(), length, expanded, iv);
+    }
+
+    KalynaStream encryptor(kalyna, expanded, mode, true);
+    KalynaStream decryptor(kalyna, expanded, mode, false);
+    encryptor.Init(iv);
+    decryptor.Init(iv);
+    size_t done = 0;
+    for (size_t i = 0; done < length; i++) {
+      const size_t chunk = chunks[i % 9] < length - done ? chunks[i % 9] : length - done;
+      EXPECT_EQ(chunk, encryptor.Update(plain.data() + done, out.data() + done, chunk));
+      done += chunk;
+    }
+    EXPECT_EQ(0u, encryptor.Final(out.data() + done));
+    EXPECT_FALSE(memcmp(expected.data(), out.data(), length));
+
+    // in place, in the opposite chunk order
+    done = 0;
+    for (size_t i = 0; done < length; i++) {
+      const size_t chunk = chunks[8 - i % 9] < length - done ? chunks[8 - i % 9] : length - done;
+      decryptor.Update(out.data() + done, out.data() + done, chunk);
+      done += chunk;
+    }
+    EXPECT_FALSE(memcmp(plain.data(), out.data(), length));
+  }
+
+  // CBC keeps the tail until Final
+  std::vector<uint8_t> padded(plain);
+  padded.resize(24 * block, 0);
+  kalyna.EncryptCBC(padded.data(), expected.data(), 24 * block - block, expanded, iv);
+  KalynaStream cbc(kalyna, expanded, KalynaStreamMode::kCBC, true);
+  cbc.Init(iv);
+  size_t written = 0;
+  for (size_t in = 0, chunk = 1; in < length; chunk += 10) {
+    const size_t n = chunk < length - in ? chunk : length - in;
+    written += cbc.Update(plain.data() + in, out.data() + written, n);
+    in += n;
+  }
+  EXPECT_EQ(23 * block, written);
+  EXPECT_FALSE(memcmp(expected.data(), out.data(), written));
+  EXPECT_EQ(block, cbc.Final(out.data() + written));
+}
+
+TEST(KalynaGcm, BackendsAndStreaming) {
+  const size_t sizes[5][2] = {{128, 128}, {128, 256}, {256, 256}, {256, 512}, {512, 512}};
+  const size_t chunks[] = {1, 15, 64, 17, 3, 200, 0, 129, 7};
+  for (const auto &size : sizes) {
+    const Kalyna kalyna(size[0], size[1]);
+    uint64_t key[8] = {11, 12, 13, 14, 15, 16, 17, 18};
+    const KalynaKey expanded = kalyna.ExpandKey(key);
+    const size_t length = 13 * kalyna.BlockBytes() + 5, aad_length = 2 * kalyna.BlockBytes() + 3;
+    std::vector<uint8_t> plain(length), aad(aad_length), out(length), streamed(length);
+    for (size_t i = 0; i < length; ++i) {
+      plain[i] = (uint8_t) (i * 5 + 2);
+    }
+    for (size_t i = 0; i < aad_length; ++i) {
+      aad[i] = (uint8_t) (i ^ 0x5a);
+    }
+    const uint8_t iv[12] = {1, 2, 3, 4, 5, 6, 7, 8, 9, 10, 11, 12};
+    uint8_t tag[Kalyna::kMaxBlockBytes], streamed_tag[Kalyna::kMaxBlockBytes];
+
+    KalynaGcm table(kalyna, expanded, true, KalynaGmacBackend::kTable);
+    table.Init(iv, sizeof(iv));
+    table.UpdateAad(aad.data(), aad_length);
+    table.Update(plain.data(), out.data(), length);
+    table.Final(tag);
+
+    // any chunking of AAD and data, with the fastest backend
+    KalynaGcm encryptor(kalyna, expanded, true);
+    encryptor.Init(iv, sizeof(iv));
+    size_t done = 0;
+    for (size_t i = 0; done < aad_length; i++) {
+      const size_t chunk = chunks[i % 9] < aad_length - done ? chunks[i % 9] : aad_length - done;
+      encryptor.UpdateAad(aad.data() + done, chunk);
+      done += chunk;
+    }
+    done = 0;
+    for (size_t i = 0; done < length; i++) {
+      const size_t chunk = chunks[i % 9] < length - done ? chunks[i % 9] : length - done;
+      encryptor.Update(plain.data() + done, streamed.data() + done, chunk);
+      done += chunk;
+    }
+    encryptor.Final(streamed_tag);
+    ASSERT_EQ(out, streamed);
+    ASSERT_FALSE(memcmp(tag, streamed_tag, kalyna.BlockBytes()));
+
+    // the data is the gamming mode of the counter after the IV
+    uint8_t counter_block[Kalyna::kMaxBlockBytes] = {};
+    memcpy(counter_block + kalyna.BlockBytes() - sizeof(iv), iv, sizeof(iv));
+    kalyna.EncryptCTR(plain.data(), streamed.data(), length, expanded, counter_block);
+    ASSERT_EQ(out, streamed);
+
+    KalynaGcm decryptor(kalyna, expanded, false);
+    decryptor.Init(iv, sizeof(iv));
+    decryptor.UpdateAad(aad.data(), aad_length);
+    decryptor.Update(out.data(), out.data(), length);
+    ASSERT_TRUE(decryptor.Verify(tag));
+    ASSERT_EQ(plain, out);
+
+    decryptor.Init(iv, sizeof(iv));
+    decryptor.UpdateAad(aad.data(), aad_length);
+    decryptor.Update(streamed.data(), out.data(), length);
+    tag[3] ^= 1;
+    ASSERT_FALSE(decryptor.Verify(tag));
+  }
+}
+
+TEST(KalynaGcm, Gmac) {
+  const Kalyna kalyna(512, 512);
+  uint64_t key[8] = {0x0706050403020100ULL, 0x0f0e0d0c0b0a0908ULL};
+  const KalynaKey expanded = kalyna.ExpandKey(key);
+  std::vector<uint8_t> message(1000, 0x33);
+  const uint8_t iv[64] = {};
+  uint8_t mac[64], other[64];
+
+  KalynaGcm gmac(kalyna, expanded, true);
+  gmac.Init(iv, sizeof(iv));
+  gmac.UpdateAad(message.data(), message.size());
+  gmac.Final(mac, 32);
+
+  message[999] ^= 0x80;
+  gmac.Init(iv, sizeof(iv));
+  gmac.UpdateAad(message.data(), message.size());
+  gmac.Final(other, 32);
+  ASSERT_TRUE(memcmp(mac, other, 32));
+
+  ASSERT_THROW(gmac.Final(other, 4), std::logic_error);
+  gmac.Init(iv, sizeof(iv));
+  ASSERT_THROW(gmac.Final(other, 4), std::invalid_argument);
+}
+
+// x * y in GF(2^{8 n}) with the DSTU 7624 polynomials, one bit at a time. Elements are
+// little endian byte strings, bit i of byte j is the coefficient of x^{8 j + i}.
+std::vector<uint8_t> MultiplyGF(const std::vector<uint8_t> &x, std::vector<uint8_t> y) {
+  const size_t n = x.size();
+  const unsigned low = n == 16 ? 0x87u : n == 32 ? 0x425u : 0x125u;
+  std::vector<uint8_t> product(n);
+  for (size_t bit = 0; bit < 8 * n; ++bit) {
+    if ((x[bit / 8] >> (bit % 8)) & 1u) {
+      for (size_t i = 0; i < n; ++i) {
+        product[i] ^= y[i];
+      }
+    }
+    const bool carry = y[n - 1] >> 7u;
+    for (size_t i = n - 1; i > 0; --i) {
+      y[i] = (uint8_t) (y[i] << 1u | y[i - 1] >> 7u);
+    }
+    y[0] = (uint8_t) (y[0] << 1u);
+    if (carry) {
+      y[0] ^= (uint8_t) low;
+      y[1] ^= (uint8_t) (low >> 8u);
+    }
+  }
+  return product;
+}
+
+// Tag of the GCM construction written out block by block: H = E(0), every zero padded
+// block of AAD, ciphertext and the lengths block is XORed in and multiplied by H, then E.
+std::vector<uint8_t> ReferenceGcmTag(const Kalyna &kalyna, const KalynaKey &key, const std::vector<uint8_t> &aad,
+                                     const std::vector<uint8_t> &ciphertext) {
+  const size_t n = kalyna.BlockBytes();
+  std::vector<uint8_t> h(n), x(n);
+  kalyna.EncryptECB(x.data(), h.data(), n, key);
+  const auto absorb = [&](const std::vector<uint8_t> &data) {
+    for (size_t offset = 0; offset < data.size(); offset += n) {
+      for (size_t i = 0; i < n && offset + i < data.size(); ++i) {
+        x[i] ^= data[offset + i];
+      }
+      x = MultiplyGF(x, h);
+    }
+  };
+  absorb(aad);
+  absorb(ciphertext);
+  std::vector<uint8_t> lengths(n);
+  for (size_t i = 0; i < 8; ++i) {
+    lengths[i] = (uint8_t) ((uint64_t) aad.size() * 8 >> (8 * i));
+    lengths[n / 2 + i] = (uint8_t) ((uint64_t) ciphertext.size() * 8 >> (8 * i));
+  }
+  absorb(lengths);
+  kalyna.EncryptECB(x.data(), x.data(), n, key);
+  return x;
+}
+
+TEST(KalynaGcm, ReferenceConstruction) {
+  const size_t sizes[5][2] = {{128, 128}, {128, 256}, {256, 256}, {256, 512}, {512, 512}};
+  for (const auto &size : sizes) {
+    const Kalyna kalyna(size[0], size[1]);
+    const size_t block = kalyna.BlockBytes();
+    uint8_t key[64], iv[64];
+    for (size_t i = 0; i < sizeof(key); ++i) {
+      key[i] = (uint8_t) i;
+      iv[i] = (uint8_t) (0x40 + i);
+    }
+    const KalynaKey expanded = kalyna.ExpandKey(key);
+
+    // GMAC (no data), whole blocks and partial blocks
+    const std::pair<size_t, size_t> lengths[] = {{block + 5, 0}, {block, block}, {0, 2 * block + 3}, {3, 7}};
+    for (const auto &length : lengths) {
+      std::vector<uint8_t> aad(length.first), plain(length.second), out(length.second);
+      for (size_t i = 0; i < aad.size(); ++i) {
+        aad[i] = (uint8_t) (i * 7 + 1);
+      }
+      for (size_t i = 0; i < plain.size(); ++i) {
+        plain[i] = (uint8_t) (i * 13 + 5);
+      }
+
+      for (KalynaGmacBackend backend : {KalynaGmacBackend::kTable, KalynaGmacBackend::kAuto}) {
+        KalynaGcm gcm(kalyna, expanded, true, backend);
+        gcm.Init(iv, block);
+        gcm.UpdateAad(aad.data(), aad.size());
+        gcm.Update(plain.data(), out.data(), plain.size());
+        uint8_t tag[Kalyna::kMaxBlockBytes];
+        gcm.Final(tag);
+
+        const std::vector<uint8_t> expected = ReferenceGcmTag(kalyna, expanded, aad, out);
+        ASSERT_FALSE(memcmp(expected.data(), tag, block))
+            << size[0] << "/" << size[1] << " aad " << aad.size() << " data " << plain.size();
+
+        gcm.Init(iv, block);
+        gcm.UpdateAad(aad.data(), aad.size());
+        gcm.Update(plain.data(), out.data(), plain.size());
+        gcm.Final(tag, 8);
+        ASSERT_FALSE(memcmp(expected.data(), tag, 8));
+      }
+    }
+  }
+}
+
+template<size_t BlockBits, size_t KeyBits>
+void ExpectBatchWidthsAgree() {
+  KalynaCipher<BlockBits, KeyBits> cipher;
+  uint64_t key[KeyBits / 64];
+  for (size_t i = 0; i < KeyBits / 64; ++i) {
+    key[i] = 0x0123456789abcdefULL * (i + 1);
+  }
+  cipher.KeyExpand(key);
+
+  // 11 blocks leave a tail after every batch width
+  const size_t blocks = 11, length = blocks * BlockBits / 8;
+  std::vector<uint8_t> plain(length), expected(length), out(length);
+  for (size_t i = 0; i < length; ++i) {
+    plain[i] = (uint8_t) (i * 29 + 7);
+  }
+  cipher.EncipherBlocks(plain.data(), expected.data(), blocks, 1);
+  for (size_t width : {2, 4, 8}) {
+    cipher.EncipherBlocks(plain.data(), out.data(), blocks, width);
+    EXPECT_EQ(expected, out) << BlockBits << "/" << KeyBits << " width " << width;
+    cipher.DecipherBlocks(out.data(), out.data(), blocks, width);
+    EXPECT_EQ(plain, out) << BlockBits << "/" << KeyBits << " width " << width;
+  }
+}
+
+TEST(Kalyna, BatchWidthsAgree) {
+  ExpectBatchWidthsAgree<128, 128>();
+  ExpectBatchWidthsAgree<128, 256>();
+  ExpectBatchWidthsAgree<256, 256>();
+  ExpectBatchWidthsAgree<256, 512>();
+  ExpectBatchWidthsAgree<512, 512>();
+}
+
+TEST(Kalyna, ExpandKeysMatchesExpandKey) {
+  const size_t sizes[5][2] = {{128, 128}, {128, 256}, {256, 256}, {256, 512}, {512, 512}};
+  const uint64_t zero[8] = {};
+  for (const auto &size : sizes) {
+    const Kalyna kalyna(size[0], size[1]);
+    const size_t nk = size[1] / 64;
+
+    // 7 keys leave a tail after a batch, the output starts out with keys of another size
+    const size_t count = 7;
+    std::vector<uint64_t> keys(count * nk);
+    for (size_t i = 0; i < keys.size(); ++i) {
+      keys[i] = 0x9e3779b97f4a7c15ULL * (i + 1);
+    }
+    const KalynaKey other = Kalyna(size[0] == 512 ? 128 : 512, size[0] == 512 ? 128 : 512).ExpandKey(zero);
+    std::vector<KalynaKey> expanded(count, other);
+    kalyna.ExpandKeys(keys.data(), count, expanded.data());
+
+    for (size_t k = 0; k < count; ++k) {
+      const KalynaKey single = kalyna.ExpandKey(keys.data() + k * nk);
+      ASSERT_EQ(expanded[k].BlockSize(), size[0]);
+      ASSERT_EQ(expanded[k].KeySize(), size[1]);
+
+      uint64_t plain[8], batched[8], expected[8];
+      for (size_t i = 0; i < 8; ++i) {
+        plain[i] = 0x0706050403020100ULL + i * k;
+      }
+      kalyna.Encipher(plain, expected, single);
+      kalyna.Encipher(plain, batched, expanded[k]);
+      ASSERT_FALSE(memcmp(expected, batched, kalyna.BlockBytes())) << size[0] << "/" << size[1] << " key " << k;
+      kalyna.Decipher(expected, batched, expanded[k]);
+      ASSERT_FALSE(memcmp(plain, batched, kalyna.BlockBytes()));
+    }
+  }
+}
+
+// SSSE3 and AVX2 are slower than the tables and only run when asked for
+TEST(Kalyna, AutoNeverPicksSlowSlicedBackends) {
+  bool avx512 = true;
+  try {
+    Kalyna probe(128, 128, KalynaBackend::kAvx512);
+  } catch (const std::invalid_argument &) {
+    avx512 = false;
+  }
+
+  const size_t sizes[5][2] = {{128, 128}, {128, 256}, {256, 256}, {256, 512}, {512, 512}};
+  for (const auto &size : sizes) {
+    const KalynaBackend backend = Kalyna(size[0], size[1], KalynaBackend::kAuto).Backend();
+    ASSERT_EQ(backend, avx512 ? KalynaBackend::kAvx512 : KalynaBackend::kTable) << size[0] << "/" << size[1];
+  }
+}
+
+TEST(Kalyna, SlicedBackendsMatchTables) {
+  ASSERT_NE(Kalyna(128, 128, KalynaBackend::kAuto).Backend(), KalynaBackend::kAuto);
+  // the CPU is detected unless a backend is asked for
+  ASSERT_EQ(Kalyna(128, 128).Backend(), Kalyna(128, 128, KalynaBackend::kAuto).Backend());
+
+  const size_t sizes[5][2] = {{128, 128}, {128, 256}, {256, 256}, {256, 512}, {512, 512}};
+  size_t tested = 0;
+  for (KalynaBackend backend : {KalynaBackend::kSsse3, KalynaBackend::kAvx2, KalynaBackend::kAvx512}) {
+    try {
+      Kalyna probe(128, 128, backend);
+    } catch (const std::invalid_argument &) {
+      continue;
+    }
+    ++tested;
+
+    for (const auto &size : sizes) {
+      const Kalyna table(size[0], size[1], KalynaBackend::kTable);
+      const Kalyna sliced(size[0], size[1], backend);
+
+      // 75 blocks: whole batches of every width, then a padded tail
+      const size_t block = table.BlockBytes();
+      const size_t length = 75 * block;
+      uint64_t key[8];
+      for (size_t i = 0; i < 8; ++i) {
+        key[i] = 0x1f1e1d1c1b1a1918ULL * (i + 3);
+      }
+      const KalynaKey expanded = table.ExpandKey(key);
+
+      std::vector<uint8_t> plain(length), expected(length), out(length);
+      uint8_t iv[Kalyna::kMaxBlockBytes];
+      for (size_t i = 0; i < length; ++i) {
+        plain[i] = (uint8_t) (i * 13 + 1);
+      }
+      for (size_t i = 0; i < block; ++i) {
+        iv[i] = (uint8_t) (0x80 + 3 * i);
+      }
+
+      table.EncryptECB(plain.data(), expected.data(), length, expanded);
+      sliced.EncryptECB(plain.data(), out.data(), length, expanded);
+      ASSERT_EQ(expected, out) << size[0] << "/" << size[1] << " backend " << (int) backend;
+      sliced.DecryptECB(out.data(), out.data(), length, expanded);
+      ASSERT_EQ(plain, out);
+
+      table.EncryptCBC(plain.data(), expected.data(), length, expanded, iv);
+      sliced.EncryptCBC(plain.data(), out.data(), length, expanded, iv);
+      ASSERT_EQ(expected, out);
+      sliced.DecryptCBC(out.data(), out.data(), length, expanded, iv);
+      ASSERT_EQ(plain, out);
+
+      table.EncryptCTR(plain.data(), expected.data(), length - 3, expanded, iv, 5);
+      sliced.EncryptCTR(plain.data(), out.data(), length - 3, expanded, iv, 5);
+      ASSERT_FALSE(memcmp(expected.data(), out.data(), length - 3));
+
+      table.EncryptCFB(plain.data(), expected.data(), length - 1, 7, expanded, iv);
+      sliced.DecryptCFB(expected.data(), out.data(), length - 1, 7, expanded, iv);
+      ASSERT_FALSE(memcmp(plain.data(), out.data(), length - 1));
+
+      uint8_t table_tag[Kalyna::kMaxBlockBytes], sliced_tag[Kalyna::kMaxBlockBytes];
+      KalynaGcm table_gcm(table, expanded, true);
+      table_gcm.Init(iv, block);
+      table_gcm.Update(plain.data(), expected.data(), length - 9);
+      table_gcm.Final(table_tag);
+      KalynaGcm sliced_gcm(sliced, expanded, true);
+      sliced_gcm.Init(iv, block);
+      sliced_gcm.Update(plain.data(), out.data(), length - 9);
+      sliced_gcm.Final(sliced_tag);
+      ASSERT_FALSE(memcmp(expected.data(), out.data(), length - 9));
+      ASSERT_FALSE(memcmp(table_tag, sliced_tag, block));
+    }
+  }
+  if (tested == 0) {
+    GTEST_SKIP() << "SSSE3 is not available";
+  }
+}
@@ -0,0 +1,53 @@
+#include <vector>
+
+#include "aes.h"
+#include "kalyna.h"
+#include "perf_counters.h"
+#include "gtest/gtest.h"
+
+TEST(PerfCounters, SnapshotAndReset) {
+  const uint8_t key[32] = {0x00, 0x01, 0x02, 0x03, 0x04, 0x05, 0x06, 0x07, 0x08, 0x09, 0x0a, 0x0b, 0x0c, 0x0d, 0x0e,
+                           0x0f};
+  const uint8_t iv[16] = {0xf0, 0xf1, 0xf2, 0xf3};
+  std::vector<uint8_t> data(100);
+
+  PerfReset();
+  AES aes(128);
+  const AesKey aesKey = aes.ExpandKey(key);
+  aes.EncryptCTR(data.data(), data.data(), data.size(), aesKey, iv);
+  aes.DecryptCTR(data.data(), data.data(), data.size(), aesKey, iv);
+  aes.EncryptCTR(data.data(), data.data(), 20, aesKey, iv);
+  const Kalyna kalyna(128, 128, KalynaBackend::kTable);
+  const KalynaKey kalynaKey = kalyna.ExpandKey(key);
+  kalyna.DecryptECB(data.data(), data.data(), 96, kalynaKey);
+  const PerfCounters counters = PerfSnapshot();
+
+  if (!PerfCountersEnabled()) {
+    ASSERT_EQ(counters.keyExpansions[(size_t) PerfCipher::kAes], 0u);
+    ASSERT_EQ(counters.Mode(PerfCipher::kAes, (size_t) aes.Backend(), PerfMode::kCTR, true).calls, 0u);
+    return;
+  }
+
+  const PerfModeCounters &ctr = counters.Mode(PerfCipher::kAes, (size_t) aes.Backend(), PerfMode::kCTR, true);
+  ASSERT_EQ(ctr.calls, 2u);
+  ASSERT_EQ(ctr.bytes, 120u);
+  ASSERT_EQ(ctr.blocks, 7u + 2u);
+  // decryption is counted on its own even though it runs the same keystream
+  ASSERT_EQ(counters.Mode(PerfCipher::kAes, (size_t) aes.Backend(), PerfMode::kCTR, false).bytes, 100u);
+  ASSERT_EQ(counters.keyExpansions[(size_t) PerfCipher::kAes], 1u);
+
+  const PerfModeCounters &ecb =
+      counters.Mode(PerfCipher::kKalyna, (size_t) KalynaBackend::kTable, PerfMode::kECB, false);
+  ASSERT_EQ(ecb.calls, 1u);
+  ASSERT_EQ(ecb.blocks, 6u);
+  ASSERT_EQ(counters.keyExpansions[(size_t) PerfCipher::kKalyna], 1u);
+
+  uint32_t outLen;
+  delete[] aes.EncryptECB(data.data(), 20, aesKey, outLen);
+  ASSERT_EQ(PerfSnapshot().allocations, 1u);
+  ASSERT_EQ(PerfSnapshot().allocatedBytes, 32u);
+
+  PerfReset();
+  ASSERT_EQ(PerfSnapshot().Mode(PerfCipher::kAes, (size_t) aes.Backend(), PerfMode::kCTR, true).calls, 0u);
+  ASSERT_EQ(PerfSnapshot().allocations, 0u);
+}